@@ -0,0 +1,91 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <math.h>
+
+#include "analyzer_policy.h"
+
+// equivalent noise bandwidth of the hamming window (window type 4) in bins
+#define WINDOW_ENBW 1.36
+
+static int next_pow2(double n) {
+  int p=1;
+  while(p<n && p<ANALYZER_MAX_FFT) p<<=1;
+  return p;
+}
+
+//
+// Choose the analyzer FFT size, overlap and averaging for a display.
+//
+// The FFT is sized to give at least 'bins_per_pixel' bins for every pixel of
+// the full span (span_pixels includes the zoom factor) and, if target_rbw is
+// non zero, to reach that resolution bandwidth as long as it does not need
+// more than ANALYZER_MAX_BINS_PER_PIXEL. Overlap is only used when one FFT
+// would span more than a display frame, so low sample rates still produce a
+// fresh spectrum every frame and high rates do no redundant transforms.
+//
+// Averaging in the analyzer runs once per FFT, so the back multiplier and
+// frame count are derived from the FFT rate rather than the display rate.
+//
+void analyzer_plan(ANALYZER_PLAN *p,int sample_rate,int fps,int span_pixels,double bins_per_pixel,double target_rbw,double average_time,int min_fft,int max_fft) {
+  int n;
+  double samples_per_frame;
+
+  if(fps<1) fps=1;
+  if(min_fft<1) min_fft=ANALYZER_MIN_FFT;
+  if(max_fft>ANALYZER_MAX_FFT || max_fft<min_fft) max_fft=ANALYZER_MAX_FFT;
+
+  n=next_pow2((double)span_pixels*bins_per_pixel);
+  if(target_rbw>0.0) {
+    int rbw_n=next_pow2(WINDOW_ENBW*(double)sample_rate/target_rbw);
+    int cap=next_pow2((double)span_pixels*ANALYZER_MAX_BINS_PER_PIXEL);
+    if(rbw_n>cap) rbw_n=cap;
+    if(rbw_n>n) n=rbw_n;
+  }
+  if(n<min_fft) n=min_fft;
+  if(n>max_fft) n=max_fft;
+  p->fft_size=n;
+
+  samples_per_frame=(double)sample_rate/(double)fps;
+  if(samples_per_frame<1.0) samples_per_frame=1.0;
+  if((double)n>samples_per_frame) {
+    p->overlap=n-(int)floor(samples_per_frame);
+  } else {
+    p->overlap=0;
+  }
+
+  p->ffts_per_second=(double)sample_rate/(double)(n-p->overlap);
+  p->rbw=WINDOW_ENBW*(double)sample_rate/(double)n;
+  // complex FFT of size n is about 5 n log2(n) flops
+  p->cost=p->ffts_per_second*5.0*(double)n*log2((double)n)/1.0e6;
+
+  analyzer_plan_averaging(p,average_time);
+}
+
+void analyzer_plan_averaging(ANALYZER_PLAN *p,double average_time) {
+  double t=0.001*average_time;
+  if(t>0.0 && p->ffts_per_second>0.0) {
+    p->av_backmult=exp(-1.0/(p->ffts_per_second*t));
+    p->num_average=(int)fmin(60.0,p->ffts_per_second*t);
+    if(p->num_average<2) p->num_average=2;
+  } else {
+    p->av_backmult=0.0;
+    p->num_average=2;
+  }
+}
@@ -0,0 +1,40 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _ANALYZER_POLICY_H
+#define _ANALYZER_POLICY_H
+
+#define ANALYZER_MIN_FFT 1024
+#define ANALYZER_MAX_FFT 262144     // size passed to XCreateAnalyzer
+#define ANALYZER_MAX_BINS_PER_PIXEL 8.0
+
+typedef struct _analyzer_plan {
+  int fft_size;
+  int overlap;
+  double rbw;               // resolution bandwidth (Hz)
+  double ffts_per_second;
+  double av_backmult;
+  int num_average;
+  double cost;              // estimated FFT work (MFLOP/s)
+} ANALYZER_PLAN;
+
+extern void analyzer_plan(ANALYZER_PLAN *p,int sample_rate,int fps,int span_pixels,double bins_per_pixel,double target_rbw,double average_time,int min_fft,int max_fft);
+extern void analyzer_plan_averaging(ANALYZER_PLAN *p,double average_time);
+
+#endif
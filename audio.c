@@ -31,6 +31,7 @@
 #include <semaphore.h>
 
 #include <soundio/soundio.h>
+#include <wdsp.h>
 #ifndef __APPLE__
 #include <pulse/pulseaudio.h>
 #include <pulse/glib-mainloop.h>
@@ -94,6 +95,12 @@ static pa_context *pa_ctx;
 static int ready=0;
 static int sample_rate=48000;
 
+// audio_write() feeds the rate matcher in blocks of AUDIO_RMATCH_INSIZE frames on the
+// radio clock, the sound card side drains it in blocks of AUDIO_RMATCH_OUTSIZE frames
+#define AUDIO_RMATCH_INSIZE 256
+#define AUDIO_RMATCH_OUTSIZE 256
+#define AUDIO_MIN_LATENCY 20
+
 
 static int underflow_count=0;
 
@@ -102,6 +109,46 @@ static void underflow_callback(struct SoundIoOutStream *outstream) {
   //g_print("audio_write: underflow %d\n", underflow_count);
 }
 
+// local_audio_latency is the whole budget in ms, half of it is asked of the
+// sound card or server buffer and the rest is held in the rate matcher
+static int audio_device_budget(RECEIVER *rx) {
+  int latency=rx->local_audio_latency;
+  if(latency<AUDIO_MIN_LATENCY) latency=AUDIO_MIN_LATENCY;
+  return latency/2;
+}
+
+static int audio_ring_budget(RECEIVER *rx) {
+  int latency=rx->local_audio_latency;
+  if(latency<AUDIO_MIN_LATENCY) latency=AUDIO_MIN_LATENCY;
+  return latency-audio_device_budget(rx);
+}
+
+static void audio_create_rmatch(RECEIVER *rx) {
+  // the rate matcher holds half its ring, so this is its share of the latency
+  int latency=audio_ring_budget(rx);
+  int ringsize=2*sample_rate*latency/1000;
+  rx->audio_rmatch=create_rmatchV(AUDIO_RMATCH_INSIZE,AUDIO_RMATCH_OUTSIZE,48000,sample_rate,ringsize,1.0);
+  rx->audio_rmatch_in=g_new0(gdouble,2*AUDIO_RMATCH_INSIZE);
+  rx->audio_rmatch_in_offset=0;
+  rx->audio_rmatch_out=g_new0(gdouble,2*AUDIO_RMATCH_OUTSIZE);
+  rx->audio_rmatch_out_offset=AUDIO_RMATCH_OUTSIZE;
+}
+
+static void audio_destroy_rmatch(RECEIVER *rx) {
+  if(rx->audio_rmatch!=NULL) {
+    destroy_rmatchV(rx->audio_rmatch);
+    rx->audio_rmatch=NULL;
+  }
+  if(rx->audio_rmatch_in!=NULL) {
+    g_free(rx->audio_rmatch_in);
+    rx->audio_rmatch_in=NULL;
+  }
+  if(rx->audio_rmatch_out!=NULL) {
+    g_free(rx->audio_rmatch_out);
+    rx->audio_rmatch_out=NULL;
+  }
+}
+
 static void write_callback(struct SoundIoOutStream *outstream, int frame_count_min, int frame_count_max) {
   RECEIVER *rx=(RECEIVER *)outstream->userdata;
   struct SoundIoChannelArea *areas;
@@ -109,69 +156,116 @@ static void write_callback(struct SoundIoOutStream *outstream, int frame_count_m
   int frame_count;
   int err;
 
-  char *read_ptr = soundio_ring_buffer_read_ptr(rx->ring_buffer);
-  int fill_bytes = soundio_ring_buffer_fill_count(rx->ring_buffer);
-  int fill_count = fill_bytes / outstream->bytes_per_frame;
-
-  if (frame_count_min > fill_count) {
-    //g_print("write_callback: not enough data: frame_count_min=%d fill_count=%d bytes_per_frame=%d\n",frame_count_min,fill_count,outstream->bytes_per_frame);
-    // Ring buffer does not have enough data, fill with zeroes.
-    frames_left = frame_count_min;
-    for (;;) {
-      frame_count = frames_left;
-      if (frame_count <= 0)
-        return;
-      if ((err = soundio_outstream_begin_write(outstream, &areas, &frame_count))) {
-        //g_print("write_callback: begin write error: %s\n", soundio_strerror(err));
-        return;
+  frames_left=frame_count_min;
+  if(frames_left<AUDIO_RMATCH_OUTSIZE) frames_left=AUDIO_RMATCH_OUTSIZE;
+  if(frames_left>frame_count_max) frames_left=frame_count_max;
+
+  while(frames_left>0) {
+    frame_count=frames_left;
+    if((err=soundio_outstream_begin_write(outstream, &areas, &frame_count))) {
+      //g_print("write_callback: begin write error: %s\n", soundio_strerror(err));
+      return;
+    }
+    if(frame_count<=0)
+      break;
+
+    for(int frame=0;frame<frame_count;frame++) {
+      if(rx->audio_rmatch_out_offset>=AUDIO_RMATCH_OUTSIZE) {
+        xrmatchOUT(rx->audio_rmatch,rx->audio_rmatch_out);
+        rx->audio_rmatch_out_offset=0;
       }
-      if (frame_count <= 0)
-        return;
-      for (int frame = 0; frame < frame_count; frame += 1) {
-        for (int ch = 0; ch < outstream->layout.channel_count; ch += 1) {
+      float samples[2];
+      samples[0]=(float)rx->audio_rmatch_out[rx->audio_rmatch_out_offset*2];
+      samples[1]=(float)rx->audio_rmatch_out[(rx->audio_rmatch_out_offset*2)+1];
+      rx->audio_rmatch_out_offset++;
+      for(int ch=0;ch<outstream->layout.channel_count;ch++) {
+        if(ch<2) {
+          memcpy(areas[ch].ptr, &samples[ch], outstream->bytes_per_sample);
+        } else {
           memset(areas[ch].ptr, 0, outstream->bytes_per_sample);
-          areas[ch].ptr += areas[ch].step;
         }
-      }
-      if ((err = soundio_outstream_end_write(outstream)))
-        //g_print("write_callback: end write error: %s\n", soundio_strerror(err));
-        frames_left -= frame_count;
+        areas[ch].ptr += areas[ch].step;
       }
     }
 
-    int read_count;
-    if(frame_count_max<fill_count) read_count=frame_count_max; else read_count=fill_count;
-    frames_left = read_count;
-
-    while (frames_left > 0) {
-      int frame_count = frames_left;
-
-      if ((err = soundio_outstream_begin_write(outstream, &areas, &frame_count))) {
-        g_print("begin write error: %s", soundio_strerror(err));
-        return;
-      }
+    if((err=soundio_outstream_end_write(outstream))) {
+      //g_print("write_callback: end write error: %s\n", soundio_strerror(err));
+      return;
+    }
+    frames_left-=frame_count;
+  }
+}
 
-      if (frame_count <= 0)
+#ifndef __APPLE__
+static gpointer audio_output_thread(gpointer arg) {
+  RECEIVER *rx=(RECEIVER *)arg;
+  int i;
+  int rc;
+  int err;
+  float *float_buffer;
+  gint32 *long_buffer;
+  gint16 *short_buffer;
+
+  g_print("audio_output_thread: rx=%d ENTRY\n",rx->channel);
+  while(g_atomic_int_get(&rx->audio_output_running)) {
+    // blocks at the sound card rate in the write below
+    xrmatchOUT(rx->audio_rmatch,rx->audio_rmatch_out);
+    switch(radio->which_audio) {
+      case USE_PULSEAUDIO:
+        float_buffer=(float *)rx->local_audio_buffer;
+        for(i=0;i<AUDIO_RMATCH_OUTSIZE*2;i++) {
+          float_buffer[i]=(float)rx->audio_rmatch_out[i];
+        }
+        rc=pa_simple_write(rx->playstream,
+                           rx->local_audio_buffer,
+                           AUDIO_RMATCH_OUTSIZE*sizeof(float)*2,
+                           &err);
+        if(rc!=0) {
+          fprintf(stderr,"audio_output_thread: pa_simple_write failed err=%d\n",err);
+          g_atomic_int_set(&rx->audio_output_running,FALSE);
+        }
         break;
-
-      for (int frame = 0; frame < frame_count; frame += 1) {
-        for (int ch = 0; ch < outstream->layout.channel_count; ch += 1) {
-          memcpy(areas[ch].ptr, read_ptr, outstream->bytes_per_sample);
-          areas[ch].ptr += areas[ch].step;
-          read_ptr += outstream->bytes_per_sample;
+      case USE_ALSA:
+        switch(rx->local_audio_format) {
+          case SND_PCM_FORMAT_S16_LE:
+            short_buffer=(gint16 *)rx->local_audio_buffer;
+            for(i=0;i<AUDIO_RMATCH_OUTSIZE*2;i++) {
+              short_buffer[i]=(gint16)(rx->audio_rmatch_out[i]*32767.0);
+            }
+            break;
+          case SND_PCM_FORMAT_S32_LE:
+            long_buffer=(gint32 *)rx->local_audio_buffer;
+            for(i=0;i<AUDIO_RMATCH_OUTSIZE*2;i++) {
+              long_buffer[i]=(gint32)(rx->audio_rmatch_out[i]*2147483647.0);
+            }
+            break;
+          case SND_PCM_FORMAT_FLOAT_LE:
+            float_buffer=(float *)rx->local_audio_buffer;
+            for(i=0;i<AUDIO_RMATCH_OUTSIZE*2;i++) {
+              float_buffer[i]=(float)rx->audio_rmatch_out[i];
+            }
+            break;
+          default:
+            break;
         }
-      }
-
-      if ((err = soundio_outstream_end_write(outstream))) {
-        //g_print("end write error: %s\n", soundio_strerror(err));
-        return;
-      }
-
-      frames_left -= frame_count;
+        if((rc=snd_pcm_writei(rx->playback_handle,rx->local_audio_buffer,AUDIO_RMATCH_OUTSIZE))<0) {
+          if(rc==-EPIPE) {
+            if((rc=snd_pcm_prepare(rx->playback_handle))<0) {
+              g_print("audio_output_thread: cannot prepare audio interface for use %d (%s)\n", rc, snd_strerror (rc));
+              g_atomic_int_set(&rx->audio_output_running,FALSE);
+            }
+          } else {
+            g_print("audio_output_thread: snd_pcm_writei failed %d (%s)\n", rc, snd_strerror (rc));
+            g_atomic_int_set(&rx->audio_output_running,FALSE);
+          }
+        }
+        break;
+    }
   }
-
-  soundio_ring_buffer_advance_read_ptr(rx->ring_buffer, read_count * outstream->bytes_per_frame);
+  g_print("audio_output_thread: rx=%d EXIT\n",rx->channel);
+  return NULL;
 }
+#endif
 
 static void read_callback(struct SoundIoInStream *instream, int frame_count_min, int frame_count_max) {
     RADIO *r=(RADIO *)instream->userdata;
@@ -274,15 +368,7 @@ g_print("audio_open_output: SOUNDIO: %s\n",rx->audio_name);
         return -1;
       }
 
-      // guess that 8 output buffers should be enough
-      int size=8*rx->output_samples*sizeof(float)*2;
-      if(size<32768) size=32768;
-      rx->ring_buffer = soundio_ring_buffer_create(soundio, size);
-      if(!rx->ring_buffer) {
-        g_print("audio_open_output: soundio_ring_buffer_create failed");
-        g_mutex_unlock(&rx->local_audio_mutex);
-        return -1;
-      }
+      audio_create_rmatch(rx);
 
       rx->output_stream = soundio_outstream_create(rx->output_device);
       if(!rx->output_stream) {
@@ -294,7 +380,7 @@ g_print("audio_open_output: SOUNDIO: %s\n",rx->audio_name);
       rx->output_stream->sample_rate = sample_rate;
       rx->output_stream->write_callback = write_callback;
       rx->output_stream->underflow_callback = underflow_callback;
-      rx->output_stream->software_latency = 0.01;
+      rx->output_stream->software_latency = (double)audio_device_budget(rx)/1000.0;
       rx->output_stream->userdata=(void *)rx;
 
       if((err = soundio_outstream_open(rx->output_stream))) {
@@ -302,6 +388,8 @@ g_print("audio_open_output: SOUNDIO: %s\n",rx->audio_name);
         g_mutex_unlock(&rx->local_audio_mutex);
         return -1;
       }
+      // open sets what the backend actually gave us
+      rx->audio_device_latency=rx->output_stream->software_latency*1000.0;
 
       g_mutex_unlock(&rx->local_audio_mutex);
       break;
@@ -320,6 +408,15 @@ g_print("audio_open_output: PULSEAUDIO: %s\n",rx->audio_name);
 
         char stream_id[16];
         sprintf(stream_id,"RX-%d",rx->channel);
+
+        // keep the server side buffer to its share of the latency, the default is about 2 seconds
+        pa_buffer_attr buffer_attr;
+        int latency=audio_device_budget(rx);
+        buffer_attr.maxlength=(uint32_t)-1;
+        buffer_attr.tlength=pa_usec_to_bytes(latency*1000,&sample_spec);
+        buffer_attr.prebuf=(uint32_t)-1;
+        buffer_attr.minreq=(uint32_t)-1;
+        buffer_attr.fragsize=(uint32_t)-1;
     
         rx->playstream=pa_simple_new(NULL,               // Use the default server.
                         "linHPSDR",           // Our application's name.
@@ -328,14 +425,16 @@ g_print("audio_open_output: PULSEAUDIO: %s\n",rx->audio_name);
                         stream_id,            // Description of our stream.
                         &sample_spec,                // Our sample format.
                         NULL,               // Use default channel map
-                        NULL,               // Use default buffering attributes.
+                        &buffer_attr,       // Buffering attributes.
                         &err               // error code if returns NULL
                         );
     
         if(rx->playstream!=NULL) {
           rx->local_audio_buffer_offset=0;
-          rx->local_audio_buffer=g_new0(float,2*rx->local_audio_buffer_size);
-          fprintf(stderr,"audio_open_output: allocated local_audio_buffer %p size %ld bytes\n",rx->local_audio_buffer,2*rx->local_audio_buffer_size*sizeof(float));
+          rx->local_audio_buffer=g_new0(float,2*AUDIO_RMATCH_OUTSIZE);
+          rx->audio_device_latency=(double)latency;
+          fprintf(stderr,"audio_open_output: allocated local_audio_buffer %p size %ld bytes\n",rx->local_audio_buffer,2*AUDIO_RMATCH_OUTSIZE*sizeof(float));
+          audio_create_rmatch(rx);
         } else {
           result=-1;
           fprintf(stderr,"pa-simple_new failed: err=%d\n",err);
@@ -350,8 +449,10 @@ g_print("audio_open_output: ALSA: %s\n",rx->audio_name);
       unsigned int rate = 48000;
       unsigned int channels=2;
       int soft_resample=1;
-      unsigned int latency=200000;      
-      
+      unsigned int latency=audio_device_budget(rx)*1000;
+      snd_pcm_uframes_t buffer_size;
+      snd_pcm_uframes_t period_size;
+
       if(rx->audio_name==NULL) {
         rx->local_audio=0;
         return -1;
@@ -398,25 +499,34 @@ g_print("audio_open_output: ALSA: %s\n",rx->audio_name);
         return err;
       }
 
+      // the output thread paces itself on blocking writes
+      snd_pcm_nonblock(rx->playback_handle,0);
+      if(snd_pcm_get_params(rx->playback_handle,&buffer_size,&period_size)==0) {
+        rx->audio_device_latency=(double)buffer_size*1000.0/(double)rate;
+      } else {
+        rx->audio_device_latency=(double)latency/1000.0;
+      }
+
       rx->local_audio_buffer_offset=0;
       switch(rx->local_audio_format) {
         case SND_PCM_FORMAT_S16_LE:
-    g_print("audio_open_output: local_audio_buffer: size=%d sample=%ld\n",rx->local_audio_buffer_size,sizeof(gint16));
-          rx->local_audio_buffer=g_new(gint16,2*rx->local_audio_buffer_size);
+    g_print("audio_open_output: local_audio_buffer: size=%d sample=%ld\n",AUDIO_RMATCH_OUTSIZE,sizeof(gint16));
+          rx->local_audio_buffer=g_new(gint16,2*AUDIO_RMATCH_OUTSIZE);
             break;
         case SND_PCM_FORMAT_S32_LE:
-    g_print("audio_open_output: local_audio_buffer: size=%d sample=%ld\n",rx->local_audio_buffer_size,sizeof(gint32));
-          rx->local_audio_buffer=g_new(gint32,2*rx->local_audio_buffer_size);
+    g_print("audio_open_output: local_audio_buffer: size=%d sample=%ld\n",AUDIO_RMATCH_OUTSIZE,sizeof(gint32));
+          rx->local_audio_buffer=g_new(gint32,2*AUDIO_RMATCH_OUTSIZE);
           break;
         case SND_PCM_FORMAT_FLOAT_LE:
-    g_print("audio_open_output: local_audio_buffer: size=%d sample=%ld\n",rx->local_audio_buffer_size,sizeof(gfloat));
-          rx->local_audio_buffer=g_new(gfloat,2*rx->local_audio_buffer_size);
+    g_print("audio_open_output: local_audio_buffer: size=%d sample=%ld\n",AUDIO_RMATCH_OUTSIZE,sizeof(gfloat));
+          rx->local_audio_buffer=g_new(gfloat,2*AUDIO_RMATCH_OUTSIZE);
           break;
 
         default: return -1;
       }
+      audio_create_rmatch(rx);
       
-      g_print("audio_open_output: rx=%d handle=%p buffer=%p size=%d\n",rx->channel,rx->playback_handle,rx->local_audio_buffer,rx->local_audio_buffer_size);      
+      g_print("audio_open_output: rx=%d handle=%p buffer=%p size=%d\n",rx->channel,rx->playback_handle,rx->local_audio_buffer,AUDIO_RMATCH_OUTSIZE);      
 
       g_mutex_unlock(&rx->local_audio_mutex);          
       break;
@@ -661,6 +771,16 @@ g_print("audio_open_input: mic_buffer: size=%d channels=%d sample=%ld bytes\n",r
   return result;
 }
 
+#ifndef __APPLE__
+static void audio_stop_output_thread(RECEIVER *rx) {
+  if(rx->audio_output_thread_id!=NULL) {
+    g_atomic_int_set(&rx->audio_output_running,FALSE);
+    g_thread_join(rx->audio_output_thread_id);
+    rx->audio_output_thread_id=NULL;
+  }
+}
+#endif
+
 void audio_close_output(RECEIVER *rx) {
  g_print("audio_close_output\n");
   switch(radio->which_audio) {
@@ -674,10 +794,7 @@ void audio_close_output(RECEIVER *rx) {
         soundio_device_unref(rx->output_device);
         rx->output_device=NULL;
       } 
-      if(rx->ring_buffer!=NULL) {
-        soundio_ring_buffer_destroy(rx->ring_buffer);
-        rx->ring_buffer=NULL;
-      }
+      audio_destroy_rmatch(rx);
       rx->output_started=FALSE;
       g_mutex_unlock(&rx->local_audio_mutex);
       break;
@@ -685,6 +802,7 @@ void audio_close_output(RECEIVER *rx) {
 #ifndef __APPLE__
     case USE_PULSEAUDIO: {
       g_mutex_lock(&rx->local_audio_mutex);
+      audio_stop_output_thread(rx);
       if(rx->playstream!=NULL) {
         pa_simple_free(rx->playstream);
         rx->playstream=NULL;
@@ -693,12 +811,14 @@ void audio_close_output(RECEIVER *rx) {
         g_free(rx->local_audio_buffer);
         rx->local_audio_buffer=NULL;
       }
+      audio_destroy_rmatch(rx);
       rx->output_started=FALSE;
       g_mutex_unlock(&rx->local_audio_mutex);
       break;
     }
     case USE_ALSA: {    
       g_mutex_lock(&rx->local_audio_mutex);
+      audio_stop_output_thread(rx);
       if(rx->playback_handle!=NULL) {
         snd_pcm_close (rx->playback_handle);
         rx->playback_handle=NULL;
@@ -707,6 +827,7 @@ void audio_close_output(RECEIVER *rx) {
         g_free(rx->local_audio_buffer);
         rx->local_audio_buffer=NULL;
       }
+      audio_destroy_rmatch(rx);
       rx->output_started=FALSE;
       g_mutex_unlock(&rx->local_audio_mutex);
       break;
@@ -814,142 +935,61 @@ void audio_start_output(RECEIVER *rx) {
       break;
 #ifndef __APPLE__
     case USE_PULSEAUDIO:
-      rx->output_started=TRUE;
-      break;
     case USE_ALSA:
+      g_mutex_lock(&rx->local_audio_mutex);
+      if(rx->audio_rmatch!=NULL && rx->audio_output_thread_id==NULL) {
+        g_atomic_int_set(&rx->audio_output_running,TRUE);
+        rx->audio_output_thread_id=g_thread_new("Audio output",audio_output_thread,(gpointer)rx);
+      }
       rx->output_started=TRUE;
+      g_mutex_unlock(&rx->local_audio_mutex);
       break;
 #endif
   }
 }
 
 int audio_write(RECEIVER *rx,float left_sample,float right_sample) {
-  int result=0;
-  int rc;
-  int err;
-  float *float_buffer;  
-  
-  switch(radio->which_audio) {
-    case USE_SOUNDIO: {
-      g_mutex_lock(&rx->local_audio_mutex);
-      float samples[2];
-      samples[0]=left_sample;
-      samples[1]=right_sample;
-      if(rx->ring_buffer!=NULL) {
-        char *buf = soundio_ring_buffer_write_ptr(rx->ring_buffer);
-        int fill_count = sizeof(float)*2;
-        int free=soundio_ring_buffer_free_count(rx->ring_buffer);
-        if(free<fill_count) {
-          //g_print("audio_write: ring buffer full: need %d free %d\n",fill_count,free);
-        } else {
-          memcpy(buf, &samples[0], fill_count);
-          soundio_ring_buffer_advance_write_ptr(rx->ring_buffer, fill_count);
-        }
-      }
-      g_mutex_unlock(&rx->local_audio_mutex);
-      break;
+  g_mutex_lock(&rx->local_audio_mutex);
+  if(rx->audio_rmatch!=NULL) {
+    rx->audio_rmatch_in[rx->audio_rmatch_in_offset*2]=(double)left_sample;
+    rx->audio_rmatch_in[(rx->audio_rmatch_in_offset*2)+1]=(double)right_sample;
+    rx->audio_rmatch_in_offset++;
+    if(rx->audio_rmatch_in_offset>=AUDIO_RMATCH_INSIZE) {
+      xrmatchIN(rx->audio_rmatch,rx->audio_rmatch_in);
+      rx->audio_rmatch_in_offset=0;
     }
-#ifndef __APPLE__
-    case USE_PULSEAUDIO: {
-      g_mutex_lock(&rx->local_audio_mutex);
-      if(rx->local_audio_buffer==NULL) {
-        rx->local_audio_buffer_offset=0;
-        rx->local_audio_buffer=g_new0(float,2*rx->local_audio_buffer_size);
-      }
-      
-      float_buffer=(float *)rx->local_audio_buffer;
-      float_buffer[rx->local_audio_buffer_offset*2]=left_sample;
-      float_buffer[(rx->local_audio_buffer_offset*2)+1]=right_sample;
-      //rx->local_audio_buffer[rx->local_audio_buffer_offset*2]=left_sample;
-      //rx->local_audio_buffer[(rx->local_audio_buffer_offset*2)+1]=right_sample;
-      
-      rx->local_audio_buffer_offset++;
-      if(rx->local_audio_buffer_offset>=rx->local_audio_buffer_size) {
-        rc=pa_simple_write(rx->playstream,
-                           rx->local_audio_buffer,
-                           rx->local_audio_buffer_size*sizeof(float)*2,
-                           &err); 
-        if(rc!=0) {
-          fprintf(stderr,"audio_write failed err=%d\n",err);
-        }
-        rx->local_audio_buffer_offset=0;
-      }
-      g_mutex_unlock(&rx->local_audio_mutex);
-      break;
-    }
-    case USE_ALSA: {
-      snd_pcm_sframes_t delay;
-      long trim;
-      
-
-      gint32 *long_buffer;
-      gint16 *short_buffer;      
-
-      g_mutex_lock(&rx->local_audio_mutex);
-
-      if(rx->playback_handle!=NULL && rx->local_audio_buffer!=NULL) {
-        switch(rx->local_audio_format) {
-          case SND_PCM_FORMAT_S16_LE:
-            short_buffer=(gint16 *)rx->local_audio_buffer;
-            short_buffer[rx->local_audio_buffer_offset*2]=(gint16)(left_sample*32767.0F);
-            short_buffer[(rx->local_audio_buffer_offset*2)+1]=(gint16)(right_sample*32767.0F);
-            break;
-          case SND_PCM_FORMAT_S32_LE:
-            long_buffer=(gint32 *)rx->local_audio_buffer;
-            long_buffer[rx->local_audio_buffer_offset*2]=(gint32)(left_sample*4294967295.0F);
-            long_buffer[(rx->local_audio_buffer_offset*2)+1]=(gint32)(right_sample*4294967295.0F);
-            break;
-          case SND_PCM_FORMAT_FLOAT_LE:
-            float_buffer=(float *)rx->local_audio_buffer;
-            float_buffer[rx->local_audio_buffer_offset*2]=left_sample;
-            float_buffer[(rx->local_audio_buffer_offset*2)+1]=right_sample;
-            break;
-            
-          default: return -1;            
-        }
-        rx->local_audio_buffer_offset++;
-
-        if(rx->local_audio_buffer_offset>=rx->local_audio_buffer_size) {
-
-          trim=0;
-
-/*
-          int max_delay=rx->local_audio_buffer_size*6;
-          if(snd_pcm_delay(rx->playback_handle,&delay)==0) {
-            if(delay>max_delay) {
-              trim=delay-max_delay;
-g_print("audio delay=%ld trim=%ld audio_buffer_size=%d\n",delay,trim,rx->local_audio_buffer_size);
-            }
-          }
-*/
-          if(trim<rx->local_audio_buffer_size) {
-            if ((rc = snd_pcm_writei (rx->playback_handle, rx->local_audio_buffer, rx->local_audio_buffer_size-trim)) != rx->local_audio_buffer_size-trim) {
-              if(rc<0) {
-                if(rc==-EPIPE) {
-                  if ((rc = snd_pcm_prepare (rx->playback_handle)) < 0) {
-                    g_print("audio_write: cannot prepare audio interface for use %d (%s)\n", rc, snd_strerror (rc));
-                    rx->local_audio_buffer_offset=0;
-                    g_mutex_unlock(&rx->local_audio_mutex);
-                    return rc;
-                  }
-                } else {
-                  // ignore short write
-                }
-              }
-            }
-          }
-          rx->local_audio_buffer_offset=0;
-        }
-      }
+  }
+  g_mutex_unlock(&rx->local_audio_mutex);
+  return 0;
+}
 
-      g_mutex_unlock(&rx->local_audio_mutex);
-      break;
-    }      
-#endif
+gboolean audio_get_output_diags(RECEIVER *rx,int *underflows,int *overflows,double *ppm,double *latency,double *target) {
+  int ringsize;
+  int nring;
+  double var;
+  gboolean result=FALSE;
+
+  g_mutex_lock(&rx->local_audio_mutex);
+  if(rx->audio_rmatch!=NULL) {
+    getRMatchDiags(rx->audio_rmatch,underflows,overflows,&var,&ringsize,&nring);
+    *ppm=(var-1.0)*1.0e6;
+    // the device buffer is kept full by the writes, count it whole
+    *latency=(double)nring*1000.0/(double)sample_rate+rx->audio_device_latency;
+    *target=(double)ringsize*500.0/(double)sample_rate+rx->audio_device_latency;
+    result=TRUE;
   }
+  g_mutex_unlock(&rx->local_audio_mutex);
   return result;
 }
 
+void audio_reset_output_diags(RECEIVER *rx) {
+  g_mutex_lock(&rx->local_audio_mutex);
+  if(rx->audio_rmatch!=NULL) {
+    resetRMatchDiags(rx->audio_rmatch);
+  }
+  g_mutex_unlock(&rx->local_audio_mutex);
+}
+
 static void *mic_read_thread(gpointer arg) {
   RADIO *r=(RADIO *)arg;
   int rc;
@@ -48,6 +48,8 @@ void audio_start_output(RECEIVER *rx);
 extern void audio_close_output(RECEIVER *rx);
 extern int audio_write(RECEIVER *rx,float left_sample,float right_sample);
 extern int audio_write_buffer(RECEIVER *rx);
+extern gboolean audio_get_output_diags(RECEIVER *rx,int *underflows,int *overflows,double *ppm,double *latency,double *target);
+extern void audio_reset_output_diags(RECEIVER *rx);
 extern void audio_get_cards();
 extern void create_audio(int backend_index,const char *backend);
 extern int audio_get_backends(RADIO *r);
@@ -36,6 +36,9 @@
 #include "dac.h"
 #include "radio.h"
 #include "xvtr_dialog.h"
+#include "analyzer_policy.h"
+
+#define BPSK_SAMPLE_RATE 768000
 
 static int my_pixels=-1;
 static float *my_pixel_samples=NULL;
@@ -46,10 +49,9 @@ void bpsk_init_analyzer(BPSK *bpsk) {
     int n_pixout=1;
     int spur_elimination_ffts = 1;
     int data_type = 1;
-    int fft_size = 8192;
     int window_type = 4;
     double kaiser_pi = 14.0;
-    int overlap = 2048;
+    ANALYZER_PLAN plan;
     int clip = 0;
     int span_clip_l = 0;
     int span_clip_h = 0;
@@ -61,6 +63,11 @@ void bpsk_init_analyzer(BPSK *bpsk) {
 
 g_print("bpsk_init_analyzer: channel=%d pixels=%d pixel_samples=%p\n",bpsk->channel,bpsk->pixels,bpsk->pixel_samples);
 
+    // beacons only need about one bin per two 50Hz pixels
+    analyzer_plan(&plan,BPSK_SAMPLE_RATE,bpsk->fps,bpsk->pixels,0.5,0.0,0.0,ANALYZER_MIN_FFT,ANALYZER_MAX_FFT);
+    int fft_size = plan.fft_size;
+    int overlap = plan.overlap;
+
     int max_w = fft_size + (int) fmin(keep_time * (double) bpsk->fps, keep_time * (double) fft_size * (double) bpsk->fps);
 
 
@@ -102,7 +109,15 @@ int maximum(float data[], int len) {
     return mi;
 }
 
-static gboolean bpsk_local_timer_cb(void *data) {
+// Main thread, from the radio's display tick. GetPixelsMulti takes the
+// analyzer's own locks, bpsk->mutex only keeps Spectrum0 calls whole.
+void bpsk_display_request(BPSK *bpsk,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req) {
+  req->first=display_pixels_request(p,bpsk->channel,0,bpsk->pixel_samples);
+  req->pixels=req->first>=0;
+  req->frame=req->pixels;
+}
+
+void bpsk_display_update(BPSK *bpsk,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req) {
   // look +/-1KHz
   // assume sample rate is 768000
   // assume 15360 samples
@@ -111,19 +126,13 @@ static gboolean bpsk_local_timer_cb(void *data) {
 #define SIGNALS 16 
 #define SAMPLES 50
 
-  BPSK *bpsk=(BPSK *)data;
   int mid=bpsk->pixels/2;
   int signal[SIGNALS];
   int lag=10;
   float threshold = -70.0;
   float influence = 1;
-  int rc;
-
-  g_mutex_lock(&bpsk->mutex);
-  GetPixels(bpsk->channel,0,bpsk->pixel_samples,&rc);
-  g_mutex_unlock(&bpsk->mutex);
 
-  if(rc) {
+  if(display_pixels_ready(p,req->first)) {
     int max1=maximum(&bpsk->pixel_samples[mid-(SIGNALS/2)],SIGNALS);
 
     int max2=-1;;
@@ -164,7 +173,6 @@ static gboolean bpsk_local_timer_cb(void *data) {
       bpsk->count=0;
     }
   }
-  return TRUE;
 }
 
 void bpsk_add_iq_samples(BPSK *bpsk,double i_sample,double q_sample) {
@@ -191,7 +199,7 @@ g_print("create_bpsk: channel=%d\n",channel);
   bpsk->input_buffer=g_new0(gdouble,bpsk->buffer_size*2);
   bpsk->fft_size=bpsk->buffer_size;
   bpsk->pixel_samples=g_new0(float,bpsk->pixels);
-  bpsk->fps=10;
+  bpsk->fps=BPSK_FPS;
   bpsk->samples=0;
   bpsk->count=0;
   bpsk->offset=0.0;
@@ -208,13 +216,11 @@ g_print("create_bpsk: channel=%d\n",channel);
   SetDisplayDetectorMode(bpsk->channel, 0, DETECTOR_MODE_AVERAGE);
   SetDisplayAverageMode(bpsk->channel, 0,  AVERAGE_MODE_LOG_RECURSIVE);
 
-  bpsk->update_timer_id=g_timeout_add(100,bpsk_local_timer_cb,(gpointer)bpsk);
   return bpsk;
 }
 
 void destroy_bpsk(BPSK *bpsk) {
 g_print("destroy_bpsk\n");
-  g_source_remove(bpsk->update_timer_id);
   g_free(bpsk->input_buffer);
   g_free(bpsk->pixel_samples);
   g_free(bpsk);
@@ -20,6 +20,10 @@
 #ifndef BPSK_H
 #define BPSK_H
 
+#include "display_tick.h"
+
+#define BPSK_FPS 10
+
 typedef struct _bpsk {
   gint channel;
   gint band;
@@ -31,7 +35,7 @@ typedef struct _bpsk {
   gdouble *input_buffer;
   gfloat *pixel_samples;
   GMutex mutex;
-  gint update_timer_id;
+  gint tick_phase;            // display_tick_due() accumulator
   int count;
   double offset;
 } BPSK;
@@ -39,5 +43,7 @@ typedef struct _bpsk {
 extern BPSK *create_bpsk(int channel,int band);
 extern void destroy_bpsk(BPSK *bpsk);
 extern void bpsk_add_iq_samples(BPSK *bpsk,double i_sample,double q_sample);
+extern void bpsk_display_request(BPSK *bpsk,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
+extern void bpsk_display_update(BPSK *bpsk,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
 
 #endif
@@ -0,0 +1,155 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+
+#include "colormap.h"
+
+#define COLORMAP_CHUNK 256
+
+const char *palette_name[PALETTE_LAST]={
+  "Rainbow",
+  "Grayscale",
+  "Hot",
+  "Blue"
+};
+
+static float clamp1(float v) {
+  return v<0.0f?0.0f:(v>1.0f?1.0f:v);
+}
+
+static void palette_color(gint palette,float percent,guchar *rgb) {
+  float r, g, b;
+  switch(palette) {
+    case PALETTE_GRAYSCALE:
+      r=g=b=percent;
+      break;
+    case PALETTE_HOT:
+      r=clamp1(percent*3.0f);
+      g=clamp1(percent*3.0f-1.0f);
+      b=clamp1(percent*3.0f-2.0f);
+      break;
+    case PALETTE_BLUE:
+      r=clamp1(percent*3.0f-2.0f);
+      g=clamp1(percent*3.0f-1.0f);
+      b=clamp1(percent*3.0f);
+      break;
+    case PALETTE_RAINBOW:
+    default:
+      // black, blue, cyan, green, yellow, red, magenta, purple
+      if(percent<(2.0f/9.0f)) {
+        r=0.0f;
+        g=0.0f;
+        b=percent/(2.0f/9.0f);
+      } else if(percent<(3.0f/9.0f)) {
+        r=0.0f;
+        g=(percent-2.0f/9.0f)/(1.0f/9.0f);
+        b=1.0f;
+      } else if(percent<(4.0f/9.0f)) {
+        r=0.0f;
+        g=1.0f;
+        b=1.0f-(percent-3.0f/9.0f)/(1.0f/9.0f);
+      } else if(percent<(5.0f/9.0f)) {
+        r=(percent-4.0f/9.0f)/(1.0f/9.0f);
+        g=1.0f;
+        b=0.0f;
+      } else if(percent<(7.0f/9.0f)) {
+        r=1.0f;
+        g=1.0f-(percent-5.0f/9.0f)/(2.0f/9.0f);
+        b=0.0f;
+      } else if(percent<(8.0f/9.0f)) {
+        r=1.0f;
+        g=0.0f;
+        b=(percent-7.0f/9.0f)/(1.0f/9.0f);
+      } else {
+        float local_percent=(percent-8.0f/9.0f)/(1.0f/9.0f);
+        r=0.75f+0.25f*(1.0f-local_percent);
+        g=local_percent*0.5f;
+        b=1.0f;
+      }
+      break;
+  }
+  rgb[0]=(guchar)(r*255.0f);
+  rgb[1]=(guchar)(g*255.0f);
+  rgb[2]=(guchar)(b*255.0f);
+}
+
+static void colormap_build(COLORMAP *map) {
+  int i;
+  for(i=0;i<COLORMAP_SIZE;i++) {
+    palette_color(map->palette,(float)i/(float)(COLORMAP_SIZE-1),&map->rgb[(i+1)*3]);
+  }
+  palette_color(map->palette,0.0f,&map->rgb[0]);
+  if(map->palette==PALETTE_RAINBOW) {
+    // rainbow has always shown yellow above the high level
+    map->rgb[(COLORMAP_SIZE+1)*3]=255;
+    map->rgb[(COLORMAP_SIZE+1)*3+1]=255;
+    map->rgb[(COLORMAP_SIZE+1)*3+2]=0;
+  } else {
+    palette_color(map->palette,1.0f,&map->rgb[(COLORMAP_SIZE+1)*3]);
+  }
+}
+
+COLORMAP *create_colormap(gint palette,gint low,gint high) {
+  COLORMAP *map=g_new0(COLORMAP,1);
+  map->palette=-1;
+  colormap_update(map,palette,low,high);
+  return map;
+}
+
+void colormap_update(COLORMAP *map,gint palette,gint low,gint high) {
+  if(palette<0 || palette>=PALETTE_LAST) palette=PALETTE_RAINBOW;
+  if(palette!=map->palette) {
+    map->palette=palette;
+    colormap_build(map);
+  }
+  map->low=low;
+  map->high=high;
+  map->scale=high>low?(gfloat)COLORMAP_SIZE/(gfloat)(high-low):(gfloat)COLORMAP_SIZE;
+}
+
+//
+// convert a row of dB values to RGB. The index pass has no table lookups or
+// branches so the compiler can vectorize it; the gather is a plain copy.
+//
+void colormap_row(const COLORMAP *map,const float *db,float bias,guchar *rgb,int n) {
+  int index[COLORMAP_CHUNK];
+  const float low=(float)map->low-bias;
+  const float scale=map->scale;
+  const float top=(float)(COLORMAP_SIZE+1);
+  int base, i, m;
+
+  for(base=0;base<n;base+=COLORMAP_CHUNK) {
+    m=n-base<COLORMAP_CHUNK?n-base:COLORMAP_CHUNK;
+    for(i=0;i<m;i++) {
+      float f=(db[base+i]-low)*scale+1.0f;
+      // written so a NaN from the detector lands on the low end
+      f=f>0.0f?f:0.0f;
+      f=f<top?f:top;
+      index[i]=(int)f;
+    }
+    for(i=0;i<m;i++) {
+      const guchar *c=&map->rgb[index[i]*3];
+      rgb[0]=c[0];
+      rgb[1]=c[1];
+      rgb[2]=c[2];
+      rgb+=3;
+    }
+  }
+}
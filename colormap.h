@@ -0,0 +1,48 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _COLORMAP_H
+#define _COLORMAP_H
+
+#define COLORMAP_SIZE 1024
+
+enum {
+  PALETTE_RAINBOW,
+  PALETTE_GRAYSCALE,
+  PALETTE_HOT,
+  PALETTE_BLUE,
+  PALETTE_LAST
+};
+
+typedef struct _colormap {
+  gint palette;
+  gint low;
+  gint high;
+  gfloat scale;   // table entries per dB
+  // [0] is used below low, [COLORMAP_SIZE+1] above high, the gradient in between
+  guchar rgb[(COLORMAP_SIZE+2)*3];
+} COLORMAP;
+
+extern const char *palette_name[PALETTE_LAST];
+
+extern COLORMAP *create_colormap(gint palette,gint low,gint high);
+extern void colormap_update(COLORMAP *map,gint palette,gint low,gint high);
+extern void colormap_row(const COLORMAP *map,const float *db,float bias,guchar *rgb,int n);
+
+#endif
@@ -0,0 +1,68 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+
+#include "colour.h"
+
+// the palette of the meter and the panadapter overlays
+void SetColour(cairo_t *cr, const int colour) {
+  switch(colour) {
+    case BACKGROUND:
+      cairo_set_source_rgb(cr, 0.10, 0.10, 0.10);
+      break;
+    case OFF_WHITE:
+      cairo_set_source_rgb(cr, 0.90, 0.90, 0.90);
+      break;
+    case BOX_ON:
+      cairo_set_source_rgb(cr, 0.00, 0.50, 0.00);
+      break;
+    case BOX_OFF:
+      cairo_set_source_rgb(cr, 0.20, 0.20, 0.20);
+      break;
+    case TEXT_A:
+      cairo_set_source_rgb(cr, 0.92, 0.61, 0.50);
+      break;
+    case TEXT_B:
+      cairo_set_source_rgb(cr, 0.64, 0.80, 0.82);
+      break;
+    case TEXT_C:
+      cairo_set_source_rgb(cr, 0.90, 0.90, 0.90);
+      break;
+    case WARNING:
+      cairo_set_source_rgb(cr, 0.85, 0.27, 0.27);
+      break;
+    case DARK_LINES:
+      cairo_set_source_rgb(cr, 0.30, 0.30, 0.30);
+      break;
+    case DARK_TEXT:
+      cairo_set_source_rgb(cr, 0.70, 0.70, 0.70);
+      break;
+    case INFO_ON:
+      cairo_set_source_rgb(cr, 0.15, 0.58, 0.60);
+      break;
+    case INFO_OFF:
+      cairo_set_source_rgb(cr, 0.20, 0.20, 0.20);
+      break;
+    default:
+      // Fallback: black
+      cairo_set_source_rgb(cr, 0.00, 0.00, 0.00);
+      break;
+  }
+}
@@ -48,6 +48,7 @@
 #include "xvtr_dialog.h"
 #include "receiver_dialog.h"
 #include "about_dialog.h"
+#include "stats_dialog.h"
 #include "wideband_dialog.h"
 #ifdef MIDI
 #include "midi.h"
@@ -138,6 +139,7 @@ GtkWidget *create_configure_dialog(RADIO *radio, int tab) {
     gtk_notebook_append_page(GTK_NOTEBOOK(notebook), create_midi_dialog(radio), gtk_label_new("MIDI"));
 #endif
 
+    gtk_notebook_append_page(GTK_NOTEBOOK(notebook), create_stats_dialog(radio), gtk_label_new("Stats"));
     gtk_notebook_append_page(GTK_NOTEBOOK(notebook), create_about_dialog(radio), gtk_label_new("About"));
 
     gtk_container_add(GTK_CONTAINER(content), notebook);
@@ -0,0 +1,114 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include <wdsp.h>
+
+#include "deep_zoom.h"
+
+//
+// Filter length from the transition band, for the 7 term Blackman-Harris
+// window WDSP designs the resampler with: taps*transition of 10.5 keeps
+// the aliases more than 80 dB down.
+//
+#define TRANSITION_TAPS 10.5
+
+// flops per input sample for the shift: a complex multiply and the rotator
+#define SHIFT_FLOPS 14.0
+
+//
+// The largest power of two that keeps the visible span, 1/zoom of the
+// input rate, within the middle half of the output. That leaves the
+// filter room for a transition band either side and divides the block
+// size, so every block gives the analyzer the same number of samples.
+//
+gint deep_zoom_decimation(gint zoom) {
+  gint d=1;
+  if(zoom<DEEP_ZOOM_MIN_ZOOM) return 1;
+  while(d*4<=zoom) d<<=1;
+  return d;
+}
+
+//
+// Only what would alias into the visible span has to be removed, so the
+// transition band runs from the edge of the span to the edge of its first
+// alias: 1/decimation-1/zoom of the input rate.
+//
+static gint filter_taps(gint zoom,gint decimation) {
+  double transition=1.0/(double)decimation-1.0/(double)zoom;
+  return (gint)ceil(TRANSITION_TAPS/transition);
+}
+
+gdouble deep_zoom_cost(gint sample_rate,gint zoom) {
+  gint d=deep_zoom_decimation(zoom);
+  if(d<=1) return 0.0;
+  // the resampler computes only the outputs it keeps, a real coefficient
+  // times a complex sample per tap; calc_resample() adds one tap
+  double taps=(double)(filter_taps(zoom,d)+1);
+  return (double)sample_rate*(SHIFT_FLOPS+4.0*taps/(double)d)/1.0e6;
+}
+
+DEEP_ZOOM *deep_zoom_create(gint sample_rate,gint size,gint zoom) {
+  DEEP_ZOOM *dz;
+  gint d=deep_zoom_decimation(zoom);
+
+  if(d<=1 || size%d!=0) return NULL;
+  dz=g_new0(DEEP_ZOOM,1);
+  dz->in_rate=sample_rate;
+  dz->out_rate=sample_rate/d;
+  dz->decimation=d;
+  dz->zoom=zoom;
+  dz->size=size;
+  dz->ncoef=filter_taps(zoom,d);
+  dz->cost=deep_zoom_cost(sample_rate,zoom);
+  dz->shifted=g_new0(gdouble,2*size);
+  dz->out=g_new0(gdouble,2*(size/d));
+  dz->shift=create_shiftV(sample_rate,0.0);
+  // cut off half way between the visible span and its first alias
+  dz->resample=create_resample(1,size,dz->shifted,dz->out,sample_rate,dz->out_rate,0.5*(double)dz->out_rate,dz->ncoef,1.0);
+  return dz;
+}
+
+void deep_zoom_destroy(DEEP_ZOOM *dz) {
+  if(dz==NULL) return;
+  destroy_resample(dz->resample);
+  destroy_shiftV(dz->shift);
+  g_free(dz->shifted);
+  g_free(dz->out);
+  g_free(dz);
+}
+
+// Panning only retunes the shifter, the DSP thread picks it up next block
+void deep_zoom_set_offset(DEEP_ZOOM *dz,gdouble hz) {
+  g_atomic_int_set(&dz->offset,(gint)lround(hz));
+}
+
+// DSP thread, one block of rx->buffer_size samples in, size/decimation out
+gdouble *deep_zoom_process(DEEP_ZOOM *dz,gdouble *iq) {
+  gint offset=g_atomic_int_get(&dz->offset);
+  if(offset!=dz->applied) {
+    SetShiftFreqV(dz->shift,-(double)offset);
+    dz->applied=offset;
+  }
+  xshiftV(iq,dz->shifted,dz->size,dz->shift);
+  xresample(dz->resample);
+  return dz->out;
+}
@@ -0,0 +1,54 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#ifndef _DEEP_ZOOM_H
+#define _DEEP_ZOOM_H
+
+#define DEEP_ZOOM_MIN_ZOOM 4
+
+//
+// A digital down converter for the receiver's analyzer: the centre of the
+// visible span is shifted to DC and the IQ decimated, so at high zoom the
+// analyzer only transforms the part of the band that is on screen.
+//
+typedef struct _deep_zoom {
+  gint in_rate;
+  gint out_rate;
+  gint decimation;
+  gint zoom;
+  gint size;                // input samples per block
+  gint ncoef;
+  void *shift;
+  void *resample;
+  gdouble *shifted;
+  gdouble *out;             // size/decimation complex samples
+  gint offset;              // Hz, visible span centre, set from the main thread
+  gint applied;             // Hz, offset the shifter is tuned to, DSP thread only
+  gdouble cost;             // estimated shift and filter work (MFLOP/s)
+} DEEP_ZOOM;
+
+extern gint deep_zoom_decimation(gint zoom);
+extern gdouble deep_zoom_cost(gint sample_rate,gint zoom);
+extern DEEP_ZOOM *deep_zoom_create(gint sample_rate,gint size,gint zoom);
+extern void deep_zoom_destroy(DEEP_ZOOM *dz);
+extern void deep_zoom_set_offset(DEEP_ZOOM *dz,gdouble hz);
+extern gdouble *deep_zoom_process(DEEP_ZOOM *dz,gdouble *iq);
+
+#endif
@@ -0,0 +1,469 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+//
+// Display rendering benchmark, without a display server:
+//
+//   display_bench [-n frames]
+//
+// Builds its own receivers and transmitter and feeds them synthetic
+// analyzer samples, then times the calls the render thread and the
+// update timer make: update_rx_panadapter and update_waterfall at several
+// widths, zooms and receiver counts, and the S meter and TX panadapter.
+// Everything draws into cairo image surfaces and pixbufs. Prints the time
+// and, on glibc, the heap allocations per frame, so a change that makes
+// the render path slower or allocate can be seen.
+//
+// The VFO is GTK labels and buttons, it needs a display and the rest of
+// the program and is not covered.
+//
+
+#include <gtk/gtk.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wdsp.h>
+
+#include "bpsk.h"
+#include "receiver.h"
+#include "transmitter.h"
+#include "wideband.h"
+#include "discovered.h"
+#include "adc.h"
+#include "dac.h"
+#include "radio.h"
+#include "band.h"
+#include "mode.h"
+#include "agc.h"
+#include "configure_dialog.h"
+#include "rx_panadapter.h"
+#include "waterfall.h"
+#include "display_renderer.h"
+#include "panadapter_trace.h"
+#include "colormap.h"
+#include "meter.h"
+#include "tx_panadapter.h"
+#ifdef SOAPYSDR
+#include "soapy_protocol.h"
+#endif
+
+#define BENCH_HEIGHT 200
+#define BENCH_MAX_RECEIVERS 8
+#define METER_WIDTH 300
+#define METER_HEIGHT 60
+
+static const int bench_width[]={640,1280,1920,3840};
+static const int bench_zoom[]={1,4};
+static const int bench_receivers[]={1,2,4,8};
+
+static int frames=100;
+
+//
+// The rest of the program, as far as the display code reaches into it.
+// Only the globals are read while drawing; the functions are there for
+// the widget and band handling that is linked in but not run here.
+//
+RADIO *radio;
+gboolean opengl=FALSE;
+int rx_base=0;
+
+// so the TX panadapter draws its trace and readings
+gboolean isTransmitting(RADIO *r) { return TRUE; }
+void radio_id(RADIO *r,char *id,size_t size) { g_strlcpy(id,"display_bench",size); }
+void receiver_init_analyzer(RECEIVER *rx) {}
+void receiver_band_changed(RECEIVER *rx,int band) {}
+void transmitter_set_mode(TRANSMITTER *tx,int mode) {}
+void transmitter_init_analyzer(TRANSMITTER *tx) {}
+void update_vfo(RECEIVER *rx) {}
+GtkWidget *create_configure_dialog(RADIO *r,int tab) { return NULL; }
+gboolean receiver_button_press_event_cb(GtkWidget *widget, GdkEventButton *event, gpointer data) { return TRUE; }
+gboolean receiver_button_release_event_cb(GtkWidget *widget, GdkEventButton *event, gpointer data) { return TRUE; }
+gboolean receiver_motion_notify_event_cb(GtkWidget *widget, GdkEventMotion *event, gpointer data) { return TRUE; }
+gboolean receiver_scroll_event_cb(GtkWidget *widget, GdkEventScroll *event, gpointer data) { return TRUE; }
+#ifdef SOAPYSDR
+char *soapy_protocol_read_sensor(char *name) { return "0"; }
+#endif
+
+//
+// Every allocation made here and in the libraries (cairo, pixman, glib)
+// goes through these, so a frame that allocates shows up even when it
+// frees again before returning.
+//
+#ifdef __GLIBC__
+#define COUNT_ALLOCATIONS
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n,size_t size);
+extern void *__libc_realloc(void *p,size_t size);
+extern void *__libc_memalign(size_t alignment,size_t size);
+extern void __libc_free(void *p);
+
+static gint allocations=0;
+
+void *malloc(size_t size) {
+  g_atomic_int_inc(&allocations);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t n,size_t size) {
+  g_atomic_int_inc(&allocations);
+  return __libc_calloc(n,size);
+}
+
+void *realloc(void *p,size_t size) {
+  g_atomic_int_inc(&allocations);
+  return __libc_realloc(p,size);
+}
+
+int posix_memalign(void **p,size_t alignment,size_t size) {
+  g_atomic_int_inc(&allocations);
+  *p=__libc_memalign(alignment,size);
+  return *p==NULL?ENOMEM:0;
+}
+
+void *aligned_alloc(size_t alignment,size_t size) {
+  g_atomic_int_inc(&allocations);
+  return __libc_memalign(alignment,size);
+}
+
+void *memalign(size_t alignment,size_t size) {
+  g_atomic_int_inc(&allocations);
+  return __libc_memalign(alignment,size);
+}
+
+// replaced together with malloc, as glibc asks
+void free(void *p) {
+  __libc_free(p);
+}
+#endif
+
+static int allocation_count(void) {
+#ifdef COUNT_ALLOCATIONS
+  return g_atomic_int_get(&allocations);
+#else
+  return 0;
+#endif
+}
+
+// zoom 0 for displays that have none
+static void print_size(int width,int height,int zoom) {
+  char size[32];
+  if(zoom>0) {
+    snprintf(size,sizeof(size),"%dx%d zoom %d",width,height,zoom);
+  } else {
+    snprintf(size,sizeof(size),"%dx%d",width,height);
+  }
+  printf("%-18s",size);
+}
+
+static void print_frame(const char *name,gint64 us,int allocations) {
+  printf("  %-13s %6.0f us",name,(double)us/(double)frames);
+#ifdef COUNT_ALLOCATIONS
+  printf(" %5.1f allocs",(double)allocations/(double)frames);
+#endif
+}
+
+// noise floor with a few carriers
+static void bench_samples(float *samples,int n,GRand *rand) {
+  int i;
+  for(i=0;i<n;i++) {
+    samples[i]=-125.0f+(float)g_rand_double_range(rand,-4.0,4.0);
+  }
+  for(i=1;i<8;i++) {
+    int x=(n*i)/8;
+    samples[x]=-60.0f-(float)(i*5);
+    if(x+1<n) samples[x+1]=-70.0f-(float)(i*5);
+  }
+}
+
+// The display settings create_receiver() starts with, sized as if the
+// panadapter and waterfall had been allocated width x BENCH_HEIGHT
+static RECEIVER *bench_receiver(int width,int zoom) {
+  RECEIVER *rx=g_new0(RECEIVER,1);
+
+  rx->channel=0;
+  rx->adc=0;
+  rx->sample_rate=384000;
+  rx->fps=30;
+  rx->frequency_a=14200000;
+  rx->frequency_b=14210000;
+  rx->band_a=band20;
+  rx->mode_a=USB;
+  rx->filter_low_a=150;
+  rx->filter_high_a=2850;
+  rx->agc=AGC_OFF;
+  rx->smeter=RXA_S_AV;
+
+  rx->panadapter_low=-140;
+  rx->panadapter_high=-60;
+  rx->panadapter_step=20;
+  rx->panadapter_filled=TRUE;
+  rx->panadapter_gradient=TRUE;
+  // the AGC lines ask WDSP, which has no channel here
+  rx->panadapter_agc_line=FALSE;
+  rx->waterfall_automatic=TRUE;
+  rx->waterfall_low=-130;
+  rx->waterfall_high=-70;
+  rx->waterfall_palette=PALETTE_RAINBOW;
+  rx->waterfall_combine=WATERFALL_COMBINE_AVERAGE;
+
+  g_mutex_init(&rx->thread_context.render_mutex);
+  g_mutex_init(&rx->thread_context.frame_mutex);
+  frame_pacer_init(&rx->thread_context.pacer,rx->fps);
+  rx->renderer=&cairo_renderer;
+
+  rx->zoom=zoom;
+  rx->panadapter_width=width;
+  rx->panadapter_height=BENCH_HEIGHT;
+  rx->pixels=width*zoom;
+  rx->pan=(rx->pixels-width)/2;
+  rx->hz_per_pixel=(double)rx->sample_rate/(double)rx->pixels;
+  rx->analyzer_pixels=width;
+  rx->display_samples=g_new(float,width);
+  rx->display_samples_n=width;
+  rx->display_traces=1;
+  rx->panadapter_surface=cairo_image_surface_create(CAIRO_FORMAT_RGB24,width,BENCH_HEIGHT);
+  rx->panadapter_back=cairo_image_surface_create(CAIRO_FORMAT_RGB24,width,BENCH_HEIGHT);
+
+  rx->waterfall_width=width;
+  rx->waterfall_height=BENCH_HEIGHT;
+  rx->waterfall_pixbuf=gdk_pixbuf_new(GDK_COLORSPACE_RGB,FALSE,8,width,BENCH_HEIGHT);
+  memset(gdk_pixbuf_get_pixels(rx->waterfall_pixbuf),0,gdk_pixbuf_get_rowstride(rx->waterfall_pixbuf)*BENCH_HEIGHT);
+  return rx;
+}
+
+static void bench_receiver_free(RECEIVER *rx) {
+  PanadapterCache *px=&rx->panadapter_cache;
+  MeterCache *mc=&rx->meter_cache;
+  if(px->static_surface) cairo_surface_destroy(px->static_surface);
+  if(px->plot_surface) cairo_surface_destroy(px->plot_surface);
+  if(mc->static_surface) cairo_surface_destroy(mc->static_surface);
+  if(mc->units_surface) cairo_surface_destroy(mc->units_surface);
+  if(rx->meter_surface) cairo_surface_destroy(rx->meter_surface);
+  cairo_surface_destroy(rx->panadapter_surface);
+  cairo_surface_destroy(rx->panadapter_back);
+  g_object_unref(rx->waterfall_pixbuf);
+  if(rx->panadapter_trace) destroy_panadapter_trace(rx->panadapter_trace);
+  g_free(rx->waterfall_line);
+  g_free(rx->waterfall_colormap);
+  g_free(rx->display_samples);
+  g_mutex_clear(&rx->thread_context.render_mutex);
+  g_mutex_clear(&rx->thread_context.frame_mutex);
+  g_free(rx);
+}
+
+static void bench_rx(int width,int zoom) {
+  RECEIVER *rx=bench_receiver(width,zoom);
+  GRand *rand=g_rand_new_with_seed(1);
+  gint64 pan_us=0, wf_us=0, t0;
+  int pan_allocs=0, wf_allocs=0, a0;
+  int i;
+
+  // the first frame builds the caches
+  bench_samples(rx->display_samples,rx->display_samples_n,rand);
+  update_rx_panadapter(rx,TRUE);
+  update_waterfall(rx,rx->display_samples,rx->display_samples_n);
+
+  for(i=0;i<frames;i++) {
+    bench_samples(rx->display_samples,rx->display_samples_n,rand);
+    a0=allocation_count();
+    t0=g_get_monotonic_time();
+    update_rx_panadapter(rx,TRUE);
+    pan_us+=g_get_monotonic_time()-t0;
+    pan_allocs+=allocation_count()-a0;
+
+    a0=allocation_count();
+    t0=g_get_monotonic_time();
+    update_waterfall(rx,rx->display_samples,rx->display_samples_n);
+    wf_us+=g_get_monotonic_time()-t0;
+    wf_allocs+=allocation_count()-a0;
+  }
+
+  print_size(width,BENCH_HEIGHT,zoom);
+  print_frame("panadapter",pan_us,pan_allocs);
+  print_frame("waterfall",wf_us,wf_allocs);
+  printf("\n");
+
+  g_rand_free(rand);
+  bench_receiver_free(rx);
+}
+
+static void bench_meter(void) {
+  RECEIVER *rx=bench_receiver(640,1);
+  gint64 t0;
+  int a0;
+  int i;
+
+  rx->meter_surface=cairo_image_surface_create(CAIRO_FORMAT_RGB24,METER_WIDTH,METER_HEIGHT);
+  rx->meter_db=-100.0;
+  meter_render(rx,METER_WIDTH,METER_HEIGHT);
+
+  a0=allocation_count();
+  t0=g_get_monotonic_time();
+  for(i=0;i<frames;i++) {
+    // move the needle far enough to be redrawn, and the S unit with it
+    rx->meter_db=(i&1)?-60.0:-110.0;
+    meter_render(rx,METER_WIDTH,METER_HEIGHT);
+  }
+  gint64 us=g_get_monotonic_time()-t0;
+  print_size(METER_WIDTH,METER_HEIGHT,0);
+  print_frame("meter",us,allocation_count()-a0);
+  printf("\n");
+  bench_receiver_free(rx);
+}
+
+static void bench_tx(int width) {
+  RECEIVER *rx=bench_receiver(width,1);
+  TRANSMITTER *tx=g_new0(TRANSMITTER,1);
+  GRand *rand=g_rand_new_with_seed(1);
+  gint64 us=0, t0;
+  int allocs=0, a0;
+  int i;
+
+  tx->rx=rx;
+  tx->iq_output_rate=48000;
+  tx->pixels=width*3;
+  tx->pixel_samples=g_new(float,tx->pixels);
+  tx->panadapter_low=-140;
+  tx->panadapter_high=20;
+  tx->actual_filter_low=150;
+  tx->actual_filter_high=2850;
+  tx->fwd=5.0;
+  tx->rev=0.1;
+  tx->alc=-3.0;
+  tx->swr=1.0;
+  tx->panadapter_surface=cairo_image_surface_create(CAIRO_FORMAT_RGB24,width,BENCH_HEIGHT);
+  radio->transmitter=tx;
+
+  bench_samples(tx->pixel_samples,tx->pixels,rand);
+  tx_panadapter_render(radio,width,BENCH_HEIGHT);
+  for(i=0;i<frames;i++) {
+    bench_samples(tx->pixel_samples,tx->pixels,rand);
+    a0=allocation_count();
+    t0=g_get_monotonic_time();
+    tx_panadapter_render(radio,width,BENCH_HEIGHT);
+    us+=g_get_monotonic_time()-t0;
+    allocs+=allocation_count()-a0;
+  }
+  print_size(width,BENCH_HEIGHT,0);
+  print_frame("tx panadapter",us,allocs);
+  printf("\n");
+
+  radio->transmitter=NULL;
+  if(tx->panadapter_cache.static_surface) cairo_surface_destroy(tx->panadapter_cache.static_surface);
+  cairo_surface_destroy(tx->panadapter_surface);
+  g_free(tx->pixel_samples);
+  g_free(tx);
+  g_rand_free(rand);
+  bench_receiver_free(rx);
+}
+
+typedef struct _bench_worker {
+  RECEIVER *rx;
+  gint64 total_us;
+  gint64 max_us;
+} BENCH_WORKER;
+
+static gpointer bench_worker_thread(gpointer data) {
+  BENCH_WORKER *w=(BENCH_WORKER *)data;
+  RECEIVER *rx=w->rx;
+  GRand *rand=g_rand_new_with_seed((guint32)GPOINTER_TO_INT(w));
+  int i;
+
+  for(i=0;i<frames;i++) {
+    bench_samples(rx->display_samples,rx->display_samples_n,rand);
+    gint64 t0=g_get_monotonic_time();
+    g_mutex_lock(&rx->thread_context.render_mutex);
+    update_rx_panadapter(rx,TRUE);
+    update_waterfall(rx,rx->display_samples,rx->display_samples_n);
+    g_mutex_unlock(&rx->thread_context.render_mutex);
+    gint64 us=g_get_monotonic_time()-t0;
+    w->total_us+=us;
+    if(us>w->max_us) w->max_us=us;
+  }
+  g_rand_free(rand);
+  return NULL;
+}
+
+// n receivers rendering at once, one thread each like the render threads
+static void bench_parallel(int n,int width) {
+  BENCH_WORKER worker[BENCH_MAX_RECEIVERS];
+  GThread *thread[BENCH_MAX_RECEIVERS];
+  gint64 total=0, max=0;
+  int i;
+
+  for(i=0;i<n;i++) {
+    worker[i].rx=bench_receiver(width,1);
+    worker[i].total_us=0;
+    worker[i].max_us=0;
+  }
+  gint64 start=g_get_monotonic_time();
+  for(i=0;i<n;i++) {
+    thread[i]=g_thread_new("display bench",bench_worker_thread,&worker[i]);
+  }
+  for(i=0;i<n;i++) {
+    g_thread_join(thread[i]);
+    total+=worker[i].total_us;
+    if(worker[i].max_us>max) max=worker[i].max_us;
+    bench_receiver_free(worker[i].rx);
+  }
+  gint64 wall=g_get_monotonic_time()-start;
+
+  double avg=(double)total/(double)(n*frames);
+  double fps=(double)frames*1000000.0/(double)wall;
+  printf("%d rx  frame avg %6.2f ms  max %6.2f ms  sustains %5.0f fps per rx%s\n",
+      n,avg/1000.0,max/1000.0,fps,fps>=30.0?"":"  (below 30)");
+}
+
+int main(int argc,char **argv) {
+  int opt;
+  int w, z, n;
+
+  while((opt=getopt(argc,argv,"n:"))!=-1) {
+    switch(opt) {
+      case 'n': frames=atoi(optarg); break;
+      default:
+        fprintf(stderr,"usage: %s [-n frames]\n",argv[0]);
+        return 1;
+    }
+  }
+  if(frames<1) frames=1;
+
+  radio=g_new0(RADIO,1);
+  radio->discovered=g_new0(DISCOVERED,1);
+  radio->discovered->protocol=PROTOCOL_1;
+  radio->discovered->device=DEVICE_HERMES;
+
+  printf("display_bench: %d frames each, per frame:\n\n",frames);
+  for(w=0;w<(int)(sizeof(bench_width)/sizeof(bench_width[0]));w++) {
+    for(z=0;z<(int)(sizeof(bench_zoom)/sizeof(bench_zoom[0]));z++) {
+      bench_rx(bench_width[w],bench_zoom[z]);
+    }
+  }
+  printf("\n");
+  bench_meter();
+  bench_tx(1280);
+  printf("\nReceivers at 1920 wide, panadapter and waterfall\n");
+  for(n=0;n<(int)(sizeof(bench_receivers)/sizeof(bench_receivers[0]));n++) {
+    bench_parallel(bench_receivers[n],1920);
+  }
+  return 0;
+}
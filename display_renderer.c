@@ -0,0 +1,218 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "bpsk.h"
+#include "receiver.h"
+#include "transmitter.h"
+#include "wideband.h"
+#include "discovered.h"
+#include "adc.h"
+#include "dac.h"
+#include "radio.h"
+#include "rx_panadapter.h"
+#include "waterfall.h"
+#include "waterfall_ring.h"
+#include "panadapter_trace.h"
+#include "display_renderer.h"
+#include "main.h"
+
+// GL has to take at most this share of the cairo time to be chosen, the
+// benchmark does not see GTK compositing the GL area into the window
+#define GL_MARGIN 0.75
+
+const DISPLAY_RENDERER *display_renderer=&cairo_renderer;
+char display_renderer_report[128]="";
+
+//
+// cairo: the trace is rasterised on the render thread, the draw handlers
+// paint the finished image surface and the waterfall ring.
+//
+
+static gboolean cairo_panadapter_configure_event_cb(GtkWidget *widget,GdkEventConfigure *event,gpointer data) {
+  rx_panadapter_resize((RECEIVER *)data,gtk_widget_get_allocated_width(widget),gtk_widget_get_allocated_height(widget));
+  return TRUE;
+}
+
+static gboolean cairo_panadapter_draw_cb(GtkWidget *widget,cairo_t *cr,gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  ReceiverThreadContext *ctx=&rx->thread_context;
+  g_mutex_lock(&ctx->frame_mutex);
+  if(rx->panadapter_surface!=NULL) {
+    cairo_set_source_surface(cr,rx->panadapter_surface,0.0,0.0);
+    cairo_paint(cr);
+  }
+  g_mutex_unlock(&ctx->frame_mutex);
+  return TRUE;
+}
+
+static GtkWidget *cairo_panadapter_widget(RECEIVER *rx) {
+  GtkWidget *panadapter=gtk_drawing_area_new();
+  g_signal_connect(panadapter,"configure-event",G_CALLBACK(cairo_panadapter_configure_event_cb),rx);
+  g_signal_connect(panadapter,"draw",G_CALLBACK(cairo_panadapter_draw_cb),rx);
+  return panadapter;
+}
+
+static gboolean cairo_waterfall_configure_event_cb(GtkWidget *widget,GdkEventConfigure *event,gpointer data) {
+  waterfall_resize((RECEIVER *)data,gtk_widget_get_allocated_width(widget),gtk_widget_get_allocated_height(widget));
+  return TRUE;
+}
+
+static gboolean cairo_waterfall_draw_cb(GtkWidget *widget,cairo_t *cr,gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  if(rx->waterfall_pixbuf) {
+    waterfall_ring_draw(cr,rx->waterfall_pixbuf,g_atomic_int_get(&rx->waterfall_head));
+  }
+  return FALSE;
+}
+
+static GtkWidget *cairo_waterfall_widget(RECEIVER *rx) {
+  GtkWidget *waterfall=gtk_drawing_area_new();
+  g_signal_connect(waterfall,"configure-event",G_CALLBACK(cairo_waterfall_configure_event_cb),rx);
+  g_signal_connect(waterfall,"draw",G_CALLBACK(cairo_waterfall_draw_cb),rx);
+  return waterfall;
+}
+
+// rasterise into a persistent surface covering the plot area and paint it
+// under the decorations still to come
+static void cairo_plot(RECEIVER *rx,PANADAPTER_TRACE *t,cairo_t *cr,int width,int rows) {
+  PanadapterCache *px=&rx->panadapter_cache;
+
+  if(px->plot_surface==NULL ||
+     cairo_image_surface_get_width(px->plot_surface)!=width ||
+     cairo_image_surface_get_height(px->plot_surface)!=rows) {
+    if(px->plot_surface) {
+      cairo_surface_destroy(px->plot_surface);
+    }
+    px->plot_surface=cairo_image_surface_create(CAIRO_FORMAT_ARGB32,width,rows);
+  }
+  cairo_surface_flush(px->plot_surface);
+  panadapter_trace_render(t,cairo_image_surface_get_data(px->plot_surface),
+                          cairo_image_surface_get_stride(px->plot_surface),rows,
+                          rx->panadapter_filled,rx->panadapter_peak_hold,rx->panadapter_average);
+  cairo_surface_mark_dirty(px->plot_surface);
+
+  cairo_set_source_surface(cr,px->plot_surface,0,0);
+  cairo_paint(cr);
+}
+
+const DISPLAY_RENDERER cairo_renderer={
+  DISPLAY_RENDERER_CAIRO,
+  "cairo",
+  cairo_panadapter_widget,
+  cairo_waterfall_widget,
+  cairo_plot,
+  NULL,
+  NULL
+};
+
+//
+// Microseconds per frame for what the cairo backend does for a receiver
+// each frame: the trace rasterised and painted, the panadapter frame and
+// the waterfall ring painted as the draw handlers would.
+//
+gint64 cairo_renderer_benchmark(int width,int height,int frames) {
+  int rows=height-20;
+  int i, x;
+  cairo_surface_t *window=cairo_image_surface_create(CAIRO_FORMAT_RGB24,width,height);
+  cairo_surface_t *frame=cairo_image_surface_create(CAIRO_FORMAT_RGB24,width,height);
+  cairo_surface_t *plot=cairo_image_surface_create(CAIRO_FORMAT_ARGB32,width,rows);
+  GdkPixbuf *ring=gdk_pixbuf_new(GDK_COLORSPACE_RGB,FALSE,8,width,height);
+  int ring_stride=gdk_pixbuf_get_rowstride(ring);
+  guchar *ring_pixels=gdk_pixbuf_get_pixels(ring);
+  float *samples=g_new(float,width*2);
+  PANADAPTER_TRACE *t=create_panadapter_trace();
+  GRand *rand=g_rand_new_with_seed(1);
+  gint64 start=0;
+
+  memset(ring_pixels,0,ring_stride*height);
+  panadapter_trace_colours(t,rows,0.7f,TRUE);
+  for(i=-1;i<frames;i++) {
+    if(i==0) start=g_get_monotonic_time();
+    for(x=0;x<width*2;x++) samples[x]=-120.0f+(float)g_rand_double_range(rand,-5.0,5.0);
+    panadapter_trace_update(t,samples,width*2,width,0.0f,-40.0f,(float)rows/100.0f,rows,0.5f);
+    cairo_surface_flush(plot);
+    panadapter_trace_render(t,cairo_image_surface_get_data(plot),cairo_image_surface_get_stride(plot),rows,TRUE,TRUE,FALSE);
+    cairo_surface_mark_dirty(plot);
+    memset(ring_pixels+((i+1)%height)*ring_stride,i&0xFF,width*3);
+
+    cairo_t *cr=cairo_create(frame);
+    cairo_set_source_surface(cr,plot,0,0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    cr=cairo_create(window);
+    cairo_set_source_surface(cr,frame,0,0);
+    cairo_paint(cr);
+    waterfall_ring_draw(cr,ring,(i+1)%height);
+    cairo_destroy(cr);
+    cairo_surface_flush(window);
+  }
+  gint64 us=(g_get_monotonic_time()-start)/frames;
+
+  g_rand_free(rand);
+  destroy_panadapter_trace(t);
+  g_free(samples);
+  g_object_unref(ring);
+  cairo_surface_destroy(plot);
+  cairo_surface_destroy(frame);
+  cairo_surface_destroy(window);
+  return us;
+}
+
+//
+// Pick the backend for the receivers created from now on. With automatic
+// selection GL is only used when it is clearly faster here, which it may
+// well not be with software rendering such as Mesa's llvmpipe.
+//
+void display_renderer_select(int preference) {
+  gint64 cairo_us=-1;
+  gint64 gl_us=-1;
+  char gl_name[64]="none";
+
+  display_renderer=&cairo_renderer;
+#ifdef OPENGL
+  if(opengl && preference!=DISPLAY_RENDERER_CAIRO) {
+    gl_us=gl_renderer_benchmark(gl_name,sizeof(gl_name));
+    if(gl_us>=0) {
+      if(preference==DISPLAY_RENDERER_GL) {
+        display_renderer=&gl_renderer;
+      } else {
+        cairo_us=cairo_renderer_benchmark(DISPLAY_RENDERER_BENCH_WIDTH,DISPLAY_RENDERER_BENCH_HEIGHT,DISPLAY_RENDERER_BENCH_FRAMES);
+        if((double)gl_us<=GL_MARGIN*(double)cairo_us) {
+          display_renderer=&gl_renderer;
+        }
+      }
+    }
+  }
+#endif
+  if(preference!=DISPLAY_RENDERER_AUTO) {
+    g_snprintf(display_renderer_report,sizeof(display_renderer_report),"%s (selected), GL: %s",
+        display_renderer->name,gl_name);
+  } else if(gl_us<0) {
+    g_snprintf(display_renderer_report,sizeof(display_renderer_report),"%s, no usable GL",display_renderer->name);
+  } else {
+    g_snprintf(display_renderer_report,sizeof(display_renderer_report),"%s: cairo %lld us, GL %lld us per frame (%s)",
+        display_renderer->name,(long long)cairo_us,(long long)gl_us,gl_name);
+  }
+  g_print("display renderer: %s\n",display_renderer_report);
+}
@@ -0,0 +1,66 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#ifndef _DISPLAY_RENDERER_H
+#define _DISPLAY_RENDERER_H
+
+#include "panadapter_trace.h"
+
+#define DISPLAY_RENDERER_AUTO 0
+#define DISPLAY_RENDERER_CAIRO 1
+#define DISPLAY_RENDERER_GL 2
+
+#define DISPLAY_RENDERER_BENCH_WIDTH 1024
+#define DISPLAY_RENDERER_BENCH_HEIGHT 256
+#define DISPLAY_RENDERER_BENCH_FRAMES 30
+
+//
+// How the panadapter and waterfall frames reach the screen. The render
+// thread always draws the frame decorations with cairo and the waterfall
+// rows into the pixbuf ring; a backend rasterises or stages the trace and
+// presents both in its own widgets.
+//
+typedef struct _display_renderer {
+  gint id;
+  const char *name;
+  // main thread: the widgets the frames are presented in
+  GtkWidget *(*panadapter_widget)(RECEIVER *rx);
+  GtkWidget *(*waterfall_widget)(RECEIVER *rx);
+  // render thread, render_mutex held: the trace for the back frame, 'cr'
+  // draws on it and the plot covers 'rows' rows from the top
+  void (*plot)(RECEIVER *rx,PANADAPTER_TRACE *t,cairo_t *cr,int width,int rows);
+  // render thread, frame_mutex held: the back frame becomes the front
+  void (*swap)(RECEIVER *rx);
+  // the receiver is going away
+  void (*release)(RECEIVER *rx);
+} DISPLAY_RENDERER;
+
+extern const DISPLAY_RENDERER cairo_renderer;
+#ifdef OPENGL
+extern const DISPLAY_RENDERER gl_renderer;
+extern gint64 gl_renderer_benchmark(char *name,int size);
+#endif
+extern const DISPLAY_RENDERER *display_renderer;
+extern char display_renderer_report[128];
+
+extern void display_renderer_select(int preference);
+extern gint64 cairo_renderer_benchmark(int width,int height,int frames);
+
+#endif
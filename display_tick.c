@@ -0,0 +1,172 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <wdsp.h>
+
+#include "bpsk.h"
+#include "discovered.h"
+#include "adc.h"
+#include "dac.h"
+#include "receiver.h"
+#include "transmitter.h"
+#include "wideband.h"
+#include "radio.h"
+#include "shared_analyzer.h"
+#include "main.h"
+#include "display_tick.h"
+
+//
+// One main loop timer refreshes every display of the radio: receivers,
+// the transmitter, the wideband display and the BPSK beacon tracker. It
+// runs at the highest display frame rate and each display takes its
+// share of the ticks, so the main loop wakes once per frame period
+// however many displays are open, and the pixels of all of them are
+// fetched from the analyzers in one pass.
+//
+
+static guint tick_id=0;
+static gint tick_fps=0;
+
+static gboolean display_tick_cb(gpointer data);
+
+gint display_pixels_request(DISPLAY_PIXELS *p,int disp,int pixout,float *pix) {
+  if(p->n>=DISPLAY_TICK_MAX_REQUESTS) return -1;
+  p->disp[p->n]=disp;
+  p->pixout[p->n]=pixout;
+  p->pix[p->n]=pix;
+  p->flag[p->n]=0;
+  return p->n++;
+}
+
+gboolean display_pixels_ready(DISPLAY_PIXELS *p,int i) {
+  return i>=0 && i<p->n && p->flag[i];
+}
+
+//
+// A display at 'fps' is due on fps out of every tick_fps ticks, spread
+// evenly and without drift. 'phase' is the display's own accumulator.
+//
+gboolean display_tick_due(gint *phase,int fps) {
+  *phase+=fps;
+  if(*phase<tick_fps) return FALSE;
+  *phase-=tick_fps;
+  // the display is faster than the tick until the tick catches up
+  if(*phase>=tick_fps) *phase=0;
+  return TRUE;
+}
+
+int display_tick_fps(void) {
+  return tick_fps;
+}
+
+static int radio_fps(RADIO *r) {
+  int fps=BPSK_FPS;
+  int i;
+
+  for(i=0;i<MAX_RECEIVERS;i++) {
+    if(r->receiver[i]!=NULL && r->receiver[i]->fps>fps) fps=r->receiver[i]->fps;
+  }
+  if(r->transmitter!=NULL && r->transmitter->fps>fps) fps=r->transmitter->fps;
+  if(r->wideband!=NULL && r->wideband->fps>fps) fps=r->wideband->fps;
+  return fps;
+}
+
+static gboolean display_tick_cb(gpointer data) {
+  RADIO *r=(RADIO *)data;
+  DISPLAY_PIXELS p;
+  DISPLAY_REQUEST rx_request[MAX_RECEIVERS];
+  DISPLAY_REQUEST bpsk_request[MAX_RECEIVERS];
+  DISPLAY_REQUEST tx_request;
+  DISPLAY_REQUEST wideband_request;
+  gboolean rx_due[MAX_RECEIVERS];
+  gboolean bpsk_due[MAX_RECEIVERS];
+  gboolean tx_due=FALSE;
+  gboolean wideband_due=FALSE;
+  int i;
+
+  p.n=0;
+  shared_analyzer_update(r);
+  shared_analyzer_request(&p);
+
+  for(i=0;i<MAX_RECEIVERS;i++) {
+    RECEIVER *rx=r->receiver[i];
+    // a receiver being deleted has stopped its threads
+    rx_due[i]=rx!=NULL && rx->thread_context.running && display_tick_due(&rx->tick_phase,rx->fps);
+    if(rx_due[i]) {
+      receiver_display_request(rx,&p,&rx_request[i]);
+    }
+    bpsk_due[i]=rx!=NULL && rx->bpsk_enable && rx->bpsk!=NULL &&
+                display_tick_due(&rx->bpsk->tick_phase,rx->bpsk->fps);
+    if(bpsk_due[i]) {
+      bpsk_display_request(rx->bpsk,&p,&bpsk_request[i]);
+    }
+  }
+  if(r->transmitter!=NULL && r->transmitter->analyzer_created) {
+    tx_due=display_tick_due(&r->transmitter->tick_phase,r->transmitter->fps);
+    if(tx_due) {
+      transmitter_display_request(r->transmitter,&p,&tx_request);
+    }
+  }
+  if(r->wideband!=NULL) {
+    wideband_due=display_tick_due(&r->wideband->tick_phase,r->wideband->fps);
+    if(wideband_due) {
+      wideband_display_request(r->wideband,&p,&wideband_request);
+    }
+  }
+
+  if(p.n>0) {
+    GetPixelsMulti(p.n,p.disp,p.pixout,p.pix,p.flag);
+  }
+  shared_analyzer_collected(&p);
+
+  for(i=0;i<MAX_RECEIVERS;i++) {
+    if(rx_due[i] && r->receiver[i]!=NULL) {
+      receiver_display_update(r->receiver[i],&p,&rx_request[i]);
+    }
+    if(bpsk_due[i] && r->receiver[i]!=NULL && r->receiver[i]->bpsk!=NULL) {
+      bpsk_display_update(r->receiver[i]->bpsk,&p,&bpsk_request[i]);
+    }
+  }
+  if(tx_due && r->transmitter!=NULL) {
+    transmitter_display_update(r->transmitter,&p,&tx_request);
+  }
+  if(wideband_due && r->wideband!=NULL) {
+    wideband_display_update(r->wideband,&p,&wideband_request);
+  }
+
+  // follow the fastest display
+  int fps=radio_fps(r);
+  if(fps!=tick_fps) {
+    tick_fps=fps;
+    tick_id=g_timeout_add(1000/tick_fps,display_tick_cb,(gpointer)r);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// once the radio's displays exist
+void display_tick_start(void) {
+  if(tick_id!=0) {
+    g_source_remove(tick_id);
+  }
+  tick_fps=radio_fps(radio);
+  tick_id=g_timeout_add(1000/tick_fps,display_tick_cb,(gpointer)radio);
+}
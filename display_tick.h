@@ -0,0 +1,51 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#ifndef _DISPLAY_TICK_H
+#define _DISPLAY_TICK_H
+
+#define DISPLAY_TICK_MAX_REQUESTS 48   // receivers with detectors, shared, tx, wideband, bpsk
+
+//
+// The analyzer outputs wanted on one tick, fetched with a single
+// GetPixelsMulti() call.
+//
+typedef struct _display_pixels {
+  gint n;
+  gint disp[DISPLAY_TICK_MAX_REQUESTS];
+  gint pixout[DISPLAY_TICK_MAX_REQUESTS];
+  gfloat *pix[DISPLAY_TICK_MAX_REQUESTS];
+  gint flag[DISPLAY_TICK_MAX_REQUESTS];
+} DISPLAY_PIXELS;
+
+// What a display asked for on this tick, handed back when the pixels are in
+typedef struct _display_request {
+  gboolean pixels;          // it wants a frame this tick
+  gboolean frame;           // receivers: a panadapter frame is due, not only a waterfall line
+  gint first;               // its first request in DISPLAY_PIXELS, -1 if none
+} DISPLAY_REQUEST;
+
+extern gint display_pixels_request(DISPLAY_PIXELS *p,int disp,int pixout,float *pix);
+extern gboolean display_pixels_ready(DISPLAY_PIXELS *p,int i);
+extern gboolean display_tick_due(gint *phase,int fps);
+extern int display_tick_fps(void);
+extern void display_tick_start(void);
+
+#endif
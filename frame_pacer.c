@@ -0,0 +1,157 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+
+#include "frame_pacer.h"
+
+// render thread
+static void clear_render_stats(FRAME_PACER *p) {
+  p->last_us=0;
+  p->avg_us=0.0;
+  p->max_us=0;
+  p->window_frames=0;
+  p->window_late=0;
+  p->frames=0;
+  p->late=0;
+}
+
+// main thread: the counters it owns are cleared here, the render thread
+// clears its own on the next frame
+void frame_pacer_reset_stats(FRAME_PACER *p) {
+  p->dropped=0;
+  p->skipped=0;
+  g_atomic_int_set(&p->reset,1);
+}
+
+// before the render thread is started
+void frame_pacer_init(FRAME_PACER *p,int fps) {
+  p->pending=0;
+  p->present_pending=0;
+  p->late_pending=0;
+  p->restart=0;
+  p->reset=0;
+  p->tick=0;
+  p->ready_time=0;
+  p->dropped=0;
+  p->skipped=0;
+  clear_render_stats(p);
+  frame_pacer_set_fps(p,fps);
+}
+
+// main thread
+void frame_pacer_set_fps(FRAME_PACER *p,int fps) {
+  if(fps<1) fps=1;
+  g_atomic_int_set(&p->budget_us,1000000/fps);
+  g_atomic_int_set(&p->divider,1);
+  g_atomic_int_set(&p->restart,1);
+}
+
+// main thread, once per update timer tick: should this tick produce a frame?
+gboolean frame_pacer_tick(FRAME_PACER *p) {
+  if(++p->tick<g_atomic_int_get(&p->divider)) {
+    p->skipped++;
+    return FALSE;
+  }
+  p->tick=0;
+  return TRUE;
+}
+
+// main thread, after the samples were refreshed: TRUE if the render
+// thread has to be woken, FALSE if it still has a frame to take and will
+// simply pick up the newer samples
+gboolean frame_pacer_submit(FRAME_PACER *p) {
+  if(!g_atomic_int_compare_and_exchange(&p->pending,0,1)) {
+    p->dropped++;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// render thread, before taking the newest samples
+void frame_pacer_take(FRAME_PACER *p) {
+  g_atomic_int_set(&p->pending,0);
+}
+
+// render thread, after drawing a frame. The focused receiver may use the
+// whole frame period, the others give way once they need half of it.
+void frame_pacer_rendered(FRAME_PACER *p,gint64 us,gboolean priority) {
+  if(g_atomic_int_get(&p->reset)) {
+    g_atomic_int_set(&p->reset,0);
+    g_atomic_int_and(&p->late_pending,0);
+    clear_render_stats(p);
+  }
+  if(g_atomic_int_get(&p->restart)) {
+    g_atomic_int_set(&p->restart,0);
+    p->window_frames=0;
+    p->window_late=0;
+  }
+  guint late=g_atomic_int_and(&p->late_pending,0);
+  p->late+=late;
+  p->window_late+=late;
+
+  p->last_us=us;
+  if(us>p->max_us) p->max_us=us;
+  if(p->frames==0) {
+    p->avg_us=(double)us;
+  } else {
+    p->avg_us+=((double)us-p->avg_us)*0.05;
+  }
+  p->frames++;
+
+  if(++p->window_frames<FRAME_PACER_WINDOW) return;
+
+  gint divider=g_atomic_int_get(&p->divider);
+  double budget=(double)g_atomic_int_get(&p->budget_us);
+  double share=priority?1.0:0.5;
+  double available=share*budget*(double)divider;
+  gboolean behind=p->window_late>FRAME_PACER_WINDOW/4;
+  if((p->avg_us>available || behind) && divider<FRAME_PACER_MAX_DIVIDER) {
+    g_atomic_int_set(&p->divider,divider+1);
+  } else if(divider>1 && !behind && p->window_late==0 &&
+            p->avg_us<0.5*share*budget*(double)(divider-1)) {
+    g_atomic_int_set(&p->divider,divider-1);
+  }
+  p->window_frames=0;
+  p->window_late=0;
+}
+
+// render thread: TRUE if a present has to be scheduled on the main loop.
+// Only this thread raises present_pending, so while it is clear the main
+// thread does not look at ready_time.
+gboolean frame_pacer_ready(FRAME_PACER *p) {
+  if(g_atomic_int_get(&p->present_pending)) return FALSE;
+  p->ready_time=g_get_monotonic_time();
+  g_atomic_int_set(&p->present_pending,1);
+  return TRUE;
+}
+
+// main thread, from the present callback. The late count is handed to
+// the render thread, which owns the pacing window.
+void frame_pacer_presented(FRAME_PACER *p) {
+  if(g_get_monotonic_time()-p->ready_time>g_atomic_int_get(&p->budget_us)) {
+    g_atomic_int_inc(&p->late_pending);
+  }
+  g_atomic_int_set(&p->present_pending,0);
+}
+
+// any thread
+double frame_pacer_fps(FRAME_PACER *p,int fps) {
+  return (double)fps/(double)g_atomic_int_get(&p->divider);
+}
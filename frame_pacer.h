@@ -0,0 +1,71 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _FRAME_PACER_H
+#define _FRAME_PACER_H
+
+#define FRAME_PACER_MAX_DIVIDER 8     // never drop below fps/8
+#define FRAME_PACER_WINDOW 16         // frames between pacing decisions
+
+//
+// One pending frame per display, latest wins. The producer (the update
+// timer) marks a frame pending after refreshing the samples; if the
+// consumer (the render thread) has not taken the previous one yet it is
+// dropped rather than queued. Frame times are used to lower the
+// effective frame rate when rendering does not fit the budget.
+//
+// The render thread owns the render statistics and the pacing window,
+// the main thread owns tick, dropped and skipped. Everything else
+// crossing between them is a g_atomic int.
+//
+typedef struct _frame_pacer {
+  gint pending;             // a frame is waiting for the render thread
+  gint present_pending;     // an idle present is queued on the main loop
+  gint divider;             // produce a frame every 'divider' ticks
+  gint budget_us;           // frame period at the requested fps
+  guint late_pending;       // late presents not yet counted by the render thread
+  gint restart;             // fps changed: start a new pacing window
+  gint reset;               // clear the render statistics
+  gint tick;
+  gint64 ready_time;        // written only while no present is pending
+
+  gint64 last_us;           // render time
+  gdouble avg_us;
+  gint64 max_us;
+  guint window_frames;
+  guint window_late;
+
+  guint frames;
+  guint dropped;            // superseded before the render thread took them
+  guint late;               // presented more than one frame period after rendering
+  guint skipped;            // ticks skipped by the divider
+} FRAME_PACER;
+
+extern void frame_pacer_init(FRAME_PACER *p,int fps);
+extern void frame_pacer_set_fps(FRAME_PACER *p,int fps);
+extern void frame_pacer_reset_stats(FRAME_PACER *p);
+extern gboolean frame_pacer_tick(FRAME_PACER *p);
+extern gboolean frame_pacer_submit(FRAME_PACER *p);
+extern void frame_pacer_take(FRAME_PACER *p);
+extern void frame_pacer_rendered(FRAME_PACER *p,gint64 us,gboolean priority);
+extern gboolean frame_pacer_ready(FRAME_PACER *p);
+extern void frame_pacer_presented(FRAME_PACER *p);
+extern double frame_pacer_fps(FRAME_PACER *p,int fps);
+
+#endif
@@ -0,0 +1,322 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "panadapter_trace.h"
+#include "gl_display.h"
+
+#ifdef OPENGL
+
+//
+// GLSL 1.50, so a 3.2 core context is enough; Mesa's llvmpipe has that
+// when there is no GPU.
+//
+
+static const GLchar *vertex_source=
+  "#version 150\n"
+  "in vec2 position;\n"                // pixels, origin at the top left
+  "uniform vec2 size;\n"
+  "out vec2 texcoord;\n"
+  "void main() {\n"
+  "  texcoord=position/size;\n"
+  "  gl_Position=vec4(position.x/size.x*2.0-1.0,1.0-position.y/size.y*2.0,0.0,1.0);\n"
+  "}\n";
+
+static const GLchar *fragment_source=
+  "#version 150\n"
+  "uniform int mode;\n"                // 0 image, 1 colour, 2 fill
+  "uniform vec4 colour;\n"
+  "uniform float scroll;\n"            // image rows to skip, as a fraction of its height
+  "uniform vec2 size;\n"
+  "uniform sampler2D image;\n"
+  "uniform sampler2D colours;\n"
+  "in vec2 texcoord;\n"
+  "out vec4 fragment;\n"
+  "void main() {\n"
+  "  if(mode==0) {\n"
+  "    fragment=vec4(texture(image,vec2(texcoord.x,texcoord.y+scroll)).rgb,1.0);\n"
+  "  } else if(mode==1) {\n"
+  "    fragment=colour;\n"
+  "  } else {\n"
+  "    int rows=textureSize(colours,0).y;\n"
+  "    int row=int(size.y-gl_FragCoord.y);\n"
+  "    fragment=texelFetch(colours,ivec2(0,clamp(row,0,rows-1)),0);\n"
+  "  }\n"
+  "}\n";
+
+static GLuint compile(GLenum type,const GLchar *source) {
+  GLint ok=GL_FALSE;
+  GLuint shader=glCreateShader(type);
+  glShaderSource(shader,1,&source,NULL);
+  glCompileShader(shader);
+  glGetShaderiv(shader,GL_COMPILE_STATUS,&ok);
+  if(!ok) {
+    char log[512];
+    glGetShaderInfoLog(shader,sizeof(log),NULL,log);
+    g_print("gl_display: shader: %s\n",log);
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+static void texture_parameters(GLint wrap_t) {
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,wrap_t);
+}
+
+// with the context current; FALSE if it cannot run the shaders
+gboolean gl_display_init(GL_DISPLAY *g) {
+  GLint ok=GL_FALSE;
+
+  memset(g,0,sizeof(GL_DISPLAY));
+  GLuint vs=compile(GL_VERTEX_SHADER,vertex_source);
+  GLuint fs=compile(GL_FRAGMENT_SHADER,fragment_source);
+  if(vs==0 || fs==0) {
+    if(vs) glDeleteShader(vs);
+    if(fs) glDeleteShader(fs);
+    return FALSE;
+  }
+  g->program=glCreateProgram();
+  glAttachShader(g->program,vs);
+  glAttachShader(g->program,fs);
+  glBindAttribLocation(g->program,0,"position");
+  glLinkProgram(g->program);
+  glDeleteShader(vs);
+  glDeleteShader(fs);
+  glGetProgramiv(g->program,GL_LINK_STATUS,&ok);
+  if(!ok) {
+    g_print("gl_display: program link failed\n");
+    glDeleteProgram(g->program);
+    g->program=0;
+    return FALSE;
+  }
+  g->u_size=glGetUniformLocation(g->program,"size");
+  g->u_mode=glGetUniformLocation(g->program,"mode");
+  g->u_colour=glGetUniformLocation(g->program,"colour");
+  g->u_scroll=glGetUniformLocation(g->program,"scroll");
+  g->u_image=glGetUniformLocation(g->program,"image");
+  g->u_colours=glGetUniformLocation(g->program,"colours");
+
+  glGenVertexArrays(1,&g->vao);
+  glBindVertexArray(g->vao);
+  glGenBuffers(1,&g->vbo);
+  glBindBuffer(GL_ARRAY_BUFFER,g->vbo);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
+
+  glGenTextures(1,&g->image);
+  glBindTexture(GL_TEXTURE_2D,g->image);
+  texture_parameters(GL_REPEAT);
+  glGenTextures(1,&g->colours);
+  glBindTexture(GL_TEXTURE_2D,g->colours);
+  texture_parameters(GL_CLAMP_TO_EDGE);
+  return glGetError()==GL_NO_ERROR;
+}
+
+// with the context current
+void gl_display_free(GL_DISPLAY *g) {
+  if(g->image) glDeleteTextures(1,&g->image);
+  if(g->colours) glDeleteTextures(1,&g->colours);
+  if(g->vbo) glDeleteBuffers(1,&g->vbo);
+  if(g->vao) glDeleteVertexArrays(1,&g->vao);
+  if(g->program) glDeleteProgram(g->program);
+  memset(g,0,sizeof(GL_DISPLAY));
+}
+
+// Rows 'first' to 'first+rows-1' of the image, or all of them if the
+// size or format changed
+void gl_display_image(GL_DISPLAY *g,const guchar *data,int format,int width,int height,int stride,int first,int rows) {
+  int bytes=format==GL_DISPLAY_RGB?3:4;
+  GLenum fmt=format==GL_DISPLAY_RGB?GL_RGB:GL_BGRA;
+  GLenum type=format==GL_DISPLAY_RGB?GL_UNSIGNED_BYTE:GL_UNSIGNED_INT_8_8_8_8_REV;
+
+  if(width<=0 || height<=0) return;
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D,g->image);
+  if(stride%bytes==0) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH,stride/bytes);
+  } else {
+    // pixbuf rows are padded to 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT,4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
+  }
+  if(width!=g->image_width || height!=g->image_height || format!=g->image_format) {
+    glTexImage2D(GL_TEXTURE_2D,0,GL_RGB8,width,height,0,fmt,type,data);
+    g->image_width=width;
+    g->image_height=height;
+    g->image_format=format;
+  } else if(rows>0) {
+    if(first<0) first=0;
+    if(first+rows>height) rows=height-first;
+    glTexSubImage2D(GL_TEXTURE_2D,0,0,first,width,rows,fmt,type,data+first*stride);
+  }
+  glPixelStorei(GL_UNPACK_ROW_LENGTH,0);
+}
+
+void gl_display_begin(GL_DISPLAY *g,int width,int height) {
+  glUseProgram(g->program);
+  glBindVertexArray(g->vao);
+  glBindBuffer(GL_ARRAY_BUFFER,g->vbo);
+  glUniform2f(g->u_size,(GLfloat)width,(GLfloat)height);
+  glUniform1i(g->u_image,0);
+  glUniform1i(g->u_colours,1);
+  glDisable(GL_BLEND);
+}
+
+// the image over the whole display, starting 'scroll' rows down and
+// wrapping round
+void gl_display_draw_image(GL_DISPLAY *g,int width,int height,int scroll) {
+  const GLfloat quad[]={0.0f,0.0f, (GLfloat)width,0.0f, 0.0f,(GLfloat)height, (GLfloat)width,(GLfloat)height};
+
+  if(g->image_height<=0) return;
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D,g->image);
+  glUniform1i(g->u_mode,0);
+  glUniform1f(g->u_scroll,(GLfloat)scroll/(GLfloat)g->image_height);
+  glBufferData(GL_ARRAY_BUFFER,sizeof(quad),quad,GL_STREAM_DRAW);
+  glDrawArrays(GL_TRIANGLE_STRIP,0,4);
+}
+
+static void set_colour(GL_DISPLAY *g,guint32 c) {
+  // already premultiplied
+  glUniform4f(g->u_colour,(GLfloat)((c>>16)&0xFF)/255.0f,(GLfloat)((c>>8)&0xFF)/255.0f,
+      (GLfloat)(c&0xFF)/255.0f,(GLfloat)((c>>24)&0xFF)/255.0f);
+}
+
+void gl_display_draw_trace(GL_DISPLAY *g,const TRACE_VERTICES *v,int width,int height) {
+  static const GLenum mode[]={GL_TRIANGLE_STRIP,GL_LINE_STRIP,GL_LINES};
+  int i;
+
+  if(v->count<=0) return;
+  if(v->colour!=NULL && (v->colour_serial!=g->colour_serial || v->colour_rows!=g->colour_rows)) {
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D,g->colours);
+    glPixelStorei(GL_UNPACK_ALIGNMENT,4);
+    glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA8,1,v->colour_rows,0,GL_BGRA,GL_UNSIGNED_INT_8_8_8_8_REV,v->colour);
+    glActiveTexture(GL_TEXTURE0);
+    g->colour_serial=v->colour_serial;
+    g->colour_rows=v->colour_rows;
+  }
+  glBufferData(GL_ARRAY_BUFFER,v->count*2*sizeof(GLfloat),v->xy,GL_STREAM_DRAW);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE,GL_ONE_MINUS_SRC_ALPHA);
+  for(i=0;i<v->batches;i++) {
+    const TRACE_BATCH *b=&v->batch[i];
+    if(b->type==TRACE_BATCH_FILL) {
+      if(g->colour_rows<=0) continue;
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D,g->colours);
+      glActiveTexture(GL_TEXTURE0);
+      glUniform1i(g->u_mode,2);
+    } else {
+      glUniform1i(g->u_mode,1);
+      set_colour(g,b->colour);
+    }
+    glDrawArrays(mode[b->type],b->first,b->count);
+  }
+  glDisable(GL_BLEND);
+}
+
+//
+// Microseconds per frame for what a receiver presents each frame with
+// this context: the whole panadapter frame and one waterfall row
+// uploaded, both drawn and the trace on top, into an offscreen target.
+// -1 if the context cannot do it.
+//
+gint64 gl_display_benchmark(int width,int height,int frames) {
+  GL_DISPLAY pan, wf;
+  GLuint target, fbo;
+  int rows=height-20;
+  int i, x;
+
+  if(!gl_display_init(&pan)) return -1;
+  if(!gl_display_init(&wf)) {
+    gl_display_free(&pan);
+    return -1;
+  }
+
+  glGenTextures(1,&target);
+  glBindTexture(GL_TEXTURE_2D,target);
+  glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA8,width,height,0,GL_RGBA,GL_UNSIGNED_BYTE,NULL);
+  glGenFramebuffers(1,&fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER,fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER,GL_COLOR_ATTACHMENT0,GL_TEXTURE_2D,target,0);
+  gint64 us=-1;
+  if(glCheckFramebufferStatus(GL_FRAMEBUFFER)==GL_FRAMEBUFFER_COMPLETE) {
+    int frame_stride=width*4;
+    int ring_stride=(width*3+3)&~3;
+    guchar *frame=g_malloc0(frame_stride*height);
+    guchar *ring=g_malloc0(ring_stride*height);
+    float *samples=g_new(float,width*2);
+    PANADAPTER_TRACE *t=create_panadapter_trace();
+    TRACE_VERTICES v;
+    memset(&v,0,sizeof(v));
+    GRand *rand=g_rand_new_with_seed(1);
+
+    panadapter_trace_colours(t,rows,0.7f,TRUE);
+    glViewport(0,0,width,height);
+    gint64 start=0;
+    for(i=-1;i<frames;i++) {
+      if(i==0) {
+        // the first frame allocates, leave it out
+        glFinish();
+        start=g_get_monotonic_time();
+      }
+      for(x=0;x<width*2;x++) samples[x]=-120.0f+(float)g_rand_double_range(rand,-5.0,5.0);
+      panadapter_trace_update(t,samples,width*2,width,0.0f,-40.0f,(float)rows/100.0f,rows,0.5f);
+      panadapter_trace_vertices(t,&v,rows,TRUE,TRUE,FALSE);
+      memset(ring+((i+1)%height)*ring_stride,i&0xFF,width*3);
+
+      gl_display_image(&pan,frame,GL_DISPLAY_XRGB,width,height,frame_stride,0,height);
+      gl_display_begin(&pan,width,height);
+      gl_display_draw_image(&pan,width,height,0);
+      gl_display_draw_trace(&pan,&v,width,height);
+
+      gl_display_image(&wf,ring,GL_DISPLAY_RGB,width,height,ring_stride,(i+1)%height,1);
+      gl_display_begin(&wf,width,height);
+      gl_display_draw_image(&wf,width,height,(i+1)%height);
+    }
+    glFinish();
+    if(glGetError()==GL_NO_ERROR) {
+      us=(g_get_monotonic_time()-start)/frames;
+    }
+
+    g_rand_free(rand);
+    trace_vertices_free(&v);
+    destroy_panadapter_trace(t);
+    g_free(samples);
+    g_free(ring);
+    g_free(frame);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER,0);
+  glDeleteFramebuffers(1,&fbo);
+  glDeleteTextures(1,&target);
+  gl_display_free(&wf);
+  gl_display_free(&pan);
+  return us;
+}
+
+#endif
@@ -0,0 +1,63 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#ifndef _GL_DISPLAY_H
+#define _GL_DISPLAY_H
+
+#ifdef OPENGL
+#include <epoxy/gl.h>
+
+#define GL_DISPLAY_RGB 0           // GdkPixbuf rows
+#define GL_DISPLAY_XRGB 1          // cairo RGB24/ARGB32 rows
+
+//
+// What one GL context needs to show a display: an image texture (the
+// panadapter frame, or the waterfall ring which is scrolled by its head
+// instead of being moved) and the trace as vertices on top of it.
+//
+typedef struct _gl_display {
+  GLuint program;
+  GLuint vao;
+  GLuint vbo;
+  GLuint image;
+  GLuint colours;           // fill colour per row
+  GLint u_size;
+  GLint u_mode;
+  GLint u_colour;
+  GLint u_scroll;
+  GLint u_image;
+  GLint u_colours;
+  gint image_width;
+  gint image_height;
+  gint image_format;
+  guint colour_serial;
+  gint colour_rows;
+} GL_DISPLAY;
+
+extern gboolean gl_display_init(GL_DISPLAY *g);
+extern void gl_display_free(GL_DISPLAY *g);
+extern void gl_display_image(GL_DISPLAY *g,const guchar *data,int format,int width,int height,int stride,int first,int rows);
+extern void gl_display_begin(GL_DISPLAY *g,int width,int height);
+extern void gl_display_draw_image(GL_DISPLAY *g,int width,int height,int scroll);
+extern void gl_display_draw_trace(GL_DISPLAY *g,const TRACE_VERTICES *v,int width,int height);
+extern gint64 gl_display_benchmark(int width,int height,int frames);
+#endif
+
+#endif
@@ -0,0 +1,286 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "receiver.h"
+#include "rx_panadapter.h"
+#include "waterfall.h"
+#include "panadapter_trace.h"
+#include "display_renderer.h"
+
+#ifdef OPENGL
+#include "gl_display.h"
+
+//
+// OpenGL: the render thread still draws the frame decorations with cairo
+// and the waterfall rows into the pixbuf ring, but instead of rasterising
+// the trace it stages it as vertices. The GL areas upload the finished
+// frame, only the waterfall rows added since they last drew, and draw the
+// trace on top of the frame.
+//
+
+typedef struct _gl_receiver {
+  GL_DISPLAY panadapter;
+  GL_DISPLAY waterfall;
+  gboolean panadapter_ok;
+  gboolean waterfall_ok;
+  // back is staged by the render thread, front drawn under frame_mutex
+  TRACE_VERTICES *back;
+  TRACE_VERTICES *front;
+  TRACE_VERTICES vertices[2];
+  // the pixbuf as last uploaded
+  GdkPixbuf *waterfall_pixbuf;
+  gint waterfall_head;
+  gint waterfall_generation;
+} GL_RECEIVER;
+
+static GL_RECEIVER *gl_receiver(RECEIVER *rx) {
+  if(rx->renderer_data==NULL) {
+    GL_RECEIVER *g=g_new0(GL_RECEIVER,1);
+    g->back=&g->vertices[0];
+    g->front=&g->vertices[1];
+    rx->renderer_data=g;
+  }
+  return (GL_RECEIVER *)rx->renderer_data;
+}
+
+static gboolean gl_area_begin(GtkGLArea *area) {
+  gtk_gl_area_make_current(area);
+  if(gtk_gl_area_get_error(area)!=NULL) {
+    g_print("gl_renderer: %s\n",gtk_gl_area_get_error(area)->message);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static void gl_viewport(GtkWidget *widget,int *width,int *height) {
+  int scale=gtk_widget_get_scale_factor(widget);
+  *width=gtk_widget_get_allocated_width(widget);
+  *height=gtk_widget_get_allocated_height(widget);
+  glViewport(0,0,*width*scale,*height*scale);
+}
+
+static void gl_panadapter_realize_cb(GtkGLArea *area,gpointer data) {
+  GL_RECEIVER *g=gl_receiver((RECEIVER *)data);
+  if(gl_area_begin(area)) {
+    g->panadapter_ok=gl_display_init(&g->panadapter);
+  }
+}
+
+static void gl_panadapter_unrealize_cb(GtkGLArea *area,gpointer data) {
+  GL_RECEIVER *g=gl_receiver((RECEIVER *)data);
+  if(g->panadapter_ok && gl_area_begin(area)) {
+    gl_display_free(&g->panadapter);
+  }
+  g->panadapter_ok=FALSE;
+}
+
+static gboolean gl_panadapter_render_cb(GtkGLArea *area,GdkGLContext *context,gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  ReceiverThreadContext *ctx=&rx->thread_context;
+  GL_RECEIVER *g=gl_receiver(rx);
+  int width, height;
+
+  gl_viewport(GTK_WIDGET(area),&width,&height);
+  glClearColor(0.1f,0.1f,0.1f,1.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+  if(!g->panadapter_ok) return TRUE;
+
+  g_mutex_lock(&ctx->frame_mutex);
+  if(rx->panadapter_surface!=NULL) {
+    cairo_surface_t *s=rx->panadapter_surface;
+    cairo_surface_flush(s);
+    gl_display_image(&g->panadapter,cairo_image_surface_get_data(s),GL_DISPLAY_XRGB,
+        cairo_image_surface_get_width(s),cairo_image_surface_get_height(s),
+        cairo_image_surface_get_stride(s),0,cairo_image_surface_get_height(s));
+    gl_display_begin(&g->panadapter,width,height);
+    gl_display_draw_image(&g->panadapter,width,height,0);
+    gl_display_draw_trace(&g->panadapter,g->front,width,height);
+  }
+  g_mutex_unlock(&ctx->frame_mutex);
+  return TRUE;
+}
+
+static void gl_panadapter_size_allocate_cb(GtkWidget *widget,GdkRectangle *allocation,gpointer data) {
+  rx_panadapter_resize((RECEIVER *)data,allocation->width,allocation->height);
+}
+
+// GL areas take no input, the event box around them does
+static GtkWidget *gl_event_box(GtkWidget *area) {
+  GtkWidget *box=gtk_event_box_new();
+  gtk_container_add(GTK_CONTAINER(box),area);
+  return box;
+}
+
+static GtkWidget *gl_area(void) {
+  GtkWidget *area=gtk_gl_area_new();
+  gtk_gl_area_set_required_version(GTK_GL_AREA(area),3,2);
+  gtk_gl_area_set_has_alpha(GTK_GL_AREA(area),FALSE);
+  gtk_gl_area_set_auto_render(GTK_GL_AREA(area),TRUE);
+  return area;
+}
+
+static GtkWidget *gl_panadapter_widget(RECEIVER *rx) {
+  // before the render thread can stage a trace
+  gl_receiver(rx);
+  GtkWidget *area=gl_area();
+  g_signal_connect(area,"realize",G_CALLBACK(gl_panadapter_realize_cb),rx);
+  g_signal_connect(area,"unrealize",G_CALLBACK(gl_panadapter_unrealize_cb),rx);
+  g_signal_connect(area,"render",G_CALLBACK(gl_panadapter_render_cb),rx);
+  GtkWidget *box=gl_event_box(area);
+  g_signal_connect(box,"size-allocate",G_CALLBACK(gl_panadapter_size_allocate_cb),rx);
+  return box;
+}
+
+static void gl_waterfall_realize_cb(GtkGLArea *area,gpointer data) {
+  GL_RECEIVER *g=gl_receiver((RECEIVER *)data);
+  if(gl_area_begin(area)) {
+    g->waterfall_ok=gl_display_init(&g->waterfall);
+  }
+  g->waterfall_pixbuf=NULL;
+}
+
+static void gl_waterfall_unrealize_cb(GtkGLArea *area,gpointer data) {
+  GL_RECEIVER *g=gl_receiver((RECEIVER *)data);
+  if(g->waterfall_ok && gl_area_begin(area)) {
+    gl_display_free(&g->waterfall);
+  }
+  g->waterfall_ok=FALSE;
+  g->waterfall_pixbuf=NULL;
+}
+
+// heads run downwards from the bottom row, 0 and the height are the same
+static int ring_row(int head,int height) {
+  return head<=0 || head>=height?0:head;
+}
+
+static gboolean gl_waterfall_render_cb(GtkGLArea *area,GdkGLContext *context,gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  GL_RECEIVER *g=gl_receiver(rx);
+  GdkPixbuf *pixbuf=rx->waterfall_pixbuf;
+  int width, height;
+
+  gl_viewport(GTK_WIDGET(area),&width,&height);
+  glClearColor(0.0f,0.0f,0.0f,1.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+  if(!g->waterfall_ok || pixbuf==NULL) return TRUE;
+
+  int w=gdk_pixbuf_get_width(pixbuf);
+  int h=gdk_pixbuf_get_height(pixbuf);
+  int stride=gdk_pixbuf_get_rowstride(pixbuf);
+  const guchar *pixels=gdk_pixbuf_get_pixels(pixbuf);
+  int generation=g_atomic_int_get(&rx->waterfall_generation);
+  int head=ring_row(g_atomic_int_get(&rx->waterfall_head),h);
+
+  if(pixbuf!=g->waterfall_pixbuf || generation!=g->waterfall_generation ||
+     w!=g->waterfall.image_width || h!=g->waterfall.image_height) {
+    // force a whole upload
+    g->waterfall.image_width=0;
+    gl_display_image(&g->waterfall,pixels,GL_DISPLAY_RGB,w,h,stride,0,h);
+    g->waterfall_pixbuf=pixbuf;
+    g->waterfall_generation=generation;
+  } else {
+    // rows head to the last head, which may wrap past the bottom
+    int count=(g->waterfall_head-head+h)%h;
+    if(head+count>h) {
+      gl_display_image(&g->waterfall,pixels,GL_DISPLAY_RGB,w,h,stride,head,h-head);
+      gl_display_image(&g->waterfall,pixels,GL_DISPLAY_RGB,w,h,stride,0,head+count-h);
+    } else if(count>0) {
+      gl_display_image(&g->waterfall,pixels,GL_DISPLAY_RGB,w,h,stride,head,count);
+    }
+  }
+  g->waterfall_head=head;
+
+  gl_display_begin(&g->waterfall,width,height);
+  gl_display_draw_image(&g->waterfall,width,height,head);
+  return TRUE;
+}
+
+static void gl_waterfall_size_allocate_cb(GtkWidget *widget,GdkRectangle *allocation,gpointer data) {
+  waterfall_resize((RECEIVER *)data,allocation->width,allocation->height);
+}
+
+static GtkWidget *gl_waterfall_widget(RECEIVER *rx) {
+  GtkWidget *area=gl_area();
+  g_signal_connect(area,"realize",G_CALLBACK(gl_waterfall_realize_cb),rx);
+  g_signal_connect(area,"unrealize",G_CALLBACK(gl_waterfall_unrealize_cb),rx);
+  g_signal_connect(area,"render",G_CALLBACK(gl_waterfall_render_cb),rx);
+  GtkWidget *box=gl_event_box(area);
+  g_signal_connect(box,"size-allocate",G_CALLBACK(gl_waterfall_size_allocate_cb),rx);
+  return box;
+}
+
+static void gl_plot(RECEIVER *rx,PANADAPTER_TRACE *t,cairo_t *cr,int width,int rows) {
+  GL_RECEIVER *g=gl_receiver(rx);
+  panadapter_trace_vertices(t,g->back,rows,rx->panadapter_filled,rx->panadapter_peak_hold,rx->panadapter_average);
+}
+
+static void gl_swap(RECEIVER *rx) {
+  GL_RECEIVER *g=gl_receiver(rx);
+  TRACE_VERTICES *front=g->back;
+  g->back=g->front;
+  g->front=front;
+}
+
+// the GL objects went with the areas when they were unrealized
+static void gl_release(RECEIVER *rx) {
+  GL_RECEIVER *g=(GL_RECEIVER *)rx->renderer_data;
+  if(g!=NULL) {
+    trace_vertices_free(&g->vertices[0]);
+    trace_vertices_free(&g->vertices[1]);
+    g_free(g);
+    rx->renderer_data=NULL;
+  }
+}
+
+const DISPLAY_RENDERER gl_renderer={
+  DISPLAY_RENDERER_GL,
+  "OpenGL",
+  gl_panadapter_widget,
+  gl_waterfall_widget,
+  gl_plot,
+  gl_swap,
+  gl_release
+};
+
+//
+// Microseconds per frame for the GL work of one receiver, measured in an
+// unmapped GL area so it runs on the same GL implementation the receivers
+// would get, hardware or not. -1 if there is no usable 3.2 context.
+//
+gint64 gl_renderer_benchmark(char *name,int size) {
+  gint64 us=-1;
+  GtkWidget *window=gtk_window_new(GTK_WINDOW_POPUP);
+  GtkWidget *area=gl_area();
+
+  gtk_window_set_default_size(GTK_WINDOW(window),DISPLAY_RENDERER_BENCH_WIDTH,DISPLAY_RENDERER_BENCH_HEIGHT);
+  gtk_container_add(GTK_CONTAINER(window),area);
+  gtk_widget_realize(area);
+  if(gl_area_begin(GTK_GL_AREA(area))) {
+    const GLubyte *renderer=glGetString(GL_RENDERER);
+    g_strlcpy(name,renderer!=NULL?(const char *)renderer:"unknown",size);
+    us=gl_display_benchmark(DISPLAY_RENDERER_BENCH_WIDTH,DISPLAY_RENDERER_BENCH_HEIGHT,DISPLAY_RENDERER_BENCH_FRAMES);
+  }
+  gtk_widget_destroy(window);
+  return us;
+}
+#endif
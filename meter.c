@@ -54,25 +54,33 @@ static void meter_realize_cb(GtkWidget *widget, gpointer data) {
 
 static gboolean meter_configure_event_cb(GtkWidget *widget, GdkEventConfigure *event, gpointer data) {
     RECEIVER *rx = (RECEIVER *)data;
-    MeterCache *cache = &rx->meter_cache;
     int meter_width = gtk_widget_get_allocated_width(widget);
     int meter_height = gtk_widget_get_allocated_height(widget);
 
-    // Resize meter_surface if needed
+    // Resize meter_surface if needed, meter_render() redraws the scale
     if (rx->meter_surface) {
         cairo_surface_destroy(rx->meter_surface);
     }
     rx->meter_surface = gdk_window_create_similar_surface(gtk_widget_get_window(widget),
                                                           CAIRO_CONTENT_COLOR,
                                                           meter_width, meter_height);
+    return TRUE;
+}
+
+// The scale, redrawn only when the size changes
+static void draw_static(RECEIVER *rx, int meter_width, int meter_height) {
+    MeterCache *cache = &rx->meter_cache;
 
-    // Update static surface
     if (cache->static_surface) {
         cairo_surface_destroy(cache->static_surface);
     }
     cache->static_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, meter_width, meter_height);
     cache->width = meter_width;
     cache->height = meter_height;
+    if (cache->units_surface) {
+        cairo_surface_destroy(cache->units_surface);
+        cache->units_surface = NULL;
+    }
 
     // Draw static elements
     cairo_t *cr = cairo_create(cache->static_surface);
@@ -164,7 +172,6 @@ static gboolean meter_configure_event_cb(GtkWidget *widget, GdkEventConfigure *e
     }
 
     cairo_destroy(cr);
-    return TRUE;
 }
 
 static gboolean meter_draw_cb(GtkWidget *widget, cairo_t *cr, gpointer data) {
@@ -193,6 +200,10 @@ static void meter_destroy_cb(GtkWidget *widget, gpointer data) {
         cairo_surface_destroy(cache->static_surface);
         cache->static_surface = NULL;
     }
+    if (cache->units_surface) {
+        cairo_surface_destroy(cache->units_surface);
+        cache->units_surface = NULL;
+    }
 }
 
 static void meter_cb(GtkWidget *menu_item, gpointer data) {
@@ -236,6 +247,8 @@ GtkWidget *create_meter_visual(RECEIVER *rx) {
     rx->meter_cache.static_surface = NULL;
     rx->meter_cache.width = 0;
     rx->meter_cache.height = 0;
+    rx->meter_cache.level = -200.0;
+    rx->meter_cache.units_surface = NULL;
 
     GtkWidget *meter = gtk_drawing_area_new();
     g_signal_connect(meter, "realize", G_CALLBACK(meter_realize_cb), rx);
@@ -247,15 +260,52 @@ GtkWidget *create_meter_visual(RECEIVER *rx) {
     return meter;
 }
 
-void update_meter(RECEIVER *rx) {
+// The large S unit and over S9 glyphs only change every few dB, keep
+// them rendered between frames
+#define UNITS_X 270
+#define UNITS_WIDTH 100
+
+static void draw_units(MeterCache *cache, int s_unit, int over) {
+    char sf[32];
+
+    if (cache->units_surface == NULL) {
+        cache->units_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, UNITS_WIDTH, cache->height);
+    }
+    cache->s_unit = s_unit;
+    cache->over = over;
+
+    cairo_t *cr = cairo_create(cache->units_surface);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_select_font_face(cr, "Noto Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    SetColour(cr, TEXT_C);
+    cairo_set_font_size(cr, 36);
+    sprintf(sf, "S%d", s_unit);
+    cairo_move_to(cr, UNITS_X - 267, cache->height - 20);
+    cairo_show_text(cr, sf);
+    if (over > 0) {
+        cairo_set_font_size(cr, 24);
+        sprintf(sf, "+%d", over);
+        cairo_move_to(cr, UNITS_X - 225, (cache->height / 2) + 5);
+        cairo_show_text(cr, sf);
+    }
+    cairo_destroy(cr);
+}
+
+// Draws into rx->meter_surface, which has to be meter_width x
+// meter_height. Returns FALSE if the level did not move enough to redraw.
+gboolean meter_render(RECEIVER *rx, int meter_width, int meter_height) {
     rx->smax = 0.0;
-    static double last_level = -200.0; // Initialize to a low value
     char sf[32];
     cairo_t *cr;
     MeterCache *cache = &rx->meter_cache;
 
-    int meter_width = gtk_widget_get_allocated_width(rx->meter);
-    int meter_height = gtk_widget_get_allocated_height(rx->meter);
+    // Ensure static surface is valid
+    gboolean resized = !cache->static_surface || cache->width != meter_width || cache->height != meter_height;
+    if (resized) {
+        draw_static(rx, meter_width, meter_height);
+    }
 
     // Skip update if level hasn't changed significantly
     double attenuation = radio->adc[rx->adc].attenuation;
@@ -263,15 +313,10 @@ void update_meter(RECEIVER *rx) {
         attenuation = -attenuation;
     }
     double level = rx->meter_db + attenuation;
-    if (fabs(level - last_level) < 0.5) { // Threshold for redraw
-        return;
-    }
-    last_level = level;
-
-    // Ensure static surface is valid
-    if (!cache->static_surface || cache->width != meter_width || cache->height != meter_height) {
-        meter_configure_event_cb(rx->meter, NULL, rx); // Force static surface update
+    if (!resized && fabs(level - cache->level) < 0.5) { // Threshold for redraw
+        return FALSE;
     }
+    cache->level = level;
 
     // Draw to meter_surface
     cr = cairo_create(rx->meter_surface);
@@ -302,8 +347,6 @@ void update_meter(RECEIVER *rx) {
     cairo_show_text(cr, sf);
 
     // Calculate and draw S-unit
-    SetColour(cr, TEXT_C);
-    cairo_set_font_size(cr, 36);
     level = level + 127.0;
     if (level < 0) {
         level = 0;
@@ -317,24 +360,32 @@ void update_meter(RECEIVER *rx) {
             rx->smax -= (rx->smax - level) / (rx->fps / 2.0);
         }
     }
-    int i = (int)(rx->smax / 6.0);
-    if (i > 9) {
-        i = 9;
+    int s_unit = (int)(rx->smax / 6.0);
+    if (s_unit > 9) {
+        s_unit = 9;
     }
-    sprintf(sf, "S%d", i);
-    cairo_move_to(cr, meter_width - 267, meter_height - 20);
-    cairo_show_text(cr, sf);
 
     // Draw additional dB if needed
-    i = (int)rx->smax;
-    if (i > 54) {
-        i = i - 54;
-        cairo_set_font_size(cr, 24);
-        sprintf(sf, "+%d", i);
-        cairo_move_to(cr, meter_width - 225, (meter_height / 2) + 5);
-        cairo_show_text(cr, sf);
+    int over = (int)rx->smax > 54 ? (int)rx->smax - 54 : 0;
+    if (cache->units_surface == NULL || cache->s_unit != s_unit || cache->over != over) {
+        draw_units(cache, s_unit, over);
     }
+    cairo_set_source_surface(cr, cache->units_surface, meter_width - UNITS_X, 0.0);
+    cairo_paint(cr);
 
     cairo_destroy(cr);
-    gtk_widget_queue_draw(rx->meter);
+    return TRUE;
+}
+
+void update_meter(RECEIVER *rx) {
+    MeterCache *cache = &rx->meter_cache;
+    int meter_width = gtk_widget_get_allocated_width(rx->meter);
+    int meter_height = gtk_widget_get_allocated_height(rx->meter);
+
+    if (!cache->static_surface || cache->width != meter_width || cache->height != meter_height) {
+        meter_configure_event_cb(rx->meter, NULL, rx); // Force meter_surface update
+    }
+    if (meter_render(rx, meter_width, meter_height)) {
+        gtk_widget_queue_draw(rx->meter);
+    }
 }
\ No newline at end of file
@@ -18,4 +18,5 @@
 */
 
 extern GtkWidget *create_meter_visual(RECEIVER *rx);
+extern gboolean meter_render(RECEIVER *rx, int meter_width, int meter_height);
 extern void update_meter(RECEIVER *r);
@@ -0,0 +1,398 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "panadapter_trace.h"
+
+//
+// Panadapter trace generation. The column tables only change with the
+// width or the number of analyzer samples, so a frame is one gather pass
+// (interpolating when there are fewer samples than columns, min/max
+// decimation when there are more) and one branch free scale pass that
+// also updates the peak hold and average traces. The result is
+// rasterised straight into an ARGB32 buffer instead of building a cairo
+// path point by point. Detector overlays reuse the same tables.
+//
+
+#define TRACE_OUTLINE 0xBFBFBFBF   // premultiplied white, alpha 0.75
+#define TRACE_PEAK 0xBFBFBF00      // yellow
+#define TRACE_AVERAGE 0xBF00BFBF   // cyan
+
+static const guint32 detector_colour[TRACE_DETECTORS]={
+  0xBFBF4000,                      // peak, orange
+  0xBF00BF00,                      // rms, green
+  0xBF6060BF                       // min, blue
+};
+
+PANADAPTER_TRACE *create_panadapter_trace(void) {
+  PANADAPTER_TRACE *t=g_new0(PANADAPTER_TRACE,1);
+  t->rows=-1;
+  return t;
+}
+
+static void trace_free_columns(PANADAPTER_TRACE *t) {
+  g_free(t->first);
+  g_free(t->last);
+  g_free(t->frac);
+  g_free(t->db);
+  g_free(t->db_min);
+  g_free(t->peak);
+  g_free(t->average);
+  g_free(t->y);
+  g_free(t->y_min);
+  g_free(t->y_peak);
+  g_free(t->y_average);
+  for(int k=0;k<TRACE_DETECTORS;k++) g_free(t->y_detector[k]);
+}
+
+void destroy_panadapter_trace(PANADAPTER_TRACE *t) {
+  trace_free_columns(t);
+  g_free(t->colour);
+  g_free(t);
+}
+
+void panadapter_trace_reset(PANADAPTER_TRACE *t) {
+  t->history=FALSE;
+}
+
+static void trace_tables(PANADAPTER_TRACE *t,int n,int width) {
+  int c;
+
+  if(width>t->size) {
+    trace_free_columns(t);
+    t->first=g_new(gint,width);
+    t->last=g_new(gint,width);
+    t->frac=g_new(gfloat,width);
+    t->db=g_new(gfloat,width);
+    t->db_min=g_new(gfloat,width);
+    t->peak=g_new(gfloat,width);
+    t->average=g_new(gfloat,width);
+    t->y=g_new(gint,width);
+    t->y_min=g_new(gint,width);
+    t->y_peak=g_new(gint,width);
+    t->y_average=g_new(gint,width);
+    for(int k=0;k<TRACE_DETECTORS;k++) t->y_detector[k]=g_new(gint,width);
+    t->size=width;
+  }
+
+  for(c=0;c<width;c++) {
+    if(n>width) {
+      // each column covers one or more samples
+      t->first[c]=(int)((long long)c*n/width);
+      t->last[c]=(int)((long long)(c+1)*n/width)-1;
+      if(t->last[c]<t->first[c]) t->last[c]=t->first[c];
+      t->frac[c]=0.0f;
+    } else {
+      // interpolate between two neighbouring samples
+      double pos=width>1?(double)c*(double)(n-1)/(double)(width-1):0.0;
+      int i=(int)pos;
+      if(i>n-1) i=n-1;
+      t->first[c]=i;
+      t->last[c]=i+1<n?i+1:i;
+      t->frac[c]=(float)(pos-(double)i);
+    }
+  }
+  t->width=width;
+  t->samples=n;
+  t->history=FALSE;
+}
+
+void panadapter_trace_update(PANADAPTER_TRACE *t,const float *samples,int n,int width,
+    float bias,float high,float dbm_per_line,int bottom,float peak_decay) {
+  int c, i;
+
+  t->detectors=0;
+  if(n<=0 || width<=0) return;
+  if(width!=t->width || n!=t->samples) {
+    trace_tables(t,n,width);
+  }
+
+  // gather
+  if(n>width) {
+    for(c=0;c<width;c++) {
+      float lo=samples[t->first[c]];
+      float hi=lo;
+      for(i=t->first[c]+1;i<=t->last[c];i++) {
+        float s=samples[i];
+        lo=s<lo?s:lo;
+        hi=s>hi?s:hi;
+      }
+      t->db[c]=hi;
+      t->db_min[c]=lo;
+    }
+  } else {
+    for(c=0;c<width;c++) {
+      float a=samples[t->first[c]];
+      float b=samples[t->last[c]];
+      t->db[c]=a+(b-a)*t->frac[c];
+      t->db_min[c]=t->db[c];
+    }
+  }
+
+  if(!t->history) {
+    memcpy(t->peak,t->db,width*sizeof(float));
+    memcpy(t->average,t->db,width*sizeof(float));
+    t->history=TRUE;
+  }
+
+  // scale to screen rows, peak hold and average in the same pass
+  const float top=high-bias;
+  const float limit=(float)bottom;
+  for(c=0;c<width;c++) {
+    float v=t->db[c];
+    float pk=t->peak[c]-peak_decay;
+    pk=v>pk?v:pk;
+    float av=t->average[c]+(v-t->average[c])*TRACE_AVERAGE_MULT;
+    t->peak[c]=pk;
+    t->average[c]=av;
+
+    float y=(top-v)*dbm_per_line;
+    float y_min=(top-t->db_min[c])*dbm_per_line;
+    float y_peak=(top-pk)*dbm_per_line;
+    float y_average=(top-av)*dbm_per_line;
+    y=y<0.0f?0.0f:(y>limit?limit:y);
+    y_min=y_min<0.0f?0.0f:(y_min>limit?limit:y_min);
+    y_peak=y_peak<0.0f?0.0f:(y_peak>limit?limit:y_peak);
+    y_average=y_average<0.0f?0.0f:(y_average>limit?limit:y_average);
+    t->y[c]=(int)y;
+    t->y_min[c]=(int)y_min;
+    t->y_peak[c]=(int)y_peak;
+    t->y_average[c]=(int)y_average;
+  }
+}
+
+// One detector overlay, 'samples' has the same length as the main trace of
+// the last panadapter_trace_update. Decimated by maximum like the main
+// trace, except the minimum detector which keeps its minimum.
+void panadapter_trace_detector(PANADAPTER_TRACE *t,int detector,const float *samples,
+    float bias,float high,float dbm_per_line,int bottom) {
+  int c, i;
+
+  if(detector<0 || detector>=TRACE_DETECTORS || t->width<=0) return;
+  const int n=t->samples;
+  const int width=t->width;
+  const float top=high-bias;
+  const float limit=(float)bottom;
+  gint *out=t->y_detector[detector];
+  for(c=0;c<width;c++) {
+    float v;
+    if(n>width) {
+      v=samples[t->first[c]];
+      if(detector==TRACE_DETECTOR_MIN) {
+        for(i=t->first[c]+1;i<=t->last[c];i++) v=samples[i]<v?samples[i]:v;
+      } else {
+        for(i=t->first[c]+1;i<=t->last[c];i++) v=samples[i]>v?samples[i]:v;
+      }
+    } else {
+      float a=samples[t->first[c]];
+      float b=samples[t->last[c]];
+      v=a+(b-a)*t->frac[c];
+    }
+    float y=(top-v)*dbm_per_line;
+    y=y<0.0f?0.0f:(y>limit?limit:y);
+    out[c]=(int)y;
+  }
+  t->detectors|=1<<detector;
+}
+
+// fill colour for each row, only rebuilt when the height or the S9 level
+// (which moves with the band and the display range) changes
+void panadapter_trace_colours(PANADAPTER_TRACE *t,int rows,float s9,gboolean gradient) {
+  struct {
+    double t;
+    double r, g, b, a;
+  } stops[] = {
+    {0.0, 0.0, 0.0, 0.5, 0.5},                // Dark blue
+    {s9 / 3.0, 0.0, 0.8, 0.6, 0.5},           // Green/cyan
+    {(s9 / 3.0) * 2.0, 1.0, 1.0, 0.0, 0.5},   // Yellow
+    {s9, 1.0, 0.0, 0.0, 0.5}                  // Red
+  };
+  int num_stops=sizeof(stops)/sizeof(stops[0]);
+  int y, s;
+
+  if(rows==t->rows && s9==t->s9 && gradient==t->gradient) return;
+  if(rows>t->rows) {
+    g_free(t->colour);
+    t->colour=g_new(guint32,rows>0?rows:1);
+  }
+  t->rows=rows;
+  t->s9=s9;
+  t->gradient=gradient;
+  t->colour_serial++;
+
+  for(y=0;y<rows;y++) {
+    if(!gradient) {
+      t->colour[y]=0x80FFFFFF;
+      continue;
+    }
+    double gradient_t=1.0-((double)y/(double)rows);
+    if(gradient_t<0.0) gradient_t=0.0;
+    if(gradient_t>1.0) gradient_t=1.0;
+
+    double r=0.0, g=0.0, b=0.0, a=0.5;
+    for(s=0;s<num_stops-1;s++) {
+      if(gradient_t>=stops[s].t && gradient_t<=stops[s+1].t) {
+        double t_norm=(gradient_t-stops[s].t)/(stops[s+1].t-stops[s].t);
+        r=(1.0-t_norm)*stops[s].r+t_norm*stops[s+1].r;
+        g=(1.0-t_norm)*stops[s].g+t_norm*stops[s+1].g;
+        b=(1.0-t_norm)*stops[s].b+t_norm*stops[s+1].b;
+        a=(1.0-t_norm)*stops[s].a+t_norm*stops[s+1].a;
+        break;
+      }
+    }
+    if(gradient_t>=stops[num_stops-1].t) {
+      r=stops[num_stops-1].r;
+      g=stops[num_stops-1].g;
+      b=stops[num_stops-1].b;
+      a=stops[num_stops-1].a;
+    }
+    t->colour[y]=((guint32)(a*255)<<24)|((guint32)(r*255)<<16)|((guint32)(g*255)<<8)|(guint32)(b*255);
+  }
+}
+
+// one pixel wide line, each column joined to the previous one; 'low' is
+// the bottom of the min/max envelope
+static void trace_line(const PANADAPTER_TRACE *t,const gint *y,const gint *low,unsigned char *data,int stride,int rows,guint32 colour) {
+  int x, r;
+  for(x=0;x<t->width;x++) {
+    int top=y[x];
+    int bottom=low[x];
+    if(x>0) {
+      top=y[x-1]<top?y[x-1]:top;
+      bottom=y[x-1]>bottom?y[x-1]:bottom;
+    }
+    if(bottom>=rows) bottom=rows-1;
+    for(r=top;r<=bottom;r++) {
+      ((guint32 *)(data+r*stride))[x]=colour;
+    }
+  }
+}
+
+// rasterise into an ARGB32 buffer of at least t->width columns; every
+// pixel of the first t->width columns is written, no clear needed
+void panadapter_trace_render(PANADAPTER_TRACE *t,unsigned char *data,int stride,int rows,
+    gboolean filled,gboolean peak_hold,gboolean average) {
+  int x, y;
+
+  if(t->width<=0 || rows<=0) return;
+  if(rows>t->rows) rows=t->rows;
+
+  for(y=0;y<rows;y++) {
+    guint32 *p=(guint32 *)(data+y*stride);
+    if(filled) {
+      const guint32 c=t->colour[y];
+      const gint *top=t->y;
+      for(x=0;x<t->width;x++) {
+        p[x]=y>=top[x]?c:0;
+      }
+    } else {
+      memset(p,0,t->width*sizeof(guint32));
+    }
+  }
+
+  for(int k=0;k<TRACE_DETECTORS;k++) {
+    if(t->detectors&(1<<k)) trace_line(t,t->y_detector[k],t->y_detector[k],data,stride,rows,detector_colour[k]);
+  }
+  if(average) trace_line(t,t->y_average,t->y_average,data,stride,rows,TRACE_AVERAGE);
+  if(peak_hold) trace_line(t,t->y_peak,t->y_peak,data,stride,rows,TRACE_PEAK);
+  trace_line(t,t->y,t->y_min,data,stride,rows,TRACE_OUTLINE);
+}
+
+static gfloat *vertex(TRACE_VERTICES *v,float x,float y) {
+  gfloat *p=v->xy+2*v->count++;
+  p[0]=x;
+  p[1]=y;
+  return p;
+}
+
+static void batch(TRACE_VERTICES *v,int type,int first,guint32 colour) {
+  TRACE_BATCH *b=&v->batch[v->batches++];
+  b->type=type;
+  b->first=first;
+  b->count=v->count-first;
+  b->colour=colour;
+}
+
+static void strip(const PANADAPTER_TRACE *t,TRACE_VERTICES *v,const gint *y,guint32 colour) {
+  int first=v->count;
+  for(int x=0;x<t->width;x++) {
+    vertex(v,(float)x+0.5f,(float)y[x]+0.5f);
+  }
+  batch(v,TRACE_BATCH_STRIP,first,colour);
+}
+
+// Same layers, order and colours as panadapter_trace_render, as vertices
+void panadapter_trace_vertices(PANADAPTER_TRACE *t,TRACE_VERTICES *v,int rows,
+    gboolean filled,gboolean peak_hold,gboolean average) {
+  int x, k;
+  int needed=t->width*(4+4+TRACE_DETECTORS);
+
+  v->count=0;
+  v->batches=0;
+  v->rows=rows;
+  if(t->width<=0 || rows<=0) return;
+  if(needed>v->size) {
+    g_free(v->xy);
+    v->xy=g_new(gfloat,2*needed);
+    v->size=needed;
+  }
+  if(t->colour!=NULL && t->rows>0 && (t->colour_serial!=v->colour_serial || v->colour==NULL)) {
+    if(t->rows>v->colour_size) {
+      g_free(v->colour);
+      v->colour=g_new(guint32,t->rows);
+      v->colour_size=t->rows;
+    }
+    memcpy(v->colour,t->colour,t->rows*sizeof(guint32));
+    v->colour_rows=t->rows;
+    v->colour_serial=t->colour_serial;
+  }
+
+  if(filled) {
+    int first=v->count;
+    for(x=0;x<t->width;x++) {
+      vertex(v,(float)x+0.5f,(float)t->y[x]);
+      vertex(v,(float)x+0.5f,(float)rows);
+    }
+    batch(v,TRACE_BATCH_FILL,first,0);
+  }
+  for(k=0;k<TRACE_DETECTORS;k++) {
+    if(t->detectors&(1<<k)) strip(t,v,t->y_detector[k],detector_colour[k]);
+  }
+  if(average) strip(t,v,t->y_average,TRACE_AVERAGE);
+  if(peak_hold) strip(t,v,t->y_peak,TRACE_PEAK);
+  strip(t,v,t->y,TRACE_OUTLINE);
+
+  // where decimating, the extent below the maximum
+  int first=v->count;
+  for(x=0;x<t->width;x++) {
+    if(t->y_min[x]>t->y[x]) {
+      vertex(v,(float)x+0.5f,(float)t->y[x]+0.5f);
+      vertex(v,(float)x+0.5f,(float)t->y_min[x]+1.0f);
+    }
+  }
+  if(v->count>first) batch(v,TRACE_BATCH_SEGMENTS,first,TRACE_OUTLINE);
+}
+
+void trace_vertices_free(TRACE_VERTICES *v) {
+  g_free(v->xy);
+  g_free(v->colour);
+  memset(v,0,sizeof(TRACE_VERTICES));
+}
@@ -0,0 +1,96 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _PANADAPTER_TRACE_H
+#define _PANADAPTER_TRACE_H
+
+#define TRACE_PEAK_DECAY 10.0      // dB per second
+#define TRACE_AVERAGE_MULT 0.1f
+#define TRACE_DETECTORS 3          // overlays, in DISPLAY_DETECTOR_ order
+#define TRACE_DETECTOR_MIN 2
+
+typedef struct _panadapter_trace {
+  gint width;             // columns the tables were built for
+  gint samples;           // input samples the tables were built for
+  gint size;              // allocated columns
+  gint *first;            // per column: first input sample
+  gint *last;             // per column: last input sample (decimating)
+  gfloat *frac;           // per column: interpolation weight (resampling)
+  gfloat *db;             // per column level, the maximum when decimating
+  gfloat *db_min;         // per column minimum when decimating
+  gfloat *peak;           // peak hold (dB)
+  gfloat *average;        // averaged trace (dB)
+  gint *y;                // screen rows of the above
+  gint *y_min;
+  gint *y_peak;
+  gint *y_average;
+  gint *y_detector[TRACE_DETECTORS]; // screen rows of the detector overlays
+  gint detectors;         // overlays updated for this frame, bit per detector
+  gboolean history;       // peak and average hold valid data
+
+  gint rows;              // fill colours are built for this height
+  gint gradient;
+  gfloat s9;
+  guint32 *colour;        // fill colour per row
+  guint colour_serial;    // bumped when the fill colours change
+} PANADAPTER_TRACE;
+
+// The trace as vertices for a GPU renderer, in pixel coordinates with the
+// origin at the top left. The fill is a triangle strip down to the bottom
+// of the plot, coloured per row from the fill colours.
+#define TRACE_BATCH_FILL 0
+#define TRACE_BATCH_STRIP 1        // line strip
+#define TRACE_BATCH_SEGMENTS 2     // separate lines, the min/max envelope
+#define TRACE_BATCHES (4+TRACE_DETECTORS)
+
+typedef struct _trace_batch {
+  gint type;
+  gint first;             // vertex
+  gint count;
+  guint32 colour;         // premultiplied ARGB, unused by the fill
+} TRACE_BATCH;
+
+typedef struct _trace_vertices {
+  gfloat *xy;
+  gint size;              // allocated vertices
+  gint count;
+  TRACE_BATCH batch[TRACE_BATCHES];
+  gint batches;
+  gint rows;              // plot height
+  guint32 *colour;        // copy of the fill colours
+  gint colour_rows;
+  gint colour_size;
+  guint colour_serial;
+} TRACE_VERTICES;
+
+extern PANADAPTER_TRACE *create_panadapter_trace(void);
+extern void destroy_panadapter_trace(PANADAPTER_TRACE *t);
+extern void panadapter_trace_reset(PANADAPTER_TRACE *t);
+extern void panadapter_trace_update(PANADAPTER_TRACE *t,const float *samples,int n,int width,
+    float bias,float high,float dbm_per_line,int bottom,float peak_decay);
+extern void panadapter_trace_detector(PANADAPTER_TRACE *t,int detector,const float *samples,
+    float bias,float high,float dbm_per_line,int bottom);
+extern void panadapter_trace_colours(PANADAPTER_TRACE *t,int rows,float s9,gboolean gradient);
+extern void panadapter_trace_render(PANADAPTER_TRACE *t,unsigned char *data,int stride,int rows,
+    gboolean filled,gboolean peak_hold,gboolean average);
+extern void panadapter_trace_vertices(PANADAPTER_TRACE *t,TRACE_VERTICES *v,int rows,
+    gboolean filled,gboolean peak_hold,gboolean average);
+extern void trace_vertices_free(TRACE_VERTICES *v);
+
+#endif
@@ -994,15 +994,8 @@ void protocol1_process_local_mic(RADIO *r) {
 }
 
 static void process_wideband_buffer(unsigned char  *buffer) {
-  int i;
-  short sample;
-  double sampledouble;
-  for(i=0;i<512;i+=2) {
-    sample = (short) ((buffer[i + 1] << 8) + (buffer[i] & 0xFF));
-    sampledouble=(double)sample/32767.0;
-    if(radio->wideband!=NULL) {
-      add_wideband_sample(radio->wideband, sampledouble);
-    }
+  if(radio->wideband!=NULL) {
+    add_wideband_samples(radio->wideband, buffer, 256, FALSE);
   }
 }
 
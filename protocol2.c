@@ -1341,23 +1341,8 @@ static void process_ps_iq_data(RECEIVER *rx) {
 #endif
 
 static void process_wideband_data(WIDEBAND *w,unsigned char *buffer) {
-  //long sequence; // UNUSED
-  int b;
-  int sample;
-  double sampledouble;
-  //unsigned char *buffer;
-
-  //buffer=wide_buffer;
-
-
-  //sequence=((buffer[0]&0xFF)<<24)+((buffer[1]&0xFF)<<16)+((buffer[2]&0xFF)<<8)+(buffer[3]&0xFF); // UNUSED
-  b=4;
-  while(b<1028) {
-    sample   = (int)((signed char) buffer[b++])<<8;
-    sample  |= (int)((unsigned char)buffer[b++]&0xFF);
-    sampledouble=(double)sample/32767.0; // for 16 bits
-    add_wideband_sample(w, sampledouble);
-  }
+  // 4 byte sequence number then 512 16 bit samples
+  add_wideband_samples(w, &buffer[4], 512, TRUE);
 }
 
 static void process_command_response(unsigned char *buffer) {
@@ -0,0 +1,104 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+//
+// Replays PureSignal captures through the correction fit and prints the
+// time per iteration:
+//
+//   ps_bench [-n iterations] capture...
+//   ps_bench -g capture
+//
+// Captures are saved from the PS dialog ("Save Capture"). -g writes a
+// synthetic one, a two tone through a compressing amplifier, with the
+// default 16 intervals of 256 samples, for use without a radio.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <wdsp.h>
+
+#define SYNTH_INTS 16
+#define SYNTH_SPI 256
+#define SYNTH_PIN_SAMPLES 256
+#define SYNTH_HW_SCALE (1.0/0.4072)
+#define SYNTH_PTOL 0.8
+
+static int write_synthetic(const char *filename) {
+  int i;
+  int n=SYNTH_INTS*SYNTH_SPI;
+  FILE *f=fopen(filename,"w");
+  if(f==NULL) return -1;
+  fprintf(f,"%d %d %d %d %.17e %.17e\n",SYNTH_INTS,SYNTH_SPI,SYNTH_PIN_SAMPLES,1,SYNTH_HW_SCALE,SYNTH_PTOL);
+  srand(1);
+  for(i=0;i<n;i++) {
+    // spread the samples over the whole envelope, as the collector does
+    double env=((double)i+0.5)/(double)n/SYNTH_HW_SCALE;
+    double phase=2.0*M_PI*(double)rand()/(double)RAND_MAX;
+    double gain=tanh(1.6*env*SYNTH_HW_SCALE)/(1.6*env*SYNTH_HW_SCALE);
+    double rotate=0.3*env*env*SYNTH_HW_SCALE*SYNTH_HW_SCALE;
+    double noise=1.0e-4*((double)rand()/(double)RAND_MAX-0.5);
+    fprintf(f,"%.17e\t%.17e\t%.17e\t%.17e\n",
+        env*cos(phase),env*sin(phase),
+        (0.4*gain*env+noise)*cos(phase+rotate),(0.4*gain*env+noise)*sin(phase+rotate));
+  }
+  fclose(f);
+  return 0;
+}
+
+int main(int argc,char **argv) {
+  int iterations=200;
+  int opt;
+  int i;
+  int result=0;
+  double min, avg;
+
+  while((opt=getopt(argc,argv,"n:g:"))!=-1) {
+    switch(opt) {
+      case 'n': iterations=atoi(optarg); break;
+      case 'g':
+        if(write_synthetic(optarg)!=0) {
+          perror(optarg);
+          return 1;
+        }
+        return 0;
+      default:
+        fprintf(stderr,"usage: %s [-n iterations] capture...\n       %s -g capture\n",argv[0],argv[0]);
+        return 1;
+    }
+  }
+  if(optind>=argc || iterations<1) {
+    fprintf(stderr,"usage: %s [-n iterations] capture...\n       %s -g capture\n",argv[0],argv[0]);
+    return 1;
+  }
+
+  for(i=optind;i<argc;i++) {
+    int ok=PSBenchCapture(argv[i],iterations,&min,&avg);
+    if(ok<0) {
+      fprintf(stderr,"%s: not a PureSignal capture\n",argv[i]);
+      result=1;
+      continue;
+    }
+    printf("%s: %d iterations, min %.3f ms, avg %.3f ms%s\n",argv[i],iterations,min/1000.0,avg/1000.0,
+        ok?"":" (fit rejected)");
+  }
+  return result;
+}
@@ -245,6 +245,16 @@ static void twotone_cb(GtkWidget *widget, gpointer data) {
   }
 }
 
+static void capture_cb(GtkWidget *widget, gpointer data) {
+  TRANSMITTER *tx=(TRANSMITTER *)data;
+  char id[32];
+  char filename[256];
+  // replay it with ps_bench
+  radio_id(radio,id,sizeof(id));
+  sprintf(filename,"%s/.local/share/linhpsdr/%s-ps.capture",g_get_home_dir(),id);
+  PSSaveCapture(tx->channel,filename);
+}
+
 
 GtkWidget *create_puresignal_dialog(TRANSMITTER *tx) {
   GtkWidget *grid=gtk_grid_new();
@@ -273,6 +283,10 @@ GtkWidget *create_puresignal_dialog(TRANSMITTER *tx) {
   g_signal_connect(twotone_b,"toggled",G_CALLBACK(twotone_cb),tx);
   gtk_grid_attach(GTK_GRID(ps_grid),twotone_b,1,0,1,1);
 
+  GtkWidget *capture_b=gtk_button_new_with_label("Save Capture");
+  g_signal_connect(capture_b,"clicked",G_CALLBACK(capture_cb),tx);
+  gtk_grid_attach(GTK_GRID(ps_grid),capture_b,2,0,1,1);
+
   tx->ps=gtk_drawing_area_new();
   g_signal_connect (tx->ps,"configure-event",G_CALLBACK(ps_configure_event_cb),(gpointer)tx);
   g_signal_connect (tx->ps,"draw",G_CALLBACK(ps_draw_cb),(gpointer)tx);
@@ -60,6 +60,12 @@
 //#include "rigctl.h"
 #include "receiver_dialog.h"
 #include "subrx.h"
+#include "panadapter_trace.h"
+#include "display_renderer.h"
+#include "display_tick.h"
+#include "spectrum_history.h"
+#include "spectrum_frame.h"
+#include "spectrum_server.h"
 
 #ifdef MIDI
 #include "midi.h"
@@ -123,33 +129,39 @@ fprintf(stderr,"radio_start\n");
   return 0;
 }
 
-void radio_save_state(RADIO *radio) {
-  char name[80];
-  char value[80];
-  int i;
-  gint x,y;
-  gint width,height;
-  char filename[128];
-  switch(radio->discovered->protocol) {
-    
+//
+// Names the radio's files in ~/.local/share/linhpsdr: the MAC address of a
+// network radio, the device name of a SoapySDR one.
+//
+void radio_id(RADIO *r,char *id,size_t size) {
+  switch(r->discovered->protocol) {
 #ifdef SOAPYSDR
     case PROTOCOL_SOAPYSDR:
-      sprintf(filename,"%s/.local/share/linhpsdr/%s.props",
-                        g_get_home_dir(),
-                        radio->discovered->name);
+      g_snprintf(id,size,"%s",r->discovered->name);
       break;
 #endif
     default:
-      sprintf(filename,"%s/.local/share/linhpsdr/%02X-%02X-%02X-%02X-%02X-%02X.props",
-                        g_get_home_dir(),
-                        radio->discovered->info.network.mac_address[0],
-                        radio->discovered->info.network.mac_address[1],
-                        radio->discovered->info.network.mac_address[2],
-                        radio->discovered->info.network.mac_address[3],
-                        radio->discovered->info.network.mac_address[4],
-                        radio->discovered->info.network.mac_address[5]);
+      g_snprintf(id,size,"%02X-%02X-%02X-%02X-%02X-%02X",
+                 r->discovered->info.network.mac_address[0],
+                 r->discovered->info.network.mac_address[1],
+                 r->discovered->info.network.mac_address[2],
+                 r->discovered->info.network.mac_address[3],
+                 r->discovered->info.network.mac_address[4],
+                 r->discovered->info.network.mac_address[5]);
       break;
   }
+}
+
+void radio_save_state(RADIO *radio) {
+  char name[80];
+  char value[80];
+  int i;
+  gint x,y;
+  gint width,height;
+  char filename[128];
+  char id[80];
+  radio_id(radio,id,sizeof(id));
+  sprintf(filename,"%s/.local/share/linhpsdr/%s.props",g_get_home_dir(),id);
 
 g_print("radio_save_state: %s\n",filename);
   initProperties();
@@ -273,6 +285,16 @@ g_print("radio_save_state: %s\n",filename);
   sprintf(value,"%d",radio->iqswap);
   setProperty("radio.iqswap",value);
 
+  sprintf(value,"%d",radio->shared_analyzer);
+  setProperty("radio.shared_analyzer",value);
+
+  sprintf(value,"%d",radio->spectrum_server);
+  setProperty("radio.spectrum_server",value);
+  sprintf(value,"%d",radio->spectrum_server_port);
+  setProperty("radio.spectrum_server_port",value);
+  sprintf(value,"%d",radio->display_renderer);
+  setProperty("radio.display_renderer",value);
+
   sprintf(value,"%d",radio->which_audio);
   setProperty("radio.which_audio",value);
 
@@ -327,25 +349,9 @@ void radio_restore_state(RADIO *radio) {
   char name[80];
   char *value;
   char filename[128];
-  switch(radio->discovered->protocol) {
-#ifdef SOAPYSDR
-    case PROTOCOL_SOAPYSDR:
-      sprintf(filename,"%s/.local/share/linhpsdr/%s.props",
-                        g_get_home_dir(),
-                        radio->discovered->name);
-      break;
-#endif
-    default:
-      sprintf(filename,"%s/.local/share/linhpsdr/%02X-%02X-%02X-%02X-%02X-%02X.props",
-                        g_get_home_dir(),
-                        radio->discovered->info.network.mac_address[0],
-                        radio->discovered->info.network.mac_address[1],
-                        radio->discovered->info.network.mac_address[2],
-                        radio->discovered->info.network.mac_address[3],
-                        radio->discovered->info.network.mac_address[4],
-                        radio->discovered->info.network.mac_address[5]);
-      break;
-  }
+  char id[80];
+  radio_id(radio,id,sizeof(id));
+  sprintf(filename,"%s/.local/share/linhpsdr/%s.props",g_get_home_dir(),id);
 
   loadProperties(filename);
 
@@ -458,6 +464,16 @@ void radio_restore_state(RADIO *radio) {
   value=getProperty("radio.iqswap");
   if(value) radio->iqswap=atoi(value);
 
+  value=getProperty("radio.shared_analyzer");
+  if(value) radio->shared_analyzer=atoi(value);
+
+  value=getProperty("radio.spectrum_server");
+  if(value) radio->spectrum_server=atoi(value);
+  value=getProperty("radio.spectrum_server_port");
+  if(value) radio->spectrum_server_port=atoi(value);
+  value=getProperty("radio.display_renderer");
+  if(value) radio->display_renderer=atoi(value);
+
   value=getProperty("radio.which_audio");
   if(value) radio->which_audio=atoi(value);
 
@@ -690,12 +706,6 @@ void delete_receiver(RECEIVER *rx) {
         }
     }
 
-    // Stop update timer
-    if (rx->update_timer_id) {
-        g_source_remove(rx->update_timer_id);
-        rx->update_timer_id = 0;
-    }
-
     // Signal threads to stop
     ReceiverThreadContext *ctx = &rx->thread_context;
     ctx->running = FALSE;
@@ -716,9 +726,9 @@ void delete_receiver(RECEIVER *rx) {
         ctx->wdsp_thread = NULL;
     }
     if (ctx->render_thread) {
-        //if (!g_thread_join_timeout(ctx->render_thread, 0.1)) {
-        //    fprintf(stderr, "delete_receiver: render_thread (channel=%d) did not terminate\n", ch);
-        //}
+        // The render thread draws into the receiver's surfaces, so it must
+        // be finished before they are freed. It never waits on the main loop.
+        g_thread_join(ctx->render_thread);
         ctx->render_thread = NULL;
     }
 
@@ -735,6 +745,7 @@ void delete_receiver(RECEIVER *rx) {
         ctx->render_queue = NULL;
     }
     g_mutex_clear(&ctx->render_mutex);
+    g_mutex_clear(&ctx->frame_mutex);
 
     // Free ring buffer with mutex protection
     g_mutex_lock(&rx->iq_ring_buffer.mutex);
@@ -750,6 +761,35 @@ void delete_receiver(RECEIVER *rx) {
         g_free(rx->pixel_samples);
         rx->pixel_samples = NULL;
     }
+    triple_buffer_free(&rx->display_buffer);
+    triple_buffer_free(&rx->waterfall_buffer);
+    waterfall_stream_free(&rx->waterfall_stream);
+    rx->display_samples = NULL;
+    if (rx->analyzer_plan) {
+        g_free(rx->analyzer_plan);
+        rx->analyzer_plan = NULL;
+    }
+    deep_zoom_destroy(rx->deep_zoom_ddc);
+    rx->deep_zoom_ddc = NULL;
+    if (rx->panadapter_trace) {
+        destroy_panadapter_trace(rx->panadapter_trace);
+        rx->panadapter_trace = NULL;
+    }
+    if (rx->renderer != NULL && rx->renderer->release != NULL) {
+        rx->renderer->release(rx);
+    }
+    if (rx->spectrum_history) {
+        destroy_spectrum_history(rx->spectrum_history);
+        rx->spectrum_history = NULL;
+    }
+    if (rx->waterfall_line) {
+        g_free(rx->waterfall_line);
+        rx->waterfall_line = NULL;
+    }
+    if (rx->waterfall_colormap) {
+        g_free(rx->waterfall_colormap);
+        rx->waterfall_colormap = NULL;
+    }
     if (rx->iq_input_buffer) {
         g_free(rx->iq_input_buffer);
         rx->iq_input_buffer = NULL;
@@ -1457,6 +1497,10 @@ g_print("create_radio for %s %d\n",d->name,d->device);
   #endif
   
   r->display_filled=TRUE;
+  r->shared_analyzer=FALSE;
+  r->spectrum_server=FALSE;
+  r->spectrum_server_port=SPECTRUM_SERVER_PORT;
+  r->display_renderer=DISPLAY_RENDERER_AUTO;
 
   r->mic_boost=FALSE;
   r->mic_ptt_enabled=FALSE;
@@ -1559,6 +1603,13 @@ g_print("create_radio for %s %d\n",d->name,d->device);
 
   radio_change_region(r);
 
+  if(r->spectrum_server) {
+    spectrum_server_start(r->spectrum_server_port);
+  }
+
+  // before any receiver window is created
+  display_renderer_select(r->display_renderer);
+
 #ifdef SOAPYSDR
   if(r->discovered->protocol==PROTOCOL_SOAPYSDR) {
     soapy_protocol_init(r,0);
@@ -1584,6 +1635,8 @@ g_print("create_radio for %s %d\n",d->name,d->device);
 #endif
   }
 
+  // one timer refreshes every display from here on
+  display_tick_start();
 
   create_visual(r);
 
@@ -181,6 +181,10 @@ typedef struct _radio {
   gboolean psu_clk;
 
   gboolean display_filled;
+  gboolean shared_analyzer;     // receivers with the same IQ share one display FFT
+  gboolean spectrum_server;     // stream spectrum frames to remote displays
+  gint spectrum_server_port;
+  gint display_renderer;        // DISPLAY_RENDERER_ preference, used at startup
 
   GtkWidget *visual;
   GtkWidget *mox_button;
@@ -226,6 +230,7 @@ extern void delete_receiver(RECEIVER *rx);
 extern void frequency_changed(RECEIVER *rx);
 extern void add_receivers(RADIO *r);
 extern void add_transmitter(RADIO *r);
+extern void radio_id(RADIO *r,char *id,size_t size);
 extern void radio_save_state(RADIO *radio);
 extern void radio_restore_state(RADIO *radio);
 extern void delete_wideband(WIDEBAND *w);
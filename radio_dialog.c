@@ -42,6 +42,9 @@
 #endif
 #include "audio.h"
 #include "receiver_dialog.h"
+#include "spectrum_frame.h"
+#include "spectrum_server.h"
+#include "display_renderer.h"
 //#include "rigctl.h"
 
 #ifdef CWDAEMON
@@ -521,6 +524,40 @@ static void iqswap_changed_cb(GtkWidget *widget, gpointer data) {
   r->iqswap=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
 }
 
+static void shared_analyzer_changed_cb(GtkWidget *widget, gpointer data) {
+  RADIO *r=(RADIO *)data;
+  r->shared_analyzer=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+}
+
+static void spectrum_server_changed_cb(GtkWidget *widget, gpointer data) {
+  RADIO *r=(RADIO *)data;
+  r->spectrum_server=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+  if(r->spectrum_server) {
+    if(!spectrum_server_start(r->spectrum_server_port)) {
+      r->spectrum_server=FALSE;
+      gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widget),FALSE);
+    }
+  } else {
+    spectrum_server_stop();
+  }
+}
+
+static void spectrum_server_port_changed_cb(GtkWidget *widget, gpointer data) {
+  RADIO *r=(RADIO *)data;
+  r->spectrum_server_port=gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget));
+  if(spectrum_server_running()) {
+    // rebind on the new port
+    spectrum_server_stop();
+    spectrum_server_start(r->spectrum_server_port);
+  }
+}
+
+static void display_renderer_changed_cb(GtkWidget *widget, gpointer data) {
+  RADIO *r=(RADIO *)data;
+  // picked when the radio starts
+  r->display_renderer=gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+}
+
 static void enablepa_changed_cb(GtkWidget *widget, gpointer data) {
   RADIO *r=(RADIO *)data;
   r->enable_pa=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
@@ -710,6 +747,12 @@ GtkWidget *create_radio_dialog(RADIO *radio) {
   }
 #endif
 
+  GtkWidget *shared_analyzer=gtk_check_button_new_with_label("Shared Analyzer");
+  gtk_grid_attach(GTK_GRID(model_grid),shared_analyzer,x,0,1,1);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(shared_analyzer),radio->shared_analyzer);
+  g_signal_connect(shared_analyzer,"toggled",G_CALLBACK(shared_analyzer_changed_cb),radio);
+  x++;
+
   if(radio->discovered->protocol==PROTOCOL_1) {
     GtkWidget *sample_rate_combo_box=gtk_combo_box_text_new();
     gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(sample_rate_combo_box),NULL,"48000");
@@ -1095,6 +1138,29 @@ GtkWidget *create_radio_dialog(RADIO *radio) {
 
 #endif
 
+  GtkWidget *spectrum_server_b=gtk_check_button_new_with_label("Spectrum Server");
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(spectrum_server_b),radio->spectrum_server);
+  gtk_grid_attach(GTK_GRID(config_grid),spectrum_server_b,0,1,1,1);
+  g_signal_connect(spectrum_server_b,"toggled",G_CALLBACK(spectrum_server_changed_cb),radio);
+
+  GtkWidget *spectrum_server_port_b=gtk_spin_button_new_with_range(1024.0, 65535.0, 1.0);
+  gtk_spin_button_set_value(GTK_SPIN_BUTTON(spectrum_server_port_b), (double)radio->spectrum_server_port);
+  gtk_grid_attach(GTK_GRID(config_grid),spectrum_server_port_b,1,1,1,1);
+  g_signal_connect(spectrum_server_port_b,"value_changed",G_CALLBACK(spectrum_server_port_changed_cb),radio);
+
+  GtkWidget *display_renderer_label=gtk_label_new("Display (restart):");
+  gtk_grid_attach(GTK_GRID(config_grid),display_renderer_label,0,2,1,1);
+
+  GtkWidget *display_renderer_b=gtk_combo_box_text_new();
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(display_renderer_b),NULL,"Auto");
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(display_renderer_b),NULL,"Cairo");
+#ifdef OPENGL
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(display_renderer_b),NULL,"OpenGL");
+#endif
+  gtk_combo_box_set_active(GTK_COMBO_BOX(display_renderer_b),radio->display_renderer);
+  gtk_grid_attach(GTK_GRID(config_grid),display_renderer_b,1,2,1,1);
+  g_signal_connect(display_renderer_b,"changed",G_CALLBACK(display_renderer_changed_cb),radio);
+
   
   
   GtkWidget *audio_frame=gtk_frame_new("Audio");
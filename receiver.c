@@ -50,6 +50,8 @@
 #include "rx_panadapter.h"
 #include "tx_panadapter.h"
 #include "waterfall.h"
+#include "colormap.h"
+#include "analyzer_policy.h"
 #include "protocol1.h"
 #include "protocol2.h"
 #ifdef SOAPYSDR
@@ -61,6 +63,12 @@
 #include "property.h"
 #include "rigctl.h"
 #include "subrx.h"
+#include "shared_analyzer.h"
+#include "spectrum_server.h"
+#include "display_renderer.h"
+
+// Analyzer bins per pixel of the full (zoomed) span
+#define RX_BINS_PER_PIXEL 2.0
 
 // Metadata for savable fields
 typedef enum {
@@ -91,16 +99,26 @@ static const FieldDescriptor receiver_fields[] = {
     {"low_latency", TYPE_INT, OFFSET(low_latency), 0},
     {"fps", TYPE_INT, OFFSET(fps), 0},
     {"display_average_time", TYPE_DOUBLE, OFFSET(display_average_time), 0},
+    {"analyzer_rbw", TYPE_DOUBLE, OFFSET(analyzer_rbw), 0},
+    {"deep_zoom", TYPE_INT, OFFSET(deep_zoom), 0},
     {"panadapter_low", TYPE_INT, OFFSET(panadapter_low), 0},
     {"panadapter_high", TYPE_INT, OFFSET(panadapter_high), 0},
     {"panadapter_step", TYPE_INT, OFFSET(panadapter_step), 0},
     {"panadapter_filled", TYPE_INT, OFFSET(panadapter_filled), 0},
     {"panadapter_gradient", TYPE_INT, OFFSET(panadapter_gradient), 0},
     {"panadapter_agc_line", TYPE_INT, OFFSET(panadapter_agc_line), 0},
+    {"panadapter_peak_hold", TYPE_INT, OFFSET(panadapter_peak_hold), 0},
+    {"panadapter_average", TYPE_INT, OFFSET(panadapter_average), 0},
+    {"display_detectors", TYPE_INT, OFFSET(display_detectors), 0},
     {"waterfall_low", TYPE_INT, OFFSET(waterfall_low), 1}, // Conditional
     {"waterfall_high", TYPE_INT, OFFSET(waterfall_high), 1}, // Conditional
     {"waterfall_automatic", TYPE_INT, OFFSET(waterfall_automatic), 0},
     {"waterfall_ft8_marker", TYPE_INT, OFFSET(waterfall_ft8_marker), 0},
+    {"waterfall_palette", TYPE_INT, OFFSET(waterfall_palette), 0},
+    {"waterfall_subsample", TYPE_INT, OFFSET(waterfall_subsample), 0},
+    {"waterfall_rate", TYPE_INT, OFFSET(waterfall_rate), 0},
+    {"waterfall_combine", TYPE_INT, OFFSET(waterfall_combine), 0},
+    {"waterfall_history", TYPE_INT, OFFSET(waterfall_history), 0},
     {"frequency_a", TYPE_INT64, OFFSET(frequency_a), 0},
     {"lo_a", TYPE_INT64, OFFSET(lo_a), 0},
     {"error_a", TYPE_INT64, OFFSET(error_a), 0},
@@ -183,18 +201,32 @@ static void full_rx_buffer(RECEIVER *rx);
 
 static gpointer render_processing_thread(gpointer data);
 
+static void receiver_set_analyzer(RECEIVER *rx);
+static void receiver_set_deep_zoom(RECEIVER *rx);
+static double receiver_deep_zoom_offset(RECEIVER *rx);
+
+//
+// The render thread rasterises the panadapter into its back buffer and the
+// waterfall into its pixbuf ring. The main thread only gets a present
+// callback which queues the redraws that blit the finished frames.
+//
 static gboolean update_display_cb(gpointer data) {
     RECEIVER *rx = (RECEIVER *)data;
     ReceiverThreadContext *ctx = &rx->thread_context;
 
-    g_mutex_lock(&ctx->render_mutex);
+    frame_pacer_presented(&ctx->pacer);
 
     // If widgets are already destroyed, bail early
     if (!GTK_IS_WIDGET(rx->panadapter) || !GTK_IS_WIDGET(rx->waterfall)) {
-        g_mutex_unlock(&ctx->render_mutex);
         return FALSE;
     }
 
+    gtk_widget_queue_draw(rx->panadapter);
+    gtk_widget_queue_draw(rx->waterfall);
+    return FALSE; // Run once
+}
+
+static gboolean receiver_protocol_running(void) {
     gboolean protocol_running = FALSE;
     switch (radio->discovered->protocol) {
         case PROTOCOL_1:
@@ -209,17 +241,32 @@ static gboolean update_display_cb(gpointer data) {
             break;
 #endif
     }
+    return protocol_running;
+}
 
-    update_rx_panadapter(rx, protocol_running);
-    update_waterfall(rx);
-
-    gtk_widget_queue_draw(rx->panadapter);
-    gtk_widget_queue_draw(rx->waterfall);
+// Take the latest analyzer frame published by the update timer. The
+// render thread never takes rx->mutex, which full_rx_buffer holds across
+// a whole DSP block.
+static gboolean take_display_samples(RECEIVER *rx) {
+    ReceiverThreadContext *ctx = &rx->thread_context;
 
-    g_mutex_unlock(&ctx->render_mutex);
-    return FALSE; // Run once
+    frame_pacer_take(&ctx->pacer);
+    // the wake up may have been for a waterfall line only
+    if (!triple_buffer_take(&rx->display_buffer)) return FALSE;
+    TRIPLE_BUFFER_SLOT *s = triple_buffer_front(&rx->display_buffer);
+    rx->display_samples = s->samples;
+    rx->display_samples_n = s->n;
+    rx->display_traces = s->traces;
+    return s->n > 0;
 }
 
+// The latest line from the waterfall stream, when it has its own rate
+static TRIPLE_BUFFER_SLOT *take_waterfall_line(RECEIVER *rx) {
+    waterfall_stream_take(&rx->waterfall_stream);
+    if (!triple_buffer_take(&rx->waterfall_buffer)) return NULL;
+    TRIPLE_BUFFER_SLOT *s = triple_buffer_front(&rx->waterfall_buffer);
+    return s->n > 0 ? s : NULL;
+}
 
 static gpointer render_processing_thread(gpointer data) {
     RECEIVER *rx = (RECEIVER *)data;
@@ -228,17 +275,35 @@ static gpointer render_processing_thread(gpointer data) {
         gpointer queue_data = g_async_queue_pop(ctx->render_queue);
         if (GPOINTER_TO_INT(queue_data) == -1) break;
 
+        // a wake up may carry a panadapter frame, a waterfall line or both
+        gboolean frame = take_display_samples(rx);
+        TRIPLE_BUFFER_SLOT *line = take_waterfall_line(rx);
+        if (!frame && line == NULL) continue;
+
+        gint64 start = g_get_monotonic_time();
         g_mutex_lock(&ctx->render_mutex);
-        //gboolean protocol_running = FALSE;
-        // Preprocess data (e.g., update rx->pixel_samples)
-        // Schedule GTK update in main thread
-        g_idle_add((GSourceFunc)update_display_cb, rx);
+        if (frame) {
+            update_rx_panadapter(rx, receiver_protocol_running());
+            if (rx->waterfall_rate == 0) {
+                update_waterfall(rx, rx->display_samples, rx->display_samples_n);
+            }
+        }
+        if (line != NULL) {
+            update_waterfall(rx, line->samples, line->n);
+        }
         g_mutex_unlock(&ctx->render_mutex);
+        if (frame) {
+            frame_pacer_rendered(&ctx->pacer, g_get_monotonic_time() - start, rx == radio->active_receiver);
+        }
+
+        // Schedule the blit in the main thread, one at a time
+        if (frame_pacer_ready(&ctx->pacer)) {
+            g_idle_add((GSourceFunc)update_display_cb, rx);
+        }
     }
     return NULL;
 }
 
-
 static void focus_in_event_cb(GtkWindow *window, GdkEventFocus *event, gpointer data) {
     if (event->in) {
         radio->active_receiver = (RECEIVER *)data;
@@ -566,10 +631,6 @@ static gboolean window_delete(GtkWidget *widget, GdkEvent *event, gpointer data)
     fprintf(stderr, "saving state for receiver");
     receiver_save_state(rx);
 
-    // Stop the update timer
-    g_source_remove(rx->update_timer_id);
-    rx->update_timer_id = 0;
-
     // Signal threads to exit
     ctx->running = FALSE;
 
@@ -927,23 +988,105 @@ gboolean receiver_scroll_event_cb(GtkWidget *widget, GdkEventScroll *event, gpoi
   return TRUE;
 }
         
-static gboolean update_timer_cb(void *data) {
-    int rc;
-    RECEIVER *rx = (RECEIVER *)data;
+// Number of extra analyzer outputs, one per DISPLAY_DETECTOR_ bit
+static int display_detector_count(RECEIVER *rx) {
+    int count = 0;
+    for (int k = 0; k < DISPLAY_DETECTORS; k++) {
+        if (rx->display_detectors & (1 << k)) count++;
+    }
+    return count;
+}
+
+double receiver_get_meter_db(RECEIVER *rx) {
+    return (double)g_atomic_int_get(&rx->meter_cdb) / 100.0;
+}
+
+//
+// Main thread, from the radio's display tick. Runs without rx->mutex:
+// GetPixelsMulti, SetAnalyzer and GetRXAMeter take WDSP's own locks,
+// pixel_samples is only touched on the main thread and frames reach the
+// render thread through display_buffer. Waiting here for a DSP block to
+// finish would stall the UI, and holding the DSP thread up behind the UI
+// would glitch the audio.
+//
+void receiver_display_request(RECEIVER *rx, DISPLAY_PIXELS *p, DISPLAY_REQUEST *req) {
+    ReceiverThreadContext *ctx = &rx->thread_context;
+    int n = rx->analyzer_pixels;
+    int k;
+
+    req->pixels = FALSE;
+    req->frame = FALSE;
+    req->first = -1;
+    if (isTransmitting(radio) && !rx->duplex) return;
+    if (rx->panadapter_resize_timer != -1 || rx->pixel_samples == NULL) return;
+
+    if (rx->pan != rx->analyzer_pan) {
+        // panned since the last frame, move the analyzer's clipped span,
+        // or with deep zoom retune the DDC to the new slice
+        if (rx->deep_zoom_ddc != NULL) {
+            deep_zoom_set_offset(rx->deep_zoom_ddc, receiver_deep_zoom_offset(rx));
+            rx->analyzer_pan = rx->pan;
+        } else {
+            receiver_set_analyzer(rx);
+        }
+    }
+    // a waterfall with its own rate takes every analyzer frame, also the
+    // ones the panadapter skips
+    req->frame = frame_pacer_tick(&ctx->pacer);
+    req->pixels = req->frame || rx->waterfall_rate > 0;
+    if (!req->pixels || g_atomic_int_get(&rx->shared_role) != SHARED_NONE) return;
+
+    req->first = display_pixels_request(p, rx->channel, 0, rx->pixel_samples);
+    if (req->frame && rx->display_detectors) {
+        // the detector outputs come from the same FFT and the same
+        // stitch() pass as output 0, so they are ready whenever it is
+        int outputs = 1 + display_detector_count(rx);
+        for (k = 1; k < outputs; k++) {
+            display_pixels_request(p, rx->channel, k, rx->pixel_samples + k * n);
+        }
+    }
+}
+
+void receiver_display_update(RECEIVER *rx, DISPLAY_PIXELS *p, DISPLAY_REQUEST *req) {
+    int rc = 0;
+    int traces = 1;
     ReceiverThreadContext *ctx = &rx->thread_context;
 
-    g_mutex_lock(&rx->mutex);
     if (!isTransmitting(radio) || (rx->duplex)) {
-        if (rx->panadapter_resize_timer == -1 && rx->pixel_samples != NULL) {
-            GetPixels(rx->channel, 0, rx->pixel_samples, &rc);
-            if (rc && g_async_queue_length(ctx->render_queue) < 3) { // Allow up to 3 tasks
-                if (ctx->render_queue && g_async_queue_length(ctx->render_queue) < 3) {
-    g_async_queue_push(ctx->render_queue, GINT_TO_POINTER(1));
-}
+        if (req->pixels) {
+            gboolean wake = FALSE;
+            if (g_atomic_int_get(&rx->shared_role) != SHARED_NONE) {
+                rc = shared_analyzer_pixels(rx, rx->pixel_samples);
+            } else {
+                rc = display_pixels_ready(p, req->first);
+                if (rc && req->frame) {
+                    // as many overlays as came with this frame
+                    while (traces < 1 + display_detector_count(rx) && display_pixels_ready(p, req->first + traces)) {
+                        traces++;
+                    }
+                }
+            }
+            if (rc && rx->waterfall_rate > 0 &&
+                waterfall_stream_add(&rx->waterfall_stream, rx->pixel_samples, rx->analyzer_pixels,
+                                     rx->waterfall_combine, rx->waterfall_rate, g_get_monotonic_time())) {
+                triple_buffer_publish(&rx->waterfall_buffer, rx->waterfall_stream.line, rx->waterfall_stream.n, 1);
+                wake = waterfall_stream_submit(&rx->waterfall_stream);
+            }
+            if (rc && req->frame) {
+                triple_buffer_publish(&rx->display_buffer, rx->pixel_samples, rx->analyzer_pixels, traces);
+                // latest wins: only wake the render thread if it has no frame yet
+                wake = frame_pacer_submit(&ctx->pacer) || wake;
+            }
+            if (wake) {
+                g_async_queue_push(ctx->render_queue, GINT_TO_POINTER(1));
             }
         }
         rx->meter_db = GetRXAMeter(rx->channel, rx->smeter) + radio->meter_calibration;
+        g_atomic_int_set(&rx->meter_cdb, (gint)(rx->meter_db * 100.0));
         update_meter(rx);
+        if (rc) {
+            spectrum_server_publish(rx);
+        }
     }
     update_radio_info(rx);
 
@@ -958,9 +1101,6 @@ static gboolean update_timer_cb(void *data) {
     if (radio->transmitter != NULL && !radio->transmitter->updated) {
         update_tx_panadapter(radio);
     }
-
-    g_mutex_unlock(&rx->mutex);
-    return TRUE;
 }
  
 static void set_mode(RECEIVER *rx,int m) {
@@ -998,18 +1138,42 @@ void calculate_display_average(RECEIVER *rx) {
   double display_avb;
   int display_average;
 
-  double t=0.001 * rx->display_average_time;
-  
-  display_avb = exp(-1.0 / ((double)rx->fps * t));
-  display_average = max(2, (int)fmin(60, (double)rx->fps * t));
-  SetDisplayAvBackmult(rx->channel, 0, display_avb);
-  SetDisplayNumAverage(rx->channel, 0, display_average);
+  if(rx->analyzer_plan!=NULL) {
+    // the analyzer averages once per FFT, use the rate chosen by the plan
+    ANALYZER_PLAN *plan=(ANALYZER_PLAN *)rx->analyzer_plan;
+    analyzer_plan_averaging(plan,rx->display_average_time);
+    display_avb=plan->av_backmult;
+    display_average=plan->num_average;
+  } else {
+    double t=0.001 * rx->display_average_time;
+
+    display_avb = exp(-1.0 / ((double)rx->fps * t));
+    display_average = max(2, (int)fmin(60, (double)rx->fps * t));
+  }
+  // every output is set, the unused ones cost nothing and are ready if a
+  // detector overlay is turned on
+  for(int i=0;i<1+DISPLAY_DETECTORS;i++) {
+    SetDisplayAvBackmult(rx->channel, i, display_avb);
+    SetDisplayNumAverage(rx->channel, i, display_average);
+  }
 }
 
 void receiver_fps_changed(RECEIVER *rx) {
-  g_source_remove(rx->update_timer_id);
-  rx->update_timer_id=g_timeout_add(1000/rx->fps,update_timer_cb,(gpointer)rx);
-  calculate_display_average(rx);
+  // the display tick picks up the new rate
+  frame_pacer_set_fps(&rx->thread_context.pacer,rx->fps);
+  // the FFT overlap depends on the frame rate
+  receiver_update_analyzer(rx);
+}
+
+void receiver_update_analyzer(RECEIVER *rx) {
+  if(rx->pixel_samples!=NULL) {
+    g_mutex_lock(&rx->mutex);
+    receiver_set_deep_zoom(rx);
+    receiver_set_analyzer(rx);
+    g_mutex_unlock(&rx->mutex);
+  } else {
+    calculate_display_average(rx);
+  }
 }
 
 void receiver_filter_changed(RECEIVER *rx,int filter) {
@@ -1180,7 +1344,13 @@ static void full_rx_buffer(RECEIVER *rx) {
         subrx_iq_buffer(rx);
     }
 
-    Spectrum0(1, rx->channel, 0, 0, temp_buffer);
+    if (!shared_analyzer_feed(rx, temp_buffer)) {
+        if (rx->deep_zoom_ddc != NULL) {
+            Spectrum0(1, rx->channel, 0, 0, deep_zoom_process(rx->deep_zoom_ddc, temp_buffer));
+        } else {
+            Spectrum0(1, rx->channel, 0, 0, temp_buffer);
+        }
+    }
     g_free(temp_buffer);
     process_rx_buffer(rx);
     g_mutex_unlock(&rx->mutex);
@@ -1243,7 +1413,9 @@ static gboolean resize_timeout_cb(gpointer data) {
     RECEIVER *rx = (RECEIVER *)data;
     ReceiverThreadContext *ctx = &rx->thread_context;
     g_mutex_lock(&ctx->render_mutex);
+    g_mutex_lock(&rx->mutex);
     receiver_init_analyzer(rx);
+    g_mutex_unlock(&rx->mutex);
     g_mutex_unlock(&ctx->render_mutex);
     rx->panadapter_resize_timer = -1;
     fprintf(stderr, "Resize (channel=%d): pixels=%d\n", rx->channel, rx->pixels);
@@ -1353,6 +1525,9 @@ static void create_visual(RECEIVER *rx) {
   gtk_table_attach(GTK_TABLE(rx->table), rx->vpaned, 0, 6, 1, 3,
       GTK_FILL | GTK_EXPAND, GTK_FILL | GTK_EXPAND, 0, 0);
 
+  // the backend chosen at startup, kept for the life of the receiver
+  rx->renderer=display_renderer;
+  rx->renderer_data=NULL;
   rx->panadapter=create_rx_panadapter(rx);
   //gtk_table_attach(GTK_TABLE(rx->table), rx->panadapter, 0, 4, 1, 2,
   //    GTK_FILL | GTK_EXPAND, GTK_FILL | GTK_EXPAND, 0, 0);
@@ -1379,40 +1554,109 @@ static void create_visual(RECEIVER *rx) {
                      | GDK_BUTTON_RELEASE_MASK);
 }
 
-void receiver_init_analyzer(RECEIVER *rx) {
+// Centre of the visible slice relative to the centre of the full span (Hz)
+static double receiver_deep_zoom_offset(RECEIVER *rx) {
+    int pixels=rx->analyzer_pixels;
+    int pan=rx->pan;
+    if(pan>rx->pixels-pixels) pan=rx->pixels-pixels;
+    if(pan<0) pan=0;
+    return ((double)pan+0.5*(double)(pixels-rx->pixels))*(double)rx->sample_rate/(double)rx->pixels;
+}
+
+//
+// Deep zoom: from DEEP_ZOOM_MIN_ZOOM up the visible slice can be shifted to
+// DC and decimated before the analyzer, which then needs a smaller FFT at
+// the lower rate for the same bins per pixel. The shift and the filter are
+// paid for on every sample, so the DDC is only used when the estimate says
+// it and the small FFT together cost less than the full span FFT. That is
+// mostly the case when the full span FFT is longer than a display frame
+// and has to overlap. Called with rx->mutex held, the DSP thread feeds the
+// analyzer through the DDC.
+//
+static void receiver_set_deep_zoom(RECEIVER *rx) {
+    gboolean use=FALSE;
+    int decimation=deep_zoom_decimation(rx->zoom);
+
+    if(rx->deep_zoom && decimation>1 && rx->analyzer_pixels>1 && rx->analyzer_pixels<rx->pixels) {
+        ANALYZER_PLAN full, zoomed;
+        analyzer_plan(&full,rx->sample_rate,rx->fps,rx->pixels,RX_BINS_PER_PIXEL,rx->analyzer_rbw,rx->display_average_time,ANALYZER_MIN_FFT,ANALYZER_MAX_FFT);
+        analyzer_plan(&zoomed,rx->sample_rate/decimation,rx->fps,(int)ceil((double)rx->pixels/(double)decimation),RX_BINS_PER_PIXEL,rx->analyzer_rbw,rx->display_average_time,ANALYZER_MIN_FFT,ANALYZER_MAX_FFT);
+        use=zoomed.cost+deep_zoom_cost(rx->sample_rate,rx->zoom)<full.cost;
+    }
+
+    DEEP_ZOOM *dz=rx->deep_zoom_ddc;
+    if(dz!=NULL && (!use || dz->in_rate!=rx->sample_rate || dz->zoom!=rx->zoom || dz->size!=rx->buffer_size)) {
+        deep_zoom_destroy(dz);
+        rx->deep_zoom_ddc=NULL;
+    }
+    if(use && rx->deep_zoom_ddc==NULL) {
+        rx->deep_zoom_ddc=deep_zoom_create(rx->sample_rate,rx->buffer_size,rx->zoom);
+    }
+}
+
+//
+// The analyzer only produces the pixels that are visible. With zoom the full
+// span is rx->pixels wide and the panadapter shows analyzer_pixels of them
+// starting at rx->pan; the bins either side of that slice are clipped with
+// span_clip_l/h so the analyzer work does not grow with the zoom factor.
+//
+static void receiver_set_analyzer(RECEIVER *rx) {
     int flp[] = {0};
     double keep_time = 0.1;
-    int n_pixout=1;
+    int n_pixout=1+display_detector_count(rx);
     int spur_elimination_ffts = 1;
     int data_type = 1;
-    int fft_size = 8192;
+    int fft_size;
     int window_type = 4;
     double kaiser_pi = 14.0;
-    int overlap = 2048;
+    int overlap;
     int clip = 0;
-    int span_clip_l = 0;
-    int span_clip_h = 0;
-    int pixels=rx->pixels;
+    double span_clip_l = 0.0;
+    double span_clip_h = 0.0;
+    int pixels=rx->analyzer_pixels;
     int stitches = 1;
     int calibration_data_set = 0;
     double span_min_freq = 0.0;
     double span_max_freq = 0.0;
 
-//g_print("receiver_init_analyzer: channel=%d zoom=%d pixels=%d pixel_samples=%p pan=%d\n",rx->channel,rx->zoom,rx->pixels,rx->pixel_samples,rx->pan);
-
-  if(rx->pixel_samples!=NULL) {
-//g_print("receiver_init_analyzer: g_free: channel=%d pixel_samples=%p\n",rx->channel,rx->pixel_samples);
-    g_free(rx->pixel_samples);
-    rx->pixel_samples=NULL;
-  }
-  if(rx->pixels>0) {
-    rx->pixel_samples=g_new0(float,rx->pixels);
-    rx->hz_per_pixel=(gdouble)rx->sample_rate/(gdouble)rx->pixels;
+    if(rx->analyzer_plan==NULL) {
+      rx->analyzer_plan=g_new0(ANALYZER_PLAN,1);
+    }
+    ANALYZER_PLAN *plan=(ANALYZER_PLAN *)rx->analyzer_plan;
+
+    // the span the analyzer transforms, in pixels of the visible slice
+    int rate=rx->sample_rate;
+    int block=rx->buffer_size;
+    double span=(double)rx->pixels;
+    double pan=(double)rx->pan;
+    if(pan>span-(double)pixels) pan=span-(double)pixels;
+    if(pan<0.0) pan=0.0;
+    if(rx->deep_zoom_ddc!=NULL) {
+      // the DDC output, with the visible slice in the middle of it
+      DEEP_ZOOM *dz=rx->deep_zoom_ddc;
+      rate=dz->out_rate;
+      block=rx->buffer_size/dz->decimation;
+      span=(double)rx->pixels/(double)dz->decimation;
+      pan=0.5*(span-(double)pixels);
+      deep_zoom_set_offset(dz,receiver_deep_zoom_offset(rx));
+    }
+
+    analyzer_plan(plan,rate,rx->fps,(int)ceil(span),RX_BINS_PER_PIXEL,rx->analyzer_rbw,rx->display_average_time,ANALYZER_MIN_FFT,ANALYZER_MAX_FFT);
+    fft_size=plan->fft_size;
+    overlap=plan->overlap;
+
+    if((double)pixels<span) {
+      // bin positions across the full span, see pix_per_bin in analyzer.c
+      double bins=(double)(stitches*(fft_size-1-2*clip))-1.0;
+      double bin_per_pixel=bins/(span-1.0);
+      span_clip_l=pan*bin_per_pixel;
+      span_clip_h=bins-(pan+(double)(pixels-1))*bin_per_pixel;
+      if(span_clip_h<0.0) span_clip_h=0.0;
+    }
+    rx->analyzer_pan=rx->pan;
 
     int max_w = fft_size + (int) fmin(keep_time * (double) rx->fps, keep_time * (double) fft_size * (double) rx->fps);
 
-    //overlap = (int)max(0.0, ceil(fft_size - (double)rx->sample_rate / (double)rx->fps));
-
 //g_print("SetAnalyzer id=%d buffer_size=%d fft_size=%d overlap=%d\n",rx->channel,rx->buffer_size,fft_size,overlap);
 
 
@@ -1422,7 +1666,7 @@ void receiver_init_analyzer(RECEIVER *rx) {
             data_type, //0 for real input data (I only); 1 for complex input data (I & Q)
             flp, //vector with one elt for each LO frequency, 1 if high-side LO, 0 otherwise
             fft_size, //size of the fft, i.e., number of input samples
-            rx->buffer_size, //number of samples transferred for each OpenBuffer()/CloseBuffer()
+            block, //number of samples transferred for each OpenBuffer()/CloseBuffer()
             window_type, //integer specifying which window function to use
             kaiser_pi, //PiAlpha parameter for Kaiser window
             overlap, //number of samples each fft (other than the first) is to re-use from the previous
@@ -1436,6 +1680,49 @@ void receiver_init_analyzer(RECEIVER *rx) {
             span_max_freq, //frequency at last pixel value
             max_w //max samples to hold in input ring buffers
     );
+
+    // output 0 is the averaged main trace, the detector overlays follow in
+    // DISPLAY_DETECTOR_ order. stitch() runs them in one pass over the bins.
+    int pixout=1;
+    for(int k=0;k<DISPLAY_DETECTORS;k++) {
+      if(!(rx->display_detectors&(1<<k))) continue;
+      switch(1<<k) {
+        case DISPLAY_DETECTOR_PEAK:
+          SetDisplayDetectorMode(rx->channel, pixout, DETECTOR_MODE_PEAK);
+          SetDisplayAverageMode(rx->channel, pixout, AVERAGE_MODE_NONE);
+          break;
+        case DISPLAY_DETECTOR_RMS:
+          SetDisplayDetectorMode(rx->channel, pixout, DETECTOR_MODE_RMS);
+          SetDisplayAverageMode(rx->channel, pixout, AVERAGE_MODE_LOG_RECURSIVE);
+          break;
+        case DISPLAY_DETECTOR_MIN:
+          SetDisplayDetectorMode(rx->channel, pixout, DETECTOR_MODE_MIN);
+          SetDisplayAverageMode(rx->channel, pixout, AVERAGE_MODE_NONE);
+          break;
+      }
+      pixout++;
+    }
+    calculate_display_average(rx);
+}
+
+void receiver_init_analyzer(RECEIVER *rx) {
+
+//g_print("receiver_init_analyzer: channel=%d zoom=%d pixels=%d pixel_samples=%p pan=%d\n",rx->channel,rx->zoom,rx->pixels,rx->pixel_samples,rx->pan);
+
+  if(rx->pixel_samples!=NULL) {
+//g_print("receiver_init_analyzer: g_free: channel=%d pixel_samples=%p\n",rx->channel,rx->pixel_samples);
+    g_free(rx->pixel_samples);
+    rx->pixel_samples=NULL;
+  }
+  rx->analyzer_pixels=0;
+  if(rx->pixels>0) {
+    rx->analyzer_pixels=rx->panadapter_width;
+    if(rx->analyzer_pixels<=1 || rx->analyzer_pixels>rx->pixels) rx->analyzer_pixels=rx->pixels;
+    // room for the main trace and every detector overlay
+    rx->pixel_samples=g_new0(float,rx->analyzer_pixels*(1+DISPLAY_DETECTORS));
+    rx->hz_per_pixel=(gdouble)rx->sample_rate/(gdouble)rx->pixels;
+    receiver_set_deep_zoom(rx);
+    receiver_set_analyzer(rx);
   }
 
 }
@@ -1456,7 +1743,10 @@ void receiver_change_zoom(RECEIVER *rx,int zoom) {
       rx->pan=(rx->pixels/2)-(rx->panadapter_width/2);
     }
   }
+  // the analyzer is reconfigured between the DSP thread's blocks
+  g_mutex_lock(&rx->mutex);
   receiver_init_analyzer(rx);
+  g_mutex_unlock(&rx->mutex);
 }
 
 RECEIVER *create_receiver(int channel, int sample_rate) {
@@ -1495,6 +1785,10 @@ RECEIVER *create_receiver(int channel, int sample_rate) {
         return NULL;
     }
     g_mutex_init(&ctx->render_mutex);
+    triple_buffer_init(&rx->display_buffer);
+    triple_buffer_init(&rx->waterfall_buffer);
+    waterfall_stream_init(&rx->waterfall_stream);
+    g_mutex_init(&ctx->frame_mutex);
     ctx->wdsp_thread = NULL;
     ctx->render_thread = NULL;
   rx->channel=channel;
@@ -1657,6 +1951,8 @@ fprintf(stderr,"create_receiver: buffer_size=%d\n",rx->buffer_size);
 
   rx->fps=10;
   rx->display_average_time=170.0;
+  rx->analyzer_rbw=0.0;
+  rx->deep_zoom=TRUE;
 
 #ifdef SOAPYSDR
   if(radio->discovered->device==DEVICE_SOAPYSDR) {
@@ -1692,13 +1988,27 @@ fprintf(stderr,"create_receiver: fft_size=%d\n",rx->fft_size);
   rx->panadapter_high=-60;
   rx->panadapter_step=20;
   rx->panadapter_surface=NULL;
+  rx->panadapter_back=NULL;
   
   rx->panadapter_filled=TRUE;
   rx->panadapter_gradient=TRUE;
   rx->panadapter_agc_line=TRUE;
+  rx->panadapter_peak_hold=FALSE;
+  rx->panadapter_average=FALSE;
+  rx->display_detectors=0;
+  rx->panadapter_trace=NULL;
 
   rx->waterfall_automatic=TRUE;
   rx->waterfall_ft8_marker=FALSE;
+  rx->waterfall_palette=PALETTE_RAINBOW;
+  rx->waterfall_subsample=FALSE;
+  rx->waterfall_rate=0;
+  rx->waterfall_combine=WATERFALL_COMBINE_AVERAGE;
+  rx->waterfall_history=FALSE;
+  rx->waterfall_history_level=0;
+  rx->waterfall_scrollback=0;
+  rx->spectrum_history=NULL;
+  rx->spectrum_history_failed=FALSE;
 
   rx->vfo_surface=NULL;
   rx->meter_surface=NULL;
@@ -1874,7 +2184,8 @@ g_print("create_receiver: OpenChannel: channel=%d buffer_size=%d sample_rate=%d
     update_frequency(rx);
   }
 
-  rx->update_timer_id=g_timeout_add(1000/rx->fps,update_timer_cb,(gpointer)rx);
+  frame_pacer_init(&ctx->pacer,rx->fps);
+  rx->tick_phase=0;
   // Start WDSP thread
   ctx->wdsp_thread = g_thread_new("ctx->wdsp_thread", wdsp_processing_thread, rx);
   // Start Render thread
@@ -27,6 +27,12 @@
 #include <alsa/asoundlib.h>
 #endif
 
+#include "frame_pacer.h"
+#include "triple_buffer.h"
+#include "waterfall_stream.h"
+#include "display_tick.h"
+#include "deep_zoom.h"
+
 typedef enum {SPLIT_OFF, SPLIT_ON, SPLIT_SAT, SPLIT_RSAT} split_type;
 
 typedef struct {
@@ -42,6 +48,10 @@ typedef struct _meter_cache {
     cairo_surface_t *static_surface; // Cache for static meter elements
     int width;
     int height;
+    double level;                    // level the needle was last drawn at
+    cairo_surface_t *units_surface;  // S unit and over S9 readout
+    int s_unit;
+    int over;
 } MeterCache;
 
 
@@ -51,11 +61,14 @@ typedef struct {
     GThread *render_thread;     // Thread for rendering
     GAsyncQueue *render_queue;  // Queue for render tasks
     GMutex render_mutex;        // Mutex for rendering
+    GMutex frame_mutex;         // Guards the panadapter front/back swap
+    FRAME_PACER pacer;          // One pending frame, adaptive frame rate
     gboolean running;           // Running state for threads
 } ReceiverThreadContext;
 
 typedef struct {
   cairo_surface_t *static_surface;
+  cairo_surface_t *plot_surface;   // trace and fill, reused every frame
   int width;
   int height;
   int zoom;
@@ -90,15 +103,27 @@ typedef struct _receiver {
   gdouble *audio_output_buffer;
   gint audio_buffer_size;
   guchar *audio_buffer;
-  gfloat *pixel_samples;
+  gfloat *pixel_samples;       // update timer's GetPixels output
+  TRIPLE_BUFFER display_buffer; // pixel_samples handed to the render thread
+  gfloat *display_samples;     // render thread's frame, its display_buffer slot
+  gint display_samples_n;
+  gint display_traces;         // runs of display_samples_n, detector overlays after the first
 
-  gint update_timer_id;
+  gint tick_phase;             // display_tick_due() accumulator
 
   gint samples;
   gint output_samples;
   gint pixels;
+  gint analyzer_pixels;   // visible slice actually produced by the analyzer
+  gint analyzer_pan;      // pan the analyzer span clipping was set for
+  gint shared_role;       // SHARED_NONE, or fed from the ADC's shared analyzer
+  guint64 shared_serial;  // last shared frame cut for this receiver
   gint fps;
   gdouble display_average_time;
+  gdouble analyzer_rbw;   // target resolution bandwidth, 0 for automatic
+  void *analyzer_plan;
+  gboolean deep_zoom;     // decimate the visible span for the analyzer when that is cheaper
+  DEEP_ZOOM *deep_zoom_ddc; // NULL while the analyzer takes the full span
   
   gboolean ctun;
   gint64 ctun_frequency;
@@ -194,6 +219,7 @@ typedef struct _receiver {
 
   gint smeter;
   double meter_db;
+  gint meter_cdb;              // meter_db in 0.01 dB for other threads, see receiver_get_meter_db()
 
   gint window_x;
   gint window_y;
@@ -210,7 +236,8 @@ typedef struct _receiver {
   gint panadapter_resize_width;
   gint panadapter_resize_height;
   guint panadapter_resize_timer;
-  cairo_surface_t *panadapter_surface;
+  cairo_surface_t *panadapter_surface;  // front buffer, painted by the draw handler
+  cairo_surface_t *panadapter_back;     // back buffer, drawn by the render thread
 
   gint panadapter_low;
   gint panadapter_high;
@@ -218,6 +245,13 @@ typedef struct _receiver {
   gboolean panadapter_filled;
   gboolean panadapter_gradient;
   gboolean panadapter_agc_line;  
+  gboolean panadapter_peak_hold;
+  gboolean panadapter_average;
+  gint display_detectors;      // DISPLAY_DETECTOR_ overlays, extra analyzer outputs
+  void *panadapter_trace;
+
+  const struct _display_renderer *renderer;  // how the frames reach the screen
+  void *renderer_data;                       // the renderer's own state
 
   GtkWidget *waterfall;
   gint waterfall_width;
@@ -226,13 +260,33 @@ typedef struct _receiver {
   gint waterfall_resize_height;
   guint waterfall_resize_timer;
   GdkPixbuf *waterfall_pixbuf;
+  gint waterfall_head;
+  gint waterfall_generation;   // bumped when the whole pixbuf is rewritten
 
   gint waterfall_low;
   gint waterfall_high;
   gboolean waterfall_automatic;
   gboolean waterfall_ft8_marker;
+  gint waterfall_palette;
+  gboolean waterfall_subsample;
+  void *waterfall_colormap;
+  float *waterfall_line;
+  gint waterfall_line_size;
+  gint waterfall_rate;                 // lines per second, 0 for one per panadapter frame
+  gint waterfall_combine;              // WATERFALL_COMBINE_ for the frames in a line
+  WATERFALL_STREAM waterfall_stream;   // update timer's line being built
+  TRIPLE_BUFFER waterfall_buffer;      // finished lines handed to the render thread
   gint64 waterfall_frequency;
   gint waterfall_sample_rate;
+  gboolean waterfall_history;      // keep a spectrum history on disk
+  gint waterfall_history_level;    // 0 live, n shows 8^n frames per row
+  gint waterfall_scrollback;       // seconds back from now, 0 for live
+  void *spectrum_history;
+  gboolean spectrum_history_failed;
+  guint64 waterfall_history_serial;
+  gint64 waterfall_history_time;
+  gint waterfall_history_shown_level;
+  gint waterfall_history_shown_scrollback;
   
   gdouble hz_per_pixel;
 
@@ -259,9 +313,18 @@ typedef struct _receiver {
 
   struct SoundIoDevice *output_device;
   struct SoundIoOutStream *output_stream;
-  struct SoundIoRingBuffer *ring_buffer;
   gboolean output_started;
 
+  // rate matcher between the radio sample clock and the sound card clock
+  void *audio_rmatch;
+  gdouble *audio_rmatch_in;
+  gint audio_rmatch_in_offset;
+  gdouble *audio_rmatch_out;
+  gint audio_rmatch_out_offset;
+  GThread *audio_output_thread_id;
+  gint audio_output_running;   // g_atomic, cleared by either thread
+  gdouble audio_device_latency;  // ms held by the sound card or server
+
 #ifndef __APPLE__
   pa_simple* playstream;
   snd_pcm_t *playback_handle;
@@ -345,6 +408,13 @@ enum {
   AUDIO_RIGHT_ONLY = 2
 };
 
+// display_detectors: extra analyzer outputs from the same FFT, overlaid on
+// the panadapter in this order after the averaged main trace
+#define DISPLAY_DETECTOR_PEAK 0x01
+#define DISPLAY_DETECTOR_RMS  0x02
+#define DISPLAY_DETECTOR_MIN  0x04
+#define DISPLAY_DETECTORS     3
+
 extern RECEIVER *create_receiver(int channel,int sample_rate);
 extern void receiver_update_title(RECEIVER *rx);
 extern void receiver_init_analyzer(RECEIVER *rx);
@@ -368,6 +438,7 @@ extern void receiver_change_sample_rate(RECEIVER *rx,int sample_rate);
 extern void set_agc(RECEIVER *rx);
 extern void calculate_display_average(RECEIVER *rx);
 extern void receiver_fps_changed(RECEIVER *rx);
+extern void receiver_update_analyzer(RECEIVER *rx);
 extern void receiver_change_zoom(RECEIVER *rx,int zoom);
 extern void update_frequency(RECEIVER *rx);
 extern void receiver_move(RECEIVER *rx,long long hz,gboolean round);
@@ -376,5 +447,8 @@ extern void receiver_move_to(RECEIVER *rx,long long hz);
 extern void receiver_set_volume(RECEIVER *rx);
 extern void receiver_set_agc_gain(RECEIVER *rx);
 extern void receiver_set_ctun(RECEIVER *rx);
+extern double receiver_get_meter_db(RECEIVER *rx);
+extern void receiver_display_request(RECEIVER *rx,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
+extern void receiver_display_update(RECEIVER *rx,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
 extern void set_band(RECEIVER *rx,int band,int entry);
 #endif
\ No newline at end of file
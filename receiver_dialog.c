@@ -42,6 +42,8 @@
 #include "audio.h"
 #include "main.h"
 #include "rigctl.h"
+#include "colormap.h"
+#include "spectrum_history.h"
 
 #define BAND_COLUMNS 5
 #define MODE_COLUMNS 4
@@ -789,6 +791,22 @@ static void panadapter_average_time_value_changed_cb(GtkWidget *widget, gpointer
   calculate_display_average(rx);
 }
 
+static const double analyzer_rbw_choice[]={0.0,5.0,10.0,25.0,50.0,100.0};
+
+static void analyzer_rbw_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  int i=gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+  if(i<0) return;
+  rx->analyzer_rbw=analyzer_rbw_choice[i];
+  receiver_update_analyzer(rx);
+}
+
+static void deep_zoom_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->deep_zoom=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+  receiver_update_analyzer(rx);
+}
+
 static void panadapter_high_value_changed_cb(GtkWidget *widget, gpointer data) {
   RECEIVER *rx=(RECEIVER *)data;
   rx->panadapter_high=gtk_range_get_value(GTK_RANGE(widget));
@@ -819,6 +837,38 @@ static void panadapter_agc_line_changed_cb(GtkWidget *widget, gpointer data) {
   rx->panadapter_agc_line=rx->panadapter_agc_line==TRUE?FALSE:TRUE;
 }
 
+static void panadapter_peak_hold_changed_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->panadapter_peak_hold=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+}
+
+static void panadapter_average_changed_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->panadapter_average=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+}
+
+static void display_detector_changed(GtkWidget *widget, RECEIVER *rx, int detector) {
+  if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget))) {
+    rx->display_detectors|=detector;
+  } else {
+    rx->display_detectors&=~detector;
+  }
+  // the overlays are extra outputs of the analyzer, it needs setting up again
+  receiver_update_analyzer(rx);
+}
+
+static void display_detector_peak_changed_cb(GtkWidget *widget, gpointer data) {
+  display_detector_changed(widget,(RECEIVER *)data,DISPLAY_DETECTOR_PEAK);
+}
+
+static void display_detector_rms_changed_cb(GtkWidget *widget, gpointer data) {
+  display_detector_changed(widget,(RECEIVER *)data,DISPLAY_DETECTOR_RMS);
+}
+
+static void display_detector_min_changed_cb(GtkWidget *widget, gpointer data) {
+  display_detector_changed(widget,(RECEIVER *)data,DISPLAY_DETECTOR_MIN);
+}
+
 static void waterfall_high_value_changed_cb(GtkWidget *widget, gpointer data) {
   RECEIVER *rx=(RECEIVER *)data;
   rx->waterfall_high=gtk_range_get_value(GTK_RANGE(widget));
@@ -839,6 +889,57 @@ static void waterfall_ft8_marker_cb(GtkWidget *widget, gpointer data) {
   rx->waterfall_ft8_marker=rx->waterfall_ft8_marker==TRUE?FALSE:TRUE;
 }
 
+static void waterfall_palette_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->waterfall_palette=gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+}
+
+// lines per second, 0 scrolls with the panadapter frames
+static const int waterfall_rate_choice[]={0,1,2,5,10,25,50};
+
+static void waterfall_rate_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  int i=gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+  if(i<0) return;
+  rx->waterfall_rate=waterfall_rate_choice[i];
+}
+
+static void waterfall_combine_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->waterfall_combine=gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+}
+
+static void waterfall_subsample_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->waterfall_subsample=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+}
+
+// Turning the history off gives back the mapping and the file lock;
+// turning it on tries to open the file again even if it failed before.
+static void waterfall_history_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  ReceiverThreadContext *ctx=&rx->thread_context;
+  g_mutex_lock(&ctx->render_mutex);
+  rx->waterfall_history=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+  if(rx->waterfall_history) {
+    rx->spectrum_history_failed=FALSE;
+  } else if(rx->spectrum_history!=NULL) {
+    destroy_spectrum_history(rx->spectrum_history);
+    rx->spectrum_history=NULL;
+  }
+  g_mutex_unlock(&ctx->render_mutex);
+}
+
+static void waterfall_history_level_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->waterfall_history_level=gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+}
+
+static void waterfall_scrollback_value_changed_cb(GtkWidget *widget, gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  rx->waterfall_scrollback=(gint)gtk_range_get_value(GTK_RANGE(widget))*60;
+}
+
 static void remote_audio_cb(GtkWidget *widget, gpointer data) {
   RECEIVER *rx=(RECEIVER *)data;
   rx->remote_audio=rx->remote_audio==TRUE?FALSE:TRUE;
@@ -1391,6 +1492,55 @@ GtkWidget *create_receiver_dialog(RECEIVER *rx) {
   gtk_grid_attach(GTK_GRID(panadapter_grid),panadapter_agc_line,0,7,2,1);
   g_signal_connect(panadapter_agc_line,"toggled",G_CALLBACK(panadapter_agc_line_changed_cb),rx);
 
+  GtkWidget *panadapter_peak_hold=gtk_check_button_new_with_label("Peak Hold");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (panadapter_peak_hold), rx->panadapter_peak_hold);
+  gtk_grid_attach(GTK_GRID(panadapter_grid),panadapter_peak_hold,0,9,2,1);
+  g_signal_connect(panadapter_peak_hold,"toggled",G_CALLBACK(panadapter_peak_hold_changed_cb),rx);
+
+  GtkWidget *panadapter_average=gtk_check_button_new_with_label("Average Trace");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (panadapter_average), rx->panadapter_average);
+  gtk_grid_attach(GTK_GRID(panadapter_grid),panadapter_average,0,10,2,1);
+  g_signal_connect(panadapter_average,"toggled",G_CALLBACK(panadapter_average_changed_cb),rx);
+
+  GtkWidget *detector_peak=gtk_check_button_new_with_label("Peak Detector");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (detector_peak), (rx->display_detectors&DISPLAY_DETECTOR_PEAK)!=0);
+  gtk_grid_attach(GTK_GRID(panadapter_grid),detector_peak,0,11,1,1);
+  g_signal_connect(detector_peak,"toggled",G_CALLBACK(display_detector_peak_changed_cb),rx);
+
+  GtkWidget *detector_rms=gtk_check_button_new_with_label("RMS Detector");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (detector_rms), (rx->display_detectors&DISPLAY_DETECTOR_RMS)!=0);
+  gtk_grid_attach(GTK_GRID(panadapter_grid),detector_rms,1,11,1,1);
+  g_signal_connect(detector_rms,"toggled",G_CALLBACK(display_detector_rms_changed_cb),rx);
+
+  GtkWidget *detector_min=gtk_check_button_new_with_label("Min Detector");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (detector_min), (rx->display_detectors&DISPLAY_DETECTOR_MIN)!=0);
+  gtk_grid_attach(GTK_GRID(panadapter_grid),detector_min,0,12,1,1);
+  g_signal_connect(detector_min,"toggled",G_CALLBACK(display_detector_min_changed_cb),rx);
+
+  GtkWidget *rbw_label=gtk_label_new("Resolution:");
+  gtk_grid_attach(GTK_GRID(panadapter_grid),rbw_label,0,8,1,1);
+
+  GtkWidget *rbw_combo=gtk_combo_box_text_new();
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(rbw_combo),NULL,"Auto");
+  for(int i=1;i<(int)(sizeof(analyzer_rbw_choice)/sizeof(analyzer_rbw_choice[0]));i++) {
+    char text[16];
+    g_snprintf(text,sizeof(text),"%.0f Hz",analyzer_rbw_choice[i]);
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(rbw_combo),NULL,text);
+    if(rx->analyzer_rbw==analyzer_rbw_choice[i]) {
+      gtk_combo_box_set_active(GTK_COMBO_BOX(rbw_combo),i);
+    }
+  }
+  if(gtk_combo_box_get_active(GTK_COMBO_BOX(rbw_combo))==-1) {
+    gtk_combo_box_set_active(GTK_COMBO_BOX(rbw_combo),0);
+  }
+  gtk_grid_attach(GTK_GRID(panadapter_grid),rbw_combo,1,8,1,1);
+  g_signal_connect(rbw_combo,"changed",G_CALLBACK(analyzer_rbw_cb),rx);
+
+  GtkWidget *deep_zoom=gtk_check_button_new_with_label("Deep Zoom (DDC)");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (deep_zoom), rx->deep_zoom);
+  gtk_grid_attach(GTK_GRID(panadapter_grid),deep_zoom,0,13,2,1);
+  g_signal_connect(deep_zoom,"toggled",G_CALLBACK(deep_zoom_cb),rx);
+
   GtkWidget *waterfall_frame=gtk_frame_new("Waterfall");
   GtkWidget *waterfall_grid=gtk_grid_new();
   gtk_grid_set_row_homogeneous(GTK_GRID(waterfall_grid),FALSE);
@@ -1427,6 +1577,77 @@ GtkWidget *create_receiver_dialog(RECEIVER *rx) {
   gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_ft8_marker,0,3,2,1);
   g_signal_connect(waterfall_ft8_marker,"toggled",G_CALLBACK(waterfall_ft8_marker_cb),rx);
 
+  GtkWidget *waterfall_subsample=gtk_check_button_new_with_label("Waterfall Reduced Resolution");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (waterfall_subsample), rx->waterfall_subsample);
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_subsample,0,4,2,1);
+  g_signal_connect(waterfall_subsample,"toggled",G_CALLBACK(waterfall_subsample_cb),rx);
+
+  GtkWidget *waterfall_palette_label=gtk_label_new("Palette:");
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_palette_label,0,5,1,1);
+
+  GtkWidget *waterfall_palette=gtk_combo_box_text_new();
+  for(int i=0;i<PALETTE_LAST;i++) {
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_palette),NULL,palette_name[i]);
+  }
+  gtk_combo_box_set_active(GTK_COMBO_BOX(waterfall_palette),rx->waterfall_palette);
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_palette,1,5,1,1);
+  g_signal_connect(waterfall_palette,"changed",G_CALLBACK(waterfall_palette_cb),rx);
+
+  GtkWidget *waterfall_history=gtk_check_button_new_with_label("Waterfall History");
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (waterfall_history), rx->waterfall_history);
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_history,0,6,2,1);
+  g_signal_connect(waterfall_history,"toggled",G_CALLBACK(waterfall_history_cb),rx);
+
+  GtkWidget *waterfall_history_level_label=gtk_label_new("Time Scale:");
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_history_level_label,0,7,1,1);
+
+  GtkWidget *waterfall_history_level=gtk_combo_box_text_new();
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_history_level),NULL,"Live");
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_history_level),NULL,"x8");
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_history_level),NULL,"x64");
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_history_level),NULL,"x512");
+  gtk_combo_box_set_active(GTK_COMBO_BOX(waterfall_history_level),rx->waterfall_history_level);
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_history_level,1,7,1,1);
+  g_signal_connect(waterfall_history_level,"changed",G_CALLBACK(waterfall_history_level_cb),rx);
+
+  GtkWidget *waterfall_scrollback_label=gtk_label_new("Scrollback (min):");
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_scrollback_label,0,8,1,1);
+
+  GtkWidget *waterfall_scrollback_scale=gtk_scale_new(GTK_ORIENTATION_HORIZONTAL,gtk_adjustment_new(rx->waterfall_scrollback/60,0.0, 720.0, 1.0, 10.0, 0.0));
+  gtk_widget_set_size_request(waterfall_scrollback_scale,200,30);
+  gtk_scale_set_digits(GTK_SCALE(waterfall_scrollback_scale),0);
+  g_signal_connect(G_OBJECT(waterfall_scrollback_scale),"value_changed",G_CALLBACK(waterfall_scrollback_value_changed_cb),rx);
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_scrollback_scale,1,8,1,1);
+
+  GtkWidget *waterfall_rate_label=gtk_label_new("Lines/s:");
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_rate_label,0,9,1,1);
+
+  GtkWidget *waterfall_rate=gtk_combo_box_text_new();
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_rate),NULL,"Panadapter");
+  for(int i=1;i<(int)(sizeof(waterfall_rate_choice)/sizeof(waterfall_rate_choice[0]));i++) {
+    char text[16];
+    g_snprintf(text,sizeof(text),"%d",waterfall_rate_choice[i]);
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_rate),NULL,text);
+    if(rx->waterfall_rate==waterfall_rate_choice[i]) {
+      gtk_combo_box_set_active(GTK_COMBO_BOX(waterfall_rate),i);
+    }
+  }
+  if(gtk_combo_box_get_active(GTK_COMBO_BOX(waterfall_rate))==-1) {
+    gtk_combo_box_set_active(GTK_COMBO_BOX(waterfall_rate),0);
+  }
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_rate,1,9,1,1);
+  g_signal_connect(waterfall_rate,"changed",G_CALLBACK(waterfall_rate_cb),rx);
+
+  GtkWidget *waterfall_combine_label=gtk_label_new("Combine:");
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_combine_label,0,10,1,1);
+
+  GtkWidget *waterfall_combine=gtk_combo_box_text_new();
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_combine),NULL,"Average");
+  gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_combine),NULL,"Peak");
+  gtk_combo_box_set_active(GTK_COMBO_BOX(waterfall_combine),rx->waterfall_combine);
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_combine,1,10,1,1);
+  g_signal_connect(waterfall_combine,"changed",G_CALLBACK(waterfall_combine_cb),rx);
+
   col++;
   row=0;
 
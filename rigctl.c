@@ -235,7 +235,7 @@ static double s_meter_level(RECEIVER *rx) {
   if(radio->discovered->device==DEVICE_HERMES_LITE2) {
     attenuation = attenuation * -1;
   }
-  double level=rx->meter_db+attenuation;
+  double level=receiver_get_meter_db(rx)+attenuation;
   return level;
 }
 
@@ -3730,7 +3730,7 @@ int parse_cmd(void *data) {
           if(command[3]==';') {
             int id=atoi(&command[2]);
             if(id==0 || id==1) {
-              sprintf(reply,"SM%04d;",(int)rx->meter_db);
+              sprintf(reply,"SM%04d;",(int)receiver_get_meter_db(rx));
               send_resp(cmd,reply);
             }
           }
@@ -3,7 +3,6 @@
  */
 
 #include <gtk/gtk.h>
-#include <epoxy/gl.h>
 #include <math.h>
 #include <stdlib.h>
 #include <wdsp.h>
@@ -25,40 +24,80 @@
 #include "main.h"
 #include "vfo.h"
 #include "subrx.h"
+#include "panadapter_trace.h"
+#include "display_renderer.h"
 
 #define LINE_WIDTH 0.5
 
-int signal_vertices_size = -1;
-float *signal_vertices = NULL;
-
 static const double dashed2[] = {2.0, 2.0};
 static int len2 = sizeof(dashed2) / sizeof(dashed2[0]);
 
 //static gboolean first_time = TRUE;
 
+//
+// The panadapter is double buffered with image surfaces so the render
+// thread can draw the next frame without touching the window system.
+// The render thread owns panadapter_back under render_mutex; the draw
+// handler paints panadapter_surface under frame_mutex.
+//
+static cairo_surface_t *create_frame(int width, int height) {
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+    cairo_t *cr = cairo_create(surface);
+    cairo_set_source_rgb(cr, 0.1, 0.1, 0.1); // Dark background
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    return surface;
+}
+
+static void destroy_frames(RECEIVER *rx) {
+    if (rx->panadapter_surface) {
+        cairo_surface_destroy(rx->panadapter_surface);
+        rx->panadapter_surface = NULL;
+    }
+    if (rx->panadapter_back) {
+        cairo_surface_destroy(rx->panadapter_back);
+        rx->panadapter_back = NULL;
+    }
+}
+
+// caller holds render_mutex
+static void create_frames(RECEIVER *rx, int width, int height) {
+    ReceiverThreadContext *ctx = &rx->thread_context;
+    g_mutex_lock(&ctx->frame_mutex);
+    destroy_frames(rx);
+    rx->panadapter_surface = create_frame(width, height);
+    rx->panadapter_back = create_frame(width, height);
+    g_mutex_unlock(&ctx->frame_mutex);
+}
+
+static void swap_frames(RECEIVER *rx) {
+    ReceiverThreadContext *ctx = &rx->thread_context;
+    g_mutex_lock(&ctx->frame_mutex);
+    cairo_surface_t *front = rx->panadapter_back;
+    rx->panadapter_back = rx->panadapter_surface;
+    rx->panadapter_surface = front;
+    if (rx->renderer->swap != NULL) {
+        rx->renderer->swap(rx);
+    }
+    g_mutex_unlock(&ctx->frame_mutex);
+}
+
 static void panadapter_realize_cb(GtkWidget *widget, gpointer data) {
     RECEIVER *rx = (RECEIVER *)data;
-    GdkWindow *window = gtk_widget_get_window(widget);
-    if (window && GDK_IS_WINDOW(window)) {
-        rx->panadapter_surface = gdk_window_create_similar_surface(window, CAIRO_CONTENT_COLOR, 1, 1);
-        if (rx->panadapter_surface) {
-            cairo_t *cr = cairo_create(rx->panadapter_surface);
-            cairo_set_source_rgb(cr, 0.1, 0.1, 0.1); // Dark background
-            cairo_paint(cr);
-            cairo_destroy(cr);
-            g_print("panadapter_realize_cb: Created panadapter_surface for rx=%d\n", rx->channel);
-        } else {
-            g_warning("panadapter_realize_cb: Failed to create panadapter_surface for rx=%d", rx->channel);
-        }
-    } else {
-        g_warning("panadapter_realize_cb: Invalid window for rx=%d", rx->channel);
+    ReceiverThreadContext *ctx = &rx->thread_context;
+    g_mutex_lock(&ctx->render_mutex);
+    if (rx->panadapter_surface == NULL) {
+        create_frames(rx, 1, 1);
     }
+    g_mutex_unlock(&ctx->render_mutex);
 }
 
 static gboolean resize_timeout(void *data) {
   RECEIVER *rx = (RECEIVER *)data;
+  ReceiverThreadContext *ctx = &rx->thread_context;
   PanadapterCache *px = &rx->panadapter_cache;
 
+  g_mutex_lock(&ctx->render_mutex);
   g_mutex_lock(&rx->mutex);
   rx->panadapter_width = rx->panadapter_resize_width;
   rx->panadapter_height = rx->panadapter_resize_height;
@@ -66,27 +105,19 @@ static gboolean resize_timeout(void *data) {
 
   receiver_init_analyzer(rx);
 
-  if (rx->panadapter_surface) {
-    cairo_surface_destroy(rx->panadapter_surface);
-    rx->panadapter_surface = NULL;
-  }
-
   if (px->static_surface) {
     cairo_surface_destroy(px->static_surface);
     px->static_surface = NULL;
   }
+  if (px->plot_surface) {
+    cairo_surface_destroy(px->plot_surface);
+    px->plot_surface = NULL;
+  }
   px->width = 0;
   px->height = 0;
 
   if (rx->panadapter != NULL) {
-    rx->panadapter_surface = gdk_window_create_similar_surface(gtk_widget_get_window(rx->panadapter),
-                                                              CAIRO_CONTENT_COLOR,
-                                                              rx->panadapter_width,
-                                                              rx->panadapter_height);
-    cairo_t *cr = cairo_create(rx->panadapter_surface);
-    cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
-    cairo_paint(cr);
-    cairo_destroy(cr);
+    create_frames(rx, rx->panadapter_width, rx->panadapter_height);
   } else {
     fprintf(stderr, "resize_timeout: rx->panadapter is NULL\n");
   }
@@ -94,100 +125,12 @@ static gboolean resize_timeout(void *data) {
   rx->panadapter_resize_timer = -1;
   update_vfo(rx);
   g_mutex_unlock(&rx->mutex);
+  g_mutex_unlock(&ctx->render_mutex);
   return FALSE;
 }
 
-#ifdef OPENGL
-GLuint gl_program, gl_vao;
-
-const GLchar *vert_src = "\n"
-                         "#version 330                                  \n"
-                         "#extension GL_ARB_explicit_attrib_location: enable  \n"
-                         "                                              \n"
-                         "layout(location = 0) in vec2 in_position;     \n"
-                         "                                              \n"
-                         "void main()                                   \n"
-                         "{                                             \n"
-                         "  gl_Position *ftransform;                   \n"
-                         "}                                             \n";
-
-const GLchar *frag_src = "\n"
-                         "void main (void)                              \n"
-                         "{                                             \n"
-                         "  gl_FragColor = vec4(1.0, 1.0, 1.0, 1.0);    \n"
-                         "}                                             \n";
-
-static gboolean rx_panadapter_render(GtkGLArea *area, GdkGLContext *context) {
-  glClearColor(0, 0, 0, 0);
-  glClear(GL_COLOR_BUFFER_BIT);
-
-  if (signal_vertices_size != -1) {
-    glLineWidth(2.0);
-    glColor3f(1.0, 1.0, 0.0);
-    GLuint vbo;
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, signal_vertices_size * sizeof(float) * 2, signal_vertices, GL_STREAM_DRAW);
-
-    glUseProgram(gl_program);
-    glBindVertexArray(gl_vao);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-    glDrawArrays(GL_LINE_STRIP, 0, signal_vertices_size);
-    glDisableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    glUseProgram(0);
-  } else {
-    fprintf(stderr, "rx_panadapter_render: signal_vertices_size is -1, skipping draw\n");
-  }
-
-  return TRUE;
-}
-
-static void rx_panadapter_realize(GtkGLArea *area) {
-  gtk_gl_area_make_current(area);
-
-  if (gtk_gl_area_get_error(area) != NULL) {
-    fprintf(stderr, "rx_panadapter_realize: gtk_gl_area_get_error returned non-NULL\n");
-    return;
-  }
-
-  GLuint frag_shader, vert_shader;
-  frag_shader = glCreateShader(GL_FRAGMENT_SHADER);
-  vert_shader = glCreateShader(GL_VERTEX_SHADER);
-
-  glShaderSource(frag_shader, 1, &frag_src, NULL);
-  glShaderSource(vert_shader, 1, &vert_src, NULL);
-
-  glCompileShader(frag_shader);
-  glCompileShader(vert_shader);
-
-  gl_program = glCreateProgram();
-  glAttachShader(gl_program, frag_shader);
-  glAttachShader(gl_program, vert_shader);
-  glLinkProgram(gl_program);
-
-  glGenVertexArrays(1, &gl_vao);
-  glBindVertexArray(gl_vao);
-}
-#endif
-
-void rx_panadapter_resize(GtkGLArea *area, gint width, gint height, gpointer data) {
-  RECEIVER *rx = (RECEIVER *)data;
-  if (width != rx->panadapter_width || height != rx->panadapter_height) {
-    rx->panadapter_resize_width = width;
-    rx->panadapter_resize_height = height;
-    if (rx->panadapter_resize_timer != -1) {
-      g_source_remove(rx->panadapter_resize_timer);
-    }
-    rx->panadapter_resize_timer = g_timeout_add(250, resize_timeout, (gpointer)rx);
-  }
-}
-
-static gboolean rx_panadapter_configure_event_cb(GtkWidget *widget, GdkEventConfigure *event, gpointer data) {
-  RECEIVER *rx = (RECEIVER *)data;
-  gint width = gtk_widget_get_allocated_width(widget);
-  gint height = gtk_widget_get_allocated_height(widget);
+// main thread: the widget size, applied once it has settled
+void rx_panadapter_resize(RECEIVER *rx, int width, int height) {
   if (width != rx->panadapter_width || height != rx->panadapter_height) {
     rx->panadapter_resize_width = width;
     rx->panadapter_resize_height = height;
@@ -196,27 +139,26 @@ static gboolean rx_panadapter_configure_event_cb(GtkWidget *widget, GdkEventConf
     }
     rx->panadapter_resize_timer = g_timeout_add(250, resize_timeout, (gpointer)rx);
   }
-  return TRUE;
-}
-
-static gboolean rx_panadapter_draw_cb(GtkWidget *widget, cairo_t *cr, gpointer data) {
-  RECEIVER *rx = (RECEIVER *)data;
-  if (rx->panadapter_surface != NULL) {
-    cairo_set_source_surface(cr, rx->panadapter_surface, 0.0, 0.0);
-    cairo_paint(cr);
-  } else {
-    fprintf(stderr, "rx_panadapter_draw_cb: panadapter_surface is NULL, skipping paint\n");
-  }
-  return TRUE;
 }
 
 static void panadapter_destroy_cb(GtkWidget *widget, gpointer data) {
   RECEIVER *rx = (RECEIVER *)data;
+  ReceiverThreadContext *ctx = &rx->thread_context;
   PanadapterCache *px = &rx->panadapter_cache;
+  // the render thread may still be finishing a frame
+  g_mutex_lock(&ctx->render_mutex);
   if (px->static_surface) {
     cairo_surface_destroy(px->static_surface);
     px->static_surface = NULL;
   }
+  if (px->plot_surface) {
+    cairo_surface_destroy(px->plot_surface);
+    px->plot_surface = NULL;
+  }
+  g_mutex_lock(&ctx->frame_mutex);
+  destroy_frames(rx);
+  g_mutex_unlock(&ctx->frame_mutex);
+  g_mutex_unlock(&ctx->render_mutex);
 }
 
 GtkWidget *create_rx_panadapter(RECEIVER *rx) {
@@ -226,9 +168,11 @@ GtkWidget *create_rx_panadapter(RECEIVER *rx) {
   rx->panadapter_width = 0;
   rx->panadapter_height = 0;
   rx->panadapter_surface = NULL;
+  rx->panadapter_back = NULL;
   rx->panadapter_resize_timer = -1;
 
   px->static_surface = NULL;
+  px->plot_surface = NULL;
   px->width = 0;
   px->height = 0;
   px->zoom = -1;
@@ -239,11 +183,9 @@ GtkWidget *create_rx_panadapter(RECEIVER *rx) {
   px->panadapter_low = 0;
   px->panadapter_step = 0;
 
-  panadapter = gtk_drawing_area_new();
+  panadapter = rx->renderer->panadapter_widget(rx);
   g_signal_connect(panadapter, "realize", G_CALLBACK(panadapter_realize_cb), rx);
   g_signal_connect(panadapter, "destroy", G_CALLBACK(panadapter_destroy_cb), rx);
-  g_signal_connect(panadapter, "configure-event", G_CALLBACK(rx_panadapter_configure_event_cb), rx);
-  g_signal_connect(panadapter, "draw", G_CALLBACK(rx_panadapter_draw_cb), rx);
   g_signal_connect(panadapter, "motion-notify-event", G_CALLBACK(receiver_motion_notify_event_cb), rx);
   g_signal_connect(panadapter, "button-press-event", G_CALLBACK(receiver_button_press_event_cb), rx);
   g_signal_connect(panadapter, "button-release-event", G_CALLBACK(receiver_button_release_event_cb), rx);
@@ -261,9 +203,7 @@ GtkWidget *create_rx_panadapter(RECEIVER *rx) {
   return panadapter;
 }
 
-static void draw_static_elements(RECEIVER *rx, cairo_t *cr) {
-    int display_width = gtk_widget_get_allocated_width(rx->panadapter);
-    int display_height = gtk_widget_get_allocated_height(rx->panadapter);
+static void draw_static_elements(RECEIVER *rx, cairo_t *cr, int display_width, int display_height) {
     
     // Correct frequency calculation accounting for zoom and pan
     double hz_per_pixel = (double)rx->sample_rate / (double)(display_width * rx->zoom);
@@ -363,30 +303,31 @@ static void draw_static_elements(RECEIVER *rx, cairo_t *cr) {
         cairo_set_line_width(cr, LINE_WIDTH);
     }
 }
-// Define maximum number of points to process (same as panadapter for consistency)
-#define MAX_PLOT_POINTS 640
-
+// Runs on the receiver's render thread with render_mutex held, so only
+// cairo calls on image surfaces here, no GTK.
 void update_rx_panadapter(RECEIVER *rx, gboolean running) {
     PanadapterCache *px = &rx->panadapter_cache;
 
-    int display_width = gtk_widget_get_allocated_width(rx->panadapter);
-    int display_height = gtk_widget_get_allocated_height(rx->panadapter);
+    if (rx->panadapter_back == NULL) {
+        return;
+    }
+    int display_width = cairo_image_surface_get_width(rx->panadapter_back);
+    int display_height = cairo_image_surface_get_height(rx->panadapter_back);
     double dbm_per_line = (double)(display_height - 20) / ((double)rx->panadapter_high - (double)rx->panadapter_low); // Adjusted for bottom margin
-    int offset = rx->pan;
-    float *samples = rx->pixel_samples;
+    // pixel_samples only holds the visible slice, see receiver_set_analyzer();
+    // the render thread draws from its own slot of display_buffer
+    int samples_n = rx->display_samples_n;
+    float *samples = rx->display_samples;
     cairo_text_extents_t extents;
     char temp[32];
 
-    if (rx->panadapter_surface == NULL || display_height <= 1) {
-        fprintf(stderr, "update_rx_panadapter: early exit: surface=%p height=%d\n",
-                (void *)rx->panadapter_surface, display_height);
+    if (display_height <= 1) {
         return;
     }
     if (samples == NULL) {
         fprintf(stderr, "update_rx_panadapter: early exit: samples=NULL\n");
         return;
     }
-    samples[display_width - 1 + offset] = -200;
 
     gboolean redraw_static = FALSE;
     if (!px->static_surface ||
@@ -404,6 +345,7 @@ void update_rx_panadapter(RECEIVER *rx, gboolean running) {
         px->width = display_width;
         px->height = display_height;
         px->zoom = rx->zoom;
+        px->pan = rx->pan;
         px->frequency_a = rx->frequency_a;
         px->sample_rate = rx->sample_rate;
         px->band_a = rx->band_a;
@@ -420,159 +362,66 @@ void update_rx_panadapter(RECEIVER *rx, gboolean running) {
         cairo_t *cr_static = cairo_create(px->static_surface);
         cairo_select_font_face(cr_static, "Noto Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
         cairo_set_font_size(cr_static, 12);
-        draw_static_elements(rx, cr_static);
+        draw_static_elements(rx, cr_static, display_width, display_height);
         cairo_destroy(cr_static);
     }
 
-    cairo_t *cr = cairo_create(rx->panadapter_surface);
+    cairo_t *cr = cairo_create(rx->panadapter_back);
     cairo_select_font_face(cr, "Noto Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, 12);
     cairo_set_line_width(cr, LINE_WIDTH);
 
+    cairo_set_source_surface(cr, px->static_surface, 0, 0);
+    cairo_paint(cr);
+
     if (!running) {
         SetColour(cr, WARNING);
         cairo_set_font_size(cr, 18);
         cairo_move_to(cr, display_width / 2, display_height / 2);
         cairo_show_text(cr, "No data - receiver thread exited");
         cairo_destroy(cr);
-        gtk_widget_queue_draw(rx->panadapter);
-        fprintf(stderr, "update_rx_panadapter: receiver not running, drew warning\n");
+        swap_frames(rx);
         return;
     }
 
-    cairo_set_source_surface(cr, px->static_surface, 0, 0);
-    cairo_paint(cr);
-
     double attenuation = radio->adc[rx->adc].attenuation;
     if (radio->discovered->device == DEVICE_HERMES_LITE2) attenuation = -attenuation;
 
-    // Create pixel buffer for signal plot
-    int plot_points = MIN(display_width, MAX_PLOT_POINTS);
-    double sample_step = (double)display_width / plot_points;
-    double x_step = (double)display_width / (plot_points - 1);
-
-    // Allocate buffer for y-coordinates and outline path
-    double *y_values = g_new(double, plot_points);
-    double S9_dbm = rx->frequency_a > 30000000LL ? -93 : -73;
-    double S9_y = (rx->panadapter_high - S9_dbm) * dbm_per_line; // Y-coordinate of S9
-    double S9 = 1.0 - (S9_y / (double)(rx->panadapter_height - 20)); // Normalize to [0, 1]
-
-    // Compute y-coordinates
-    for (int i = 0; i < plot_points; i++) {
-        double sample_idx = i * sample_step + offset;
-        int idx_floor = (int)sample_idx;
-        double frac = sample_idx - idx_floor;
-        double s2;
-        if (idx_floor + 1 < rx->pixels) {
-            double s_floor = (double)samples[idx_floor] + attenuation + radio->panadapter_calibration;
-            double s_ceil = (double)samples[idx_floor + 1] + attenuation + radio->panadapter_calibration;
-            s2 = s_floor + (s_ceil - s_floor) * frac;
-        } else {
-            s2 = (double)samples[idx_floor] + attenuation + radio->panadapter_calibration;
+    // Trace, fill, peak hold and average cover the plot area above the
+    // frequency labels; the renderer rasterises or stages them
+    int plot_height = display_height - 20;
+    if (plot_height > 0) {
+        if (rx->panadapter_trace == NULL) {
+            rx->panadapter_trace = create_panadapter_trace();
         }
-        s2 = (rx->panadapter_high - s2) * dbm_per_line;
-        if (s2 >= rx->panadapter_height - 20) s2 = rx->panadapter_height - 20;
-        if (s2 < 0) s2 = 0;
-        y_values[i] = s2;
-    }
-
-    // Create image surface for filled area
-    cairo_surface_t *plot_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, display_width, display_height);
-    unsigned char *plot_data = cairo_image_surface_get_data(plot_surface);
-    int plot_stride = cairo_image_surface_get_stride(plot_surface);
-
-    // Define gradient stops
-    struct GradientStop {
-        double t;
-        double r, g, b, a;
-    };
-    struct GradientStop stops[] = {
-        {0.0, 0.0, 0.0, 0.5, 0.5},           // Dark blue
-        {S9 / 3.0, 0.0, 0.8, 0.6, 0.5},       // Green/cyan
-        {(S9 / 3.0) * 2.0, 1.0, 1.0, 0.0, 0.5}, // Yellow
-        {S9, 1.0, 0.0, 0.0, 0.5}              // Red
-    };
-    int num_stops = sizeof(stops) / sizeof(stops[0]);
-
-    // Fill image surface with signal plot
-    for (int x = 0; x < display_width; x++) {
-        double t = (double)x / x_step;
-        int i = (int)t;
-        double frac = t - i;
-        if (i + 1 >= plot_points) {
-            i = plot_points - 1;
-            frac = 0.0;
+        PANADAPTER_TRACE *trace = (PANADAPTER_TRACE *)rx->panadapter_trace;
+        if (redraw_static) {
+            panadapter_trace_reset(trace);
         }
-        double y = (1.0 - frac) * y_values[i] + frac * y_values[i + 1]; // Interpolate y
-        int y_top = (int)y;
-        if (y_top < 0) y_top = 0;
-        if (y_top >= display_height - 20) y_top = display_height - 20;
-
-        // Fill from y_top to bottom
-        for (int y_pixel = y_top; y_pixel < display_height - 20; y_pixel++) {
-            unsigned char *pixel = plot_data + y_pixel * plot_stride + x * 4; // ARGB32
-            if (rx->panadapter_gradient) {
-                // Compute gradient_t: map y_pixel to [0, 1]
-                double gradient_t = 1.0 - ((double)y_pixel / (double)(rx->panadapter_height - 20));
-                if (gradient_t < 0.0) gradient_t = 0.0;
-                if (gradient_t > 1.0) gradient_t = 1.0;
-
-                
-
-                // Interpolate between gradient stops
-                double r = 0.0, g = 0.0, b = 0.0, a = 0.5;
-                for (int s = 0; s < num_stops - 1; s++) {
-                    if (gradient_t >= stops[s].t && gradient_t <= stops[s + 1].t) {
-                        double t_norm = (gradient_t - stops[s].t) / (stops[s + 1].t - stops[s].t);
-                        r = (1.0 - t_norm) * stops[s].r + t_norm * stops[s + 1].r;
-                        g = (1.0 - t_norm) * stops[s].g + t_norm * stops[s + 1].g;
-                        b = (1.0 - t_norm) * stops[s].b + t_norm * stops[s + 1].b;
-                        a = (1.0 - t_norm) * stops[s].a + t_norm * stops[s + 1].a;
-                        break;
-                    }
-                }
-                // Handle edge case: gradient_t >= S9
-                if (gradient_t >= stops[num_stops - 1].t) {
-                    r = stops[num_stops - 1].r;
-                    g = stops[num_stops - 1].g;
-                    b = stops[num_stops - 1].b;
-                    a = stops[num_stops - 1].a;
-                }
-
-                
-                pixel[2] = (unsigned char)(r * 255); // R
-                pixel[1] = (unsigned char)(g * 255); // G
-                pixel[0] = (unsigned char)(b * 255); // B
-                pixel[3] = (unsigned char)(a * 255); // A
-            } else {
-                pixel[2] = 255; // R
-                pixel[1] = 255; // G
-                pixel[0] = 255; // B
-                pixel[3] = 128; // A (0.5)
+        double S9_dbm = rx->frequency_a > 30000000LL ? -93 : -73;
+        double S9_y = (rx->panadapter_high - S9_dbm) * dbm_per_line; // Y-coordinate of S9
+        double S9 = 1.0 - (S9_y / (double)plot_height); // Normalize to [0, 1]
+        panadapter_trace_colours(trace, plot_height, (float)S9, rx->panadapter_gradient);
+
+        double fps = frame_pacer_fps(&rx->thread_context.pacer, rx->fps);
+        panadapter_trace_update(trace, samples, samples_n, display_width,
+                                (float)(attenuation + radio->panadapter_calibration),
+                                (float)rx->panadapter_high, (float)dbm_per_line, plot_height,
+                                (float)(TRACE_PEAK_DECAY / fps));
+        // detector overlays follow the main trace in display_samples
+        int overlay = 1;
+        for (int k = 0; k < DISPLAY_DETECTORS && overlay < rx->display_traces; k++) {
+            if (rx->display_detectors & (1 << k)) {
+                panadapter_trace_detector(trace, k, samples + overlay * samples_n,
+                                          (float)(attenuation + radio->panadapter_calibration),
+                                          (float)rx->panadapter_high, (float)dbm_per_line, plot_height);
+                overlay++;
             }
         }
-    }
-
-    cairo_surface_mark_dirty(plot_surface);
 
-    // Composite plot surface
-    if (rx->panadapter_filled) {
-        cairo_set_source_surface(cr, plot_surface, 0, 0);
-        cairo_paint(cr);
+        rx->renderer->plot(rx, trace, cr, display_width, plot_height);
     }
 
-    // Draw outline
-    cairo_move_to(cr, 0.0, y_values[0]);
-    for (int i = 1; i < plot_points; i++) {
-        double x = i == plot_points - 1 ? (double)display_width : i * x_step;
-        cairo_line_to(cr, x, y_values[i]);
-    }
-    cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, 0.5);
-    cairo_stroke(cr);
-
-    g_free(y_values);
-    cairo_surface_destroy(plot_surface);
-
     // Draw filter rectangle
     cairo_set_source_rgba(cr, 0.5, 0.5, 0.5, 0.50);
     double filter_left = ((double)rx->pixels / 2.0) - (double)rx->pan + (((double)rx->filter_low_a + rx->ctun_offset) / rx->hz_per_pixel);
@@ -673,5 +522,5 @@ void update_rx_panadapter(RECEIVER *rx, gboolean running) {
     }
 
     cairo_destroy(cr);
-    gtk_widget_queue_draw(rx->panadapter);
+    swap_frames(rx);
 }
\ No newline at end of file
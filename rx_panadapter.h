@@ -19,3 +19,4 @@
 
 extern GtkWidget *create_rx_panadapter(RECEIVER *rx);
 extern void update_rx_panadapter(RECEIVER *rx,gboolean running);
+extern void rx_panadapter_resize(RECEIVER *rx,int width,int height);
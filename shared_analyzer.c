@@ -0,0 +1,296 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include <string.h>
+#include <wdsp.h>
+
+#include "bpsk.h"
+#include "discovered.h"
+#include "adc.h"
+#include "dac.h"
+#include "receiver.h"
+#include "transmitter.h"
+#include "wideband.h"
+#include "radio.h"
+#include "analyzer_policy.h"
+#include "shared_analyzer.h"
+
+//
+// Receivers on the same ADC that are tuned to the same DDC frequency with
+// the same sample rate get the same IQ, and with the same analyzer plan
+// they would run the same FFT. When enabled, one analyzer per ADC runs the
+// FFT once for the largest of their spans at full width and each receiver
+// cuts its visible slice from that, so the display FFT work no longer
+// grows with the number of receivers. Receivers whose plan differs, for
+// example at another zoom or resolution, keep their own analyzer.
+//
+// Groups are worked out on the main thread, which is also where the
+// pixels are fetched. The WDSP threads only read the receiver's role.
+//
+
+#define MAX_ADC 2
+#define UPDATE_INTERVAL_US 100000
+
+typedef struct _shared_key {
+  long long frequency;        // DDC frequency
+  int sample_rate;
+  int buffer_size;
+  int fps;
+  int fft_size;
+  double average_time;
+  int nb;
+  int nb2;
+} SHARED_KEY;
+
+typedef struct _shared_analyzer {
+  int channel;
+  gboolean created;
+  SHARED_KEY key;             // what the analyzer is set up for
+  int pixels;
+  RECEIVER *feeder;
+  int members;
+  float *frame;
+  gboolean filled;            // frame holds analyzer output, not zeros
+  guint64 serial;             // bumped each time the frame is filled
+  int request;                // in this tick's DISPLAY_PIXELS, -1 if none
+} SHARED_ANALYZER;
+
+static SHARED_ANALYZER shared[MAX_ADC];
+static gint64 last_update=0;
+
+static gboolean shared_key(RECEIVER *rx,SHARED_KEY *k) {
+  ANALYZER_PLAN *plan=(ANALYZER_PLAN *)rx->analyzer_plan;
+  if(plan==NULL || rx->pixel_samples==NULL || rx->pixels<=1) return FALSE;
+  // detector overlays are extra outputs of the receiver's own analyzer
+  if(rx->display_detectors) return FALSE;
+  // and a deep zoom receiver's analyzer only sees its own DDC output
+  if(rx->deep_zoom_ddc!=NULL) return FALSE;
+  memset(k,0,sizeof(SHARED_KEY));
+  k->frequency=rx->frequency_a-rx->lo_a+rx->error_a;
+  k->sample_rate=rx->sample_rate;
+  k->buffer_size=rx->buffer_size;
+  k->fps=rx->fps;
+  k->fft_size=plan->fft_size;
+  k->average_time=rx->display_average_time;
+  k->nb=rx->nb;
+  k->nb2=rx->nb2;
+  return TRUE;
+}
+
+static gboolean same_key(const SHARED_KEY *a,const SHARED_KEY *b) {
+  return a->frequency==b->frequency && a->sample_rate==b->sample_rate && a->buffer_size==b->buffer_size &&
+         a->fps==b->fps && a->fft_size==b->fft_size && a->average_time==b->average_time &&
+         a->nb==b->nb && a->nb2==b->nb2;
+}
+
+// Full span, no clipping, with the same plan the receivers would use
+static void configure(SHARED_ANALYZER *s,RECEIVER *rx,int pixels) {
+  int flp[] = {0};
+  int result;
+
+  if(!s->created) {
+    XCreateAnalyzer(s->channel, &result, ANALYZER_MAX_FFT, 1, 1, "");
+    if(result != 0) {
+      g_print("shared_analyzer: XCreateAnalyzer channel=%d failed: %d\n", s->channel, result);
+      return;
+    }
+    SetDisplayDetectorMode(s->channel, 0, DETECTOR_MODE_AVERAGE);
+    SetDisplayAverageMode(s->channel, 0,  AVERAGE_MODE_LOG_RECURSIVE);
+    s->created=TRUE;
+  }
+
+  // the receivers' plan, so the resolution and averaging stay the same
+  ANALYZER_PLAN *plan=(ANALYZER_PLAN *)rx->analyzer_plan;
+  int max_w = plan->fft_size + (int) fmin(0.1 * (double) rx->fps, 0.1 * (double) plan->fft_size * (double) rx->fps);
+
+  SetAnalyzer(s->channel, 1, 1, 1, flp, plan->fft_size, rx->buffer_size, 4, 14.0, plan->overlap,
+      0, 0.0, 0.0, pixels, 1, 0, 0.0, 0.0, max_w);
+  SetDisplayAvBackmult(s->channel, 0, plan->av_backmult);
+  SetDisplayNumAverage(s->channel, 0, plan->num_average);
+
+  g_free(s->frame);
+  s->frame=g_new0(float,pixels);
+  s->filled=FALSE;
+  s->pixels=pixels;
+}
+
+static void set_role(RECEIVER *rx,int role) {
+  if(g_atomic_int_get(&rx->shared_role)!=role) {
+    g_atomic_int_set(&rx->shared_role,role);
+  }
+}
+
+static void update_adc(RADIO *r,int adc) {
+  SHARED_ANALYZER *s=&shared[adc];
+  SHARED_KEY keys[MAX_RECEIVERS];
+  gboolean valid[MAX_RECEIVERS];
+  int i, j;
+  int best=-1, best_count=1;
+
+  for(i=0;i<MAX_RECEIVERS;i++) {
+    RECEIVER *rx=r->receiver[i];
+    valid[i]=r->shared_analyzer && rx!=NULL && rx->adc==adc && shared_key(rx,&keys[i]);
+  }
+
+  // the largest group of receivers that would run the same FFT
+  for(i=0;i<MAX_RECEIVERS;i++) {
+    if(!valid[i]) continue;
+    int count=0;
+    for(j=0;j<MAX_RECEIVERS;j++) {
+      if(valid[j] && same_key(&keys[i],&keys[j])) count++;
+    }
+    if(count>best_count) {
+      best=i;
+      best_count=count;
+    }
+  }
+
+  int pixels=0;
+  if(best>=0) {
+    for(i=0;i<MAX_RECEIVERS;i++) {
+      if(valid[i] && same_key(&keys[best],&keys[i]) && r->receiver[i]->pixels>pixels) {
+        pixels=r->receiver[i]->pixels;
+      }
+    }
+    if(pixels>SHARED_ANALYZER_MAX_PIXELS) best=-1;
+  }
+
+  if(best<0) {
+    for(i=0;i<MAX_RECEIVERS;i++) {
+      if(r->receiver[i]!=NULL && r->receiver[i]->adc==adc) set_role(r->receiver[i],SHARED_NONE);
+    }
+    s->feeder=NULL;
+    s->members=0;
+    return;
+  }
+
+  if(!s->created || pixels!=s->pixels || !same_key(&s->key,&keys[best])) {
+    s->key=keys[best];
+    configure(s,r->receiver[best],pixels);
+    if(!s->created) return;
+  }
+
+  // keep the feeder while it stays in the group
+  RECEIVER *feeder=NULL;
+  for(i=0;i<MAX_RECEIVERS;i++) {
+    if(valid[i] && same_key(&keys[best],&keys[i]) && (feeder==NULL || r->receiver[i]==s->feeder)) {
+      feeder=r->receiver[i];
+    }
+  }
+  s->feeder=feeder;
+  s->members=best_count;
+  for(i=0;i<MAX_RECEIVERS;i++) {
+    RECEIVER *rx=r->receiver[i];
+    if(rx==NULL || rx->adc!=adc) continue;
+    if(valid[i] && same_key(&keys[best],&keys[i])) {
+      set_role(rx,rx==feeder?SHARED_FEEDER:SHARED_MEMBER);
+    } else {
+      set_role(rx,SHARED_NONE);
+    }
+  }
+}
+
+void shared_analyzer_update(RADIO *r) {
+  int adc;
+  gint64 now=g_get_monotonic_time();
+
+  if(now-last_update<UPDATE_INTERVAL_US) return;
+  last_update=now;
+  for(adc=0;adc<MAX_ADC;adc++) {
+    shared[adc].channel=SHARED_ANALYZER_BASE_CHANNEL+adc;
+    update_adc(r,adc);
+  }
+}
+
+// The shared frames are fetched with the rest of the radio's displays
+void shared_analyzer_request(DISPLAY_PIXELS *p) {
+  int adc;
+  for(adc=0;adc<MAX_ADC;adc++) {
+    SHARED_ANALYZER *s=&shared[adc];
+    s->request=s->frame!=NULL && s->feeder!=NULL?display_pixels_request(p,s->channel,0,s->frame):-1;
+  }
+}
+
+void shared_analyzer_collected(DISPLAY_PIXELS *p) {
+  int adc;
+  for(adc=0;adc<MAX_ADC;adc++) {
+    if(display_pixels_ready(p,shared[adc].request)) {
+      shared[adc].filled=TRUE;
+      shared[adc].serial++;
+    }
+  }
+}
+
+// Called by the receiver's WDSP thread instead of feeding its own analyzer
+gboolean shared_analyzer_feed(RECEIVER *rx,double *iq) {
+  switch(g_atomic_int_get(&rx->shared_role)) {
+    case SHARED_FEEDER:
+      Spectrum0(1, SHARED_ANALYZER_BASE_CHANNEL+rx->adc, 0, 0, iq);
+      return TRUE;
+    case SHARED_MEMBER:
+      return TRUE;
+  }
+  return FALSE;
+}
+
+//
+// Cut the receiver's visible slice out of the latest shared full span frame.
+// Pixel i of an n pixel span sits at i/(n-1) of the span, so the same
+// frequency is found at a scaled position in the shared frame; several
+// shared pixels per receiver pixel are averaged, fewer are interpolated.
+// Returns TRUE if there was a frame the receiver had not seen.
+//
+gboolean shared_analyzer_pixels(RECEIVER *rx,float *pixels) {
+  SHARED_ANALYZER *s=&shared[rx->adc];
+  int x;
+
+  if(s->frame==NULL || !s->filled) return FALSE;
+  if(rx->shared_serial==s->serial) return FALSE;
+  rx->shared_serial=s->serial;
+
+  int n=rx->analyzer_pixels;
+  int pan=rx->pan;
+  if(pan>rx->pixels-n) pan=rx->pixels-n;
+  if(pan<0) pan=0;
+  double scale=(double)(s->pixels-1)/(double)(rx->pixels-1);
+
+  for(x=0;x<n;x++) {
+    double p=(double)(pan+x)*scale;
+    int i0=(int)p;
+    if(scale>1.0) {
+      int i1=(int)(p+scale);
+      if(i1>s->pixels) i1=s->pixels;
+      float sum=0.0f;
+      int i;
+      for(i=i0;i<i1;i++) sum+=s->frame[i];
+      pixels[x]=i1>i0?sum/(float)(i1-i0):s->frame[i0];
+    } else {
+      float frac=(float)(p-(double)i0);
+      int i1=i0+1<s->pixels?i0+1:i0;
+      pixels[x]=s->frame[i0]+(s->frame[i1]-s->frame[i0])*frac;
+    }
+  }
+  return TRUE;
+}
+
+int shared_analyzer_members(int adc) {
+  return adc>=0 && adc<MAX_ADC && shared[adc].feeder!=NULL?shared[adc].members:0;
+}
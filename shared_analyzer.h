@@ -0,0 +1,38 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _SHARED_ANALYZER_H
+#define _SHARED_ANALYZER_H
+
+#define SHARED_ANALYZER_BASE_CHANNEL 24   // WDSP display per ADC, after the subrx channels
+#define SHARED_ANALYZER_MAX_PIXELS 16384  // dMAX_PIXELS in the analyzer
+
+// RECEIVER shared_role
+#define SHARED_NONE 0       // the receiver runs its own analyzer
+#define SHARED_FEEDER 1     // its IQ feeds the shared analyzer
+#define SHARED_MEMBER 2     // it only cuts its span from the shared analyzer
+
+extern void shared_analyzer_update(RADIO *r);
+extern gboolean shared_analyzer_feed(RECEIVER *rx,double *iq);
+extern void shared_analyzer_request(DISPLAY_PIXELS *p);
+extern void shared_analyzer_collected(DISPLAY_PIXELS *p);
+extern gboolean shared_analyzer_pixels(RECEIVER *rx,float *pixels);
+extern int shared_analyzer_members(int adc);
+
+#endif
@@ -0,0 +1,217 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+//
+// Reference client for the spectrum server, also used as a load test:
+//
+//   spectrum_client [-h host] [-p port] [-r receiver] [-f fps] [-w width]
+//                   [-n clients] [-t seconds]
+//
+// With one client every frame is printed. With more, the clients only
+// decode and a summary is printed at the end.
+//
+
+#include <glib.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "spectrum_frame.h"
+
+#define BUFFER_SIZE 65536
+
+typedef struct _client {
+  int fd;
+  guint8 buffer[BUFFER_SIZE];
+  int length;
+  SPECTRUM_FRAME frame;
+  guint8 pixels[SPECTRUM_MAX_WIDTH];
+  gboolean started;
+  guint64 frames;
+  guint64 keys;
+  guint64 bytes;
+  guint64 gaps;
+  guint64 missed;             // frames the server dropped, from the gaps
+  guint64 errors;
+  gint64 first_time;          // arrival of the first and last frame
+  gint64 last_time;
+} CLIENT;
+
+static int connect_to(const char *host,int port) {
+  struct addrinfo hints, *result, *rp;
+  char service[16];
+  int fd=-1;
+
+  memset(&hints,0,sizeof(hints));
+  hints.ai_family=AF_UNSPEC;
+  hints.ai_socktype=SOCK_STREAM;
+  snprintf(service,sizeof(service),"%d",port);
+  if(getaddrinfo(host,service,&hints,&result)!=0) return -1;
+  for(rp=result;rp!=NULL;rp=rp->ai_next) {
+    fd=socket(rp->ai_family,rp->ai_socktype,rp->ai_protocol);
+    if(fd<0) continue;
+    if(connect(fd,rp->ai_addr,rp->ai_addrlen)==0) break;
+    close(fd);
+    fd=-1;
+  }
+  freeaddrinfo(result);
+  return fd;
+}
+
+static void print_frame(CLIENT *c,int length) {
+  SPECTRUM_FRAME *f=&c->frame;
+  int i, peak=0;
+  for(i=1;i<f->width;i++) {
+    if(c->pixels[i]>c->pixels[peak]) peak=i;
+  }
+  printf("rx %d seq %u %s %4d bytes width %d start %.6f MHz peak %.1f dB at %.6f MHz meter %.1f dBm\n",
+      f->receiver,f->sequence,f->type==SPECTRUM_FRAME_KEY?"key  ":"delta",length,f->width,
+      (double)f->start_hz/1e6,spectrum_dequantise(c->pixels[peak]),
+      ((double)f->start_hz+(double)peak*f->hz_per_pixel)/1e6,f->meter_db);
+}
+
+// Returns FALSE when the connection has gone
+static gboolean client_read(CLIENT *c,gboolean verbose) {
+  ssize_t n=recv(c->fd,c->buffer+c->length,BUFFER_SIZE-c->length,0);
+  int used=0;
+
+  if(n<=0) return n<0 && errno==EINTR;
+  c->length+=n;
+  c->bytes+=n;
+  for(;;) {
+    guint32 previous=c->frame.sequence;
+    int length=spectrum_frame_decode(c->buffer+used,c->length-used,&c->frame,c->pixels);
+    if(length==0) break;
+    if(length<0) {
+      c->errors++;
+      return FALSE;
+    }
+    if(c->started && c->frame.sequence!=previous+1) {
+      c->gaps++;
+      c->missed+=(guint32)(c->frame.sequence-previous-1);
+    }
+    c->last_time=g_get_monotonic_time();
+    if(!c->started) c->first_time=c->last_time;
+    c->started=TRUE;
+    c->frames++;
+    if(c->frame.type==SPECTRUM_FRAME_KEY) c->keys++;
+    if(verbose) print_frame(c,length);
+    used+=length;
+  }
+  memmove(c->buffer,c->buffer+used,c->length-used);
+  c->length-=used;
+  return TRUE;
+}
+
+int main(int argc,char **argv) {
+  const char *host="localhost";
+  int port=SPECTRUM_SERVER_PORT;
+  int receiver=0;
+  int fps=25;
+  int width=1024;
+  int count=1;
+  int seconds=10;
+  int opt, i;
+
+  while((opt=getopt(argc,argv,"h:p:r:f:w:n:t:"))!=-1) {
+    switch(opt) {
+      case 'h': host=optarg; break;
+      case 'p': port=atoi(optarg); break;
+      case 'r': receiver=atoi(optarg); break;
+      case 'f': fps=atoi(optarg); break;
+      case 'w': width=atoi(optarg); break;
+      case 'n': count=atoi(optarg); break;
+      case 't': seconds=atoi(optarg); break;
+      default:
+        fprintf(stderr,"usage: %s [-h host] [-p port] [-r receiver] [-f fps] [-w width] [-n clients] [-t seconds]\n",argv[0]);
+        return 1;
+    }
+  }
+  if(count<1) count=1;
+
+  CLIENT *client=g_new0(CLIENT,count);
+  struct pollfd *fds=g_new0(struct pollfd,count);
+  for(i=0;i<count;i++) {
+    char command[64];
+    client[i].fd=connect_to(host,port);
+    if(client[i].fd<0) {
+      fprintf(stderr,"client %d: cannot connect to %s:%d\n",i,host,port);
+      return 1;
+    }
+    int n=snprintf(command,sizeof(command),"SUBSCRIBE %d %d %d\n",receiver,fps,width);
+    if(write(client[i].fd,command,n)!=n) {
+      fprintf(stderr,"client %d: subscribe failed\n",i);
+      return 1;
+    }
+    fds[i].fd=client[i].fd;
+    fds[i].events=POLLIN;
+  }
+
+  gint64 start=g_get_monotonic_time();
+  gint64 end=start+(gint64)seconds*G_USEC_PER_SEC;
+  int open=count;
+  while(open>0 && g_get_monotonic_time()<end) {
+    if(poll(fds,count,100)<0 && errno!=EINTR) break;
+    for(i=0;i<count;i++) {
+      if(fds[i].fd>=0 && (fds[i].revents&(POLLIN|POLLHUP|POLLERR))) {
+        if(!client_read(&client[i],count==1)) {
+          fprintf(stderr,"client %d: connection closed\n",i);
+          close(fds[i].fd);
+          fds[i].fd=-1;
+          open--;
+        }
+      }
+    }
+  }
+  double elapsed=(double)(g_get_monotonic_time()-start)/1e6;
+
+  guint64 frames=0, keys=0, bytes=0, gaps=0, missed=0, errors=0;
+  double total_fps=0.0, min_fps=1e9;
+  for(i=0;i<count;i++) {
+    CLIENT *c=&client[i];
+    // the rate frames arrived at, from the first to the last one received
+    double received=0.0;
+    if(c->frames>1 && c->last_time>c->first_time) {
+      received=(double)(c->frames-1)*1e6/(double)(c->last_time-c->first_time);
+    }
+    total_fps+=received;
+    if(received<min_fps) min_fps=received;
+    frames+=c->frames;
+    keys+=c->keys;
+    bytes+=c->bytes;
+    gaps+=c->gaps;
+    missed+=c->missed;
+    errors+=c->errors;
+    if(fds[i].fd>=0) close(fds[i].fd);
+  }
+  printf("%d clients, %.1f s: asked for %d fps, received %.1f fps per client (min %.1f), %.1f kB/s per client, %.0f bytes per frame\n",
+      count,elapsed,fps,total_fps/count,min_fps,bytes/elapsed/count/1000.0,frames>0?(double)bytes/frames:0.0);
+  printf("%llu frames, %llu key frames, %llu sequence gaps, %llu frames dropped by the server, %llu decode errors\n",
+      (unsigned long long)frames,(unsigned long long)keys,(unsigned long long)gaps,(unsigned long long)missed,
+      (unsigned long long)errors);
+  g_free(fds);
+  g_free(client);
+  return errors>0?1:0;
+}
@@ -0,0 +1,171 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <glib.h>
+#include <string.h>
+
+#include "spectrum_frame.h"
+
+static void put16(guint8 *p,guint16 v) {
+  p[0]=v; p[1]=v>>8;
+}
+
+static void put32(guint8 *p,guint32 v) {
+  put16(p,v); put16(p+2,v>>16);
+}
+
+static void put64(guint8 *p,guint64 v) {
+  put32(p,(guint32)v); put32(p+4,(guint32)(v>>32));
+}
+
+static guint16 get16(const guint8 *p) {
+  return p[0]|(p[1]<<8);
+}
+
+static guint32 get32(const guint8 *p) {
+  return get16(p)|((guint32)get16(p+2)<<16);
+}
+
+static guint64 get64(const guint8 *p) {
+  return get32(p)|((guint64)get32(p+4)<<32);
+}
+
+guint8 spectrum_quantise(float db) {
+  float q=(db-SPECTRUM_DB_MIN)*(1.0f/SPECTRUM_DB_STEP)+0.5f;
+  q=q<0.0f?0.0f:(q>255.0f?255.0f:q);
+  return (guint8)q;
+}
+
+float spectrum_dequantise(guint8 q) {
+  return SPECTRUM_DB_MIN+(float)q*SPECTRUM_DB_STEP;
+}
+
+// Run length coded difference from the previous frame, or -1 if that
+// would not be smaller than a key frame
+static int encode_delta(guint8 *out,int width,const guint8 *pixels,const guint8 *previous) {
+  int n=0;
+  int i=0;
+
+  while(i<width) {
+    if(pixels[i]==previous[i]) {
+      int run=0;
+      while(i<width && run<255 && pixels[i]==previous[i]) {
+        run++;
+        i++;
+      }
+      if(n+2>=width) return -1;
+      out[n++]=0;
+      out[n++]=run;
+    } else {
+      if(n+1>=width) return -1;
+      out[n++]=pixels[i]-previous[i];
+      i++;
+    }
+  }
+  return n;
+}
+
+//
+// Write a frame of f->width pixels to out, which must hold
+// SPECTRUM_FRAME_HEADER+f->width bytes. A delta against previous is sent
+// if it is given and smaller. Sets f->type and returns the frame length.
+//
+int spectrum_frame_encode(guint8 *out,SPECTRUM_FRAME *f,const guint8 *pixels,const guint8 *previous) {
+  guint8 *payload=out+SPECTRUM_FRAME_HEADER;
+  int length=-1;
+
+  if(previous!=NULL) {
+    length=encode_delta(payload,f->width,pixels,previous);
+  }
+  if(length<0) {
+    memcpy(payload,pixels,f->width);
+    length=f->width;
+    f->type=SPECTRUM_FRAME_KEY;
+  } else {
+    f->type=SPECTRUM_FRAME_DELTA;
+  }
+
+  float meter=f->meter_db*10.0f;
+  meter=meter<-32768.0f?-32768.0f:(meter>32767.0f?32767.0f:meter);
+
+  out[0]='L';
+  out[1]='S';
+  out[2]=SPECTRUM_FRAME_VERSION;
+  out[3]=f->type;
+  out[4]=f->receiver;
+  out[5]=0;
+  put16(out+6,f->width);
+  put32(out+8,f->sequence);
+  put64(out+12,(guint64)f->start_hz);
+  put32(out+20,(guint32)(f->hz_per_pixel*1000.0+0.5));
+  put16(out+24,(guint16)(gint16)meter);
+  put16(out+26,0);
+  put32(out+28,length);
+  return SPECTRUM_FRAME_HEADER+length;
+}
+
+//
+// Decode one frame from in. pixels holds the previous frame and is
+// updated in place, so a client keeps one buffer per receiver. Returns
+// the number of bytes used, 0 if more bytes are needed or -1 if the
+// stream is not valid, which includes a delta of a different width.
+//
+int spectrum_frame_decode(const guint8 *in,int length,SPECTRUM_FRAME *f,guint8 *pixels) {
+  int previous_width=f->width;
+  int i, n;
+
+  if(length<SPECTRUM_FRAME_HEADER) return 0;
+  if(in[0]!='L' || in[1]!='S' || in[2]!=SPECTRUM_FRAME_VERSION) return -1;
+  guint32 payload=get32(in+28);
+  if(payload>SPECTRUM_MAX_WIDTH) return -1;
+  if(length<SPECTRUM_FRAME_HEADER+(int)payload) return 0;
+
+  f->type=in[3];
+  f->receiver=in[4];
+  f->width=get16(in+6);
+  f->sequence=get32(in+8);
+  f->start_hz=(gint64)get64(in+12);
+  f->hz_per_pixel=(double)get32(in+20)/1000.0;
+  f->meter_db=(float)(gint16)get16(in+24)/10.0f;
+  if(f->width>SPECTRUM_MAX_WIDTH) return -1;
+
+  const guint8 *p=in+SPECTRUM_FRAME_HEADER;
+  switch(f->type) {
+    case SPECTRUM_FRAME_KEY:
+      if((int)payload!=f->width) return -1;
+      memcpy(pixels,p,f->width);
+      break;
+    case SPECTRUM_FRAME_DELTA:
+      if(f->width!=previous_width) return -1;
+      for(i=0,n=0;n<(int)payload;n++) {
+        if(p[n]==0) {
+          if(n+1>=(int)payload) return -1;
+          i+=p[++n];
+        } else {
+          if(i>=f->width) return -1;
+          pixels[i++]+=p[n];
+        }
+      }
+      if(i!=f->width) return -1;
+      break;
+    default:
+      return -1;
+  }
+  return SPECTRUM_FRAME_HEADER+payload;
+}
@@ -0,0 +1,72 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _SPECTRUM_FRAME_H
+#define _SPECTRUM_FRAME_H
+
+//
+// Spectrum frames as sent by the spectrum server. All values are little
+// endian. A frame is a 32 byte header followed by 'length' bytes:
+//
+//   0  'L' 'S'
+//   2  version
+//   3  type, SPECTRUM_FRAME_KEY or SPECTRUM_FRAME_DELTA
+//   4  receiver channel
+//   5  reserved
+//   6  width (pixels)
+//   8  sequence, counts frames due to this client, a gap is a dropped frame
+//  12  frequency of the first pixel (Hz, int64)
+//  20  pixel spacing (mHz, uint32)
+//  24  S meter (0.1 dBm, int16)
+//  26  reserved
+//  28  payload length (uint32)
+//
+// Pixels are quantised to one byte, SPECTRUM_DB_MIN + q * SPECTRUM_DB_STEP.
+// A key frame payload is the width pixels. A delta frame holds, for each
+// pixel, the byte difference from the previous frame modulo 256; runs of
+// unchanged pixels are written as 0 followed by the run length (1-255).
+//
+
+#define SPECTRUM_SERVER_PORT 19300
+#define SPECTRUM_FRAME_VERSION 1
+#define SPECTRUM_FRAME_HEADER 32
+#define SPECTRUM_FRAME_KEY 1
+#define SPECTRUM_FRAME_DELTA 2
+#define SPECTRUM_MAX_WIDTH 4096
+#define SPECTRUM_FRAME_MAX (SPECTRUM_FRAME_HEADER+SPECTRUM_MAX_WIDTH)
+
+#define SPECTRUM_DB_MIN -180.0f
+#define SPECTRUM_DB_STEP 0.75f
+
+typedef struct _spectrum_frame {
+  gint type;
+  gint receiver;
+  gint width;
+  guint32 sequence;
+  gint64 start_hz;
+  gdouble hz_per_pixel;
+  gfloat meter_db;
+} SPECTRUM_FRAME;
+
+extern guint8 spectrum_quantise(float db);
+extern float spectrum_dequantise(guint8 q);
+extern int spectrum_frame_encode(guint8 *out,SPECTRUM_FRAME *f,const guint8 *pixels,const guint8 *previous);
+extern int spectrum_frame_decode(const guint8 *in,int length,SPECTRUM_FRAME *f,guint8 *pixels);
+
+#endif
@@ -0,0 +1,267 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+
+#include "spectrum_history.h"
+
+//
+// Spectrum history. Every analyzer frame is resampled to HISTORY_BINS,
+// quantised to one byte per bin and appended to a ring of rows in a
+// memory mapped file, together with its time and the absolute frequency
+// of its first bin. Coarser levels hold the maximum over 8 rows of the
+// level below and over pairs of bins, so hours of history can be drawn
+// at a lower time resolution. Rows are written and read by the
+// receiver's render thread only.
+//
+
+#define HISTORY_MAGIC 0x4C485354    // "LHST"
+#define HISTORY_VERSION 1
+
+typedef struct _history_header {
+  guint32 magic;
+  guint32 version;
+  guint32 bins;
+  guint32 levels;
+  guint32 rows;
+  guint32 pad;
+  guint64 serial[HISTORY_LEVELS];   // rows ever written per level
+} HISTORY_HEADER;
+
+typedef struct _history_row {
+  gint64 time_us;
+  gdouble start_hz;                 // absolute frequency of bin 0
+  gdouble hz_per_bin;
+  guchar db[];
+} HISTORY_ROW;
+
+static HISTORY_ROW *level_row(HISTORY_LEVEL *l,guint64 serial) {
+  return (HISTORY_ROW *)(l->rows+(serial%HISTORY_ROWS)*l->row_size);
+}
+
+SPECTRUM_HISTORY *create_spectrum_history(const char *path) {
+  gsize size=sizeof(HISTORY_HEADER);
+  int i;
+
+  for(i=0;i<HISTORY_LEVELS;i++) {
+    size+=(gsize)HISTORY_ROWS*(sizeof(HISTORY_ROW)+(HISTORY_BINS>>i));
+  }
+
+  int fd=open(path,O_RDWR|O_CREAT,0644);
+  if(fd<0) {
+    g_print("create_spectrum_history: cannot open %s\n",path);
+    return NULL;
+  }
+  // another instance may be using this receiver's history
+  if(flock(fd,LOCK_EX|LOCK_NB)!=0 || ftruncate(fd,(off_t)size)!=0) {
+    g_print("create_spectrum_history: cannot use %s\n",path);
+    close(fd);
+    return NULL;
+  }
+  void *map=mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+  if(map==MAP_FAILED) {
+    g_print("create_spectrum_history: mmap %s failed\n",path);
+    close(fd);
+    return NULL;
+  }
+
+  SPECTRUM_HISTORY *h=g_new0(SPECTRUM_HISTORY,1);
+  h->fd=fd;
+  h->size=size;
+  h->map=map;
+  h->header=(HISTORY_HEADER *)map;
+  if(h->header->magic!=HISTORY_MAGIC || h->header->version!=HISTORY_VERSION ||
+     h->header->bins!=HISTORY_BINS || h->header->levels!=HISTORY_LEVELS || h->header->rows!=HISTORY_ROWS) {
+    // new file or different layout, start empty
+    memset(h->header,0,sizeof(HISTORY_HEADER));
+    h->header->magic=HISTORY_MAGIC;
+    h->header->version=HISTORY_VERSION;
+    h->header->bins=HISTORY_BINS;
+    h->header->levels=HISTORY_LEVELS;
+    h->header->rows=HISTORY_ROWS;
+  }
+
+  guchar *p=(guchar *)map+sizeof(HISTORY_HEADER);
+  for(i=0;i<HISTORY_LEVELS;i++) {
+    HISTORY_LEVEL *l=&h->level[i];
+    l->bins=HISTORY_BINS>>i;
+    l->row_size=sizeof(HISTORY_ROW)+l->bins;
+    l->rows=p;
+    l->acc=g_new0(guchar,l->bins);
+    p+=(gsize)HISTORY_ROWS*l->row_size;
+  }
+  h->scratch=g_new(guchar,HISTORY_BINS);
+  return h;
+}
+
+void destroy_spectrum_history(SPECTRUM_HISTORY *h) {
+  int i;
+  for(i=0;i<HISTORY_LEVELS;i++) {
+    g_free(h->level[i].acc);
+  }
+  g_free(h->scratch);
+  munmap(h->map,h->size);
+  close(h->fd);
+  g_free(h);
+}
+
+guint64 spectrum_history_serial(SPECTRUM_HISTORY *h,int level) {
+  return h->header->serial[level];
+}
+
+static void level_append(SPECTRUM_HISTORY *h,int level,gint64 time_us,double start_hz,double hz_per_bin,const guchar *db);
+
+static void level_flush(SPECTRUM_HISTORY *h,int level) {
+  HISTORY_LEVEL *l=&h->level[level];
+  if(l->acc_count==0) return;
+  l->acc_count=0;
+  level_append(h,level,l->acc_time,l->acc_start,l->acc_hz_per_bin,l->acc);
+}
+
+// fold a row of the level below into this level's pending row
+static void level_aggregate(SPECTRUM_HISTORY *h,int level,gint64 time_us,double start_hz,double hz_per_bin,const guchar *db) {
+  HISTORY_LEVEL *l=&h->level[level];
+  int i;
+
+  // a retune or zoom starts a new row
+  if(l->acc_count>0 && (l->acc_start!=start_hz || l->acc_hz_per_bin!=hz_per_bin*2.0)) {
+    level_flush(h,level);
+  }
+  if(l->acc_count==0) {
+    memset(l->acc,0,l->bins);
+    l->acc_start=start_hz;
+    l->acc_hz_per_bin=hz_per_bin*2.0;
+  }
+  for(i=0;i<l->bins;i++) {
+    guchar a=db[i*2]>db[i*2+1]?db[i*2]:db[i*2+1];
+    l->acc[i]=a>l->acc[i]?a:l->acc[i];
+  }
+  l->acc_time=time_us;
+  if(++l->acc_count==HISTORY_TIME_FACTOR) {
+    level_flush(h,level);
+  }
+}
+
+static void level_append(SPECTRUM_HISTORY *h,int level,gint64 time_us,double start_hz,double hz_per_bin,const guchar *db) {
+  HISTORY_LEVEL *l=&h->level[level];
+  HISTORY_ROW *row=level_row(l,h->header->serial[level]);
+
+  row->time_us=time_us;
+  row->start_hz=start_hz;
+  row->hz_per_bin=hz_per_bin;
+  memcpy(row->db,db,l->bins);
+  h->header->serial[level]++;
+
+  if(level+1<HISTORY_LEVELS) {
+    level_aggregate(h,level+1,time_us,start_hz,hz_per_bin,row->db);
+  }
+}
+
+static inline guchar quantise(float db) {
+  float q=(db-HISTORY_DB_MIN)*(1.0f/HISTORY_DB_STEP);
+  q=q<0.0f?0.0f:(q>255.0f?255.0f:q);
+  return (guchar)q;
+}
+
+void spectrum_history_add(SPECTRUM_HISTORY *h,gint64 time_us,double start_hz,double hz_per_sample,const float *db,int n) {
+  guchar *q=h->scratch;
+  int b, i;
+
+  if(n<=0) return;
+  if(n>=HISTORY_BINS) {
+    // keep the maximum of the samples in each bin
+    for(b=0;b<HISTORY_BINS;b++) {
+      int first=(int)((long long)b*n/HISTORY_BINS);
+      int last=(int)((long long)(b+1)*n/HISTORY_BINS);
+      float m=db[first];
+      for(i=first+1;i<last;i++) {
+        m=db[i]>m?db[i]:m;
+      }
+      q[b]=quantise(m);
+    }
+  } else {
+    for(b=0;b<HISTORY_BINS;b++) {
+      q[b]=quantise(db[(int)((long long)b*n/HISTORY_BINS)]);
+    }
+  }
+  level_append(h,0,time_us,start_hz,hz_per_sample*(double)n/(double)HISTORY_BINS,q);
+}
+
+//
+// Rows are addressed by serial number. spectrum_history_find returns one
+// past the newest row of 'level' not newer than before_us, so rows are
+// read going back from there with --serial.
+//
+guint64 spectrum_history_find(SPECTRUM_HISTORY *h,int level,gint64 before_us) {
+  HISTORY_LEVEL *l=&h->level[level];
+  guint64 serial=h->header->serial[level];
+  guint64 lo=serial<HISTORY_ROWS?0:serial-HISTORY_ROWS;
+  guint64 hi=serial;
+
+  while(lo<hi) {
+    guint64 mid=lo+(hi-lo)/2;
+    if(level_row(l,mid)->time_us<=before_us) {
+      lo=mid+1;
+    } else {
+      hi=mid;
+    }
+  }
+  return lo;
+}
+
+//
+// Resample row 'serial' of 'level' to 'width' pixels of hz_per_pixel
+// starting at start_hz, keeping the strongest bin under each pixel.
+// Pixels the row did not cover are set to HISTORY_DB_MIN. Returns FALSE
+// if the row has been overwritten or not written yet.
+//
+gboolean spectrum_history_row(SPECTRUM_HISTORY *h,int level,guint64 serial,double start_hz,double hz_per_pixel,
+    int width,float *db) {
+  HISTORY_LEVEL *l=&h->level[level];
+  guint64 newest=h->header->serial[level];
+  int x, b;
+
+  if(serial>=newest || newest-serial>HISTORY_ROWS) return FALSE;
+
+  HISTORY_ROW *row=level_row(l,serial);
+  double scale=hz_per_pixel/row->hz_per_bin;
+  double first=(start_hz-row->start_hz)/row->hz_per_bin;
+  for(x=0;x<width;x++) {
+    double f0=first+(double)x*scale;
+    double f1=f0+scale;
+    if(f1<=0.0 || f0>=(double)l->bins) {
+      db[x]=HISTORY_DB_MIN;
+      continue;
+    }
+    int b0=f0<0.0?0:(int)f0;
+    int b1=f1>(double)l->bins?l->bins:(int)f1;
+    if(b1<=b0) b1=b0+1;
+    guchar m=row->db[b0];
+    for(b=b0+1;b<b1;b++) {
+      m=row->db[b]>m?row->db[b]:m;
+    }
+    db[x]=HISTORY_DB_MIN+(float)m*HISTORY_DB_STEP;
+  }
+  return TRUE;
+}
@@ -0,0 +1,59 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _SPECTRUM_HISTORY_H
+#define _SPECTRUM_HISTORY_H
+
+#define HISTORY_BINS 2048           // bins per row at level 0
+#define HISTORY_LEVELS 4            // level n: 8^n frames, HISTORY_BINS>>n bins
+#define HISTORY_TIME_FACTOR 8
+#define HISTORY_ROWS 8192           // rows kept per level
+#define HISTORY_DB_MIN -180.0f      // quantised as (db-MIN)/STEP in a byte
+#define HISTORY_DB_STEP 0.625f
+
+typedef struct _history_level {
+  gint bins;
+  gsize row_size;
+  guchar *rows;                     // HISTORY_ROWS rows in the mapped file
+  // pending aggregate of the level below
+  guchar *acc;
+  gint acc_count;
+  gint64 acc_time;
+  gdouble acc_start;
+  gdouble acc_hz_per_bin;
+} HISTORY_LEVEL;
+
+typedef struct _spectrum_history {
+  int fd;
+  gsize size;
+  void *map;
+  struct _history_header *header;
+  HISTORY_LEVEL level[HISTORY_LEVELS];
+  guchar *scratch;
+} SPECTRUM_HISTORY;
+
+extern SPECTRUM_HISTORY *create_spectrum_history(const char *path);
+extern void destroy_spectrum_history(SPECTRUM_HISTORY *h);
+extern void spectrum_history_add(SPECTRUM_HISTORY *h,gint64 time_us,double start_hz,double hz_per_sample,const float *db,int n);
+extern guint64 spectrum_history_serial(SPECTRUM_HISTORY *h,int level);
+extern guint64 spectrum_history_find(SPECTRUM_HISTORY *h,int level,gint64 before_us);
+extern gboolean spectrum_history_row(SPECTRUM_HISTORY *h,int level,guint64 serial,double start_hz,double hz_per_pixel,
+    int width,float *db);
+
+#endif
@@ -0,0 +1,426 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "bpsk.h"
+#include "discovered.h"
+#include "adc.h"
+#include "dac.h"
+#include "receiver.h"
+#include "transmitter.h"
+#include "wideband.h"
+#include "radio.h"
+#include "spectrum_frame.h"
+#include "spectrum_server.h"
+
+//
+// Headless spectrum streaming. The receivers' update timers publish each
+// analyzer frame and S meter reading here; one server thread accepts
+// clients and sends each of them the receiver it asked for, resampled to
+// its width at its frame rate, as quantised key and delta frames (see
+// spectrum_frame.h).
+//
+// A client sends text lines:
+//
+//   SUBSCRIBE <receiver> <fps> <width>
+//   UNSUBSCRIBE
+//
+// A client that has not taken the previous frame off its socket skips
+// frames rather than queueing them.
+//
+// The server thread sleeps in poll() until a client talks, a receiver
+// with subscribers publishes a frame, or a client's next frame is due.
+//
+
+#define KEY_INTERVAL 50         // frames between key frames
+#define MAX_FPS 60
+#define MIN_WIDTH 16
+#define COMMAND_SIZE 128
+#define SEND_BUFFER_FRAMES 4
+
+typedef struct _spectrum_source {
+  guint32 serial;
+  gint n;
+  gint size;
+  gfloat *samples;
+  gint64 start_hz;
+  gdouble hz_per_sample;
+  gfloat meter_db;
+} SPECTRUM_SOURCE;
+
+typedef struct _spectrum_client {
+  int fd;
+  char command[COMMAND_SIZE];
+  int command_length;
+
+  gint receiver;              // -1 until subscribed
+  gint fps;
+  gint width;
+  gint64 next_time;
+  guint32 serial;             // source frame last taken
+  guint32 sequence;           // frames due so far, sent or dropped
+  gint since_key;
+  gint64 start_hz;
+  gdouble hz_per_pixel;
+  guint8 *pixels;
+  guint8 *previous;
+  gboolean have_previous;
+
+  guint8 *out;                // frame being written
+  gint out_length;
+  gint out_written;
+} SPECTRUM_CLIENT;
+
+static GMutex source_mutex;
+static SPECTRUM_SOURCE source[MAX_RECEIVERS];
+
+static GThread *server_thread=NULL;
+static int server_socket=-1;
+static int wake_pipe[2]={-1,-1};
+static gint running=0;
+static gint wake_pending=0;
+static gint subscribers[MAX_RECEIVERS];
+static SPECTRUM_CLIENT *client[SPECTRUM_SERVER_MAX_CLIENTS];
+static gint clients=0;
+static SPECTRUM_SERVER_STATS totals;
+
+// Main thread, from the update timer after a new analyzer frame
+void spectrum_server_publish(RECEIVER *rx) {
+  if(!g_atomic_int_get(&running) || rx->channel<0 || rx->channel>=MAX_RECEIVERS) return;
+  SPECTRUM_SOURCE *s=&source[rx->channel];
+  int n=rx->analyzer_pixels;
+  double hz_per_sample=(double)rx->sample_rate/(double)rx->pixels;
+
+  g_mutex_lock(&source_mutex);
+  if(s->size<n) {
+    g_free(s->samples);
+    s->samples=g_new(gfloat,n);
+    s->size=n;
+  }
+  memcpy(s->samples,rx->pixel_samples,n*sizeof(gfloat));
+  s->n=n;
+  s->hz_per_sample=hz_per_sample;
+  s->start_hz=rx->frequency_a-(gint64)(((double)rx->pixels/2.0-(double)rx->pan)*hz_per_sample);
+  s->meter_db=(gfloat)rx->meter_db;
+  s->serial++;
+  g_mutex_unlock(&source_mutex);
+
+  // one wake up in flight is enough, the thread looks at every source
+  if(g_atomic_int_get(&subscribers[rx->channel])>0 &&
+     g_atomic_int_compare_and_exchange(&wake_pending,0,1)) {
+    if(write(wake_pipe[1],"p",1)<0 && errno!=EAGAIN) {
+      perror("spectrum_server: wake failed");
+    }
+  }
+}
+
+// Server thread
+static void set_receiver(SPECTRUM_CLIENT *c,int receiver) {
+  if(c->receiver>=0) g_atomic_int_add(&subscribers[c->receiver],-1);
+  c->receiver=receiver;
+  if(c->receiver>=0) g_atomic_int_inc(&subscribers[c->receiver]);
+}
+
+static void close_client(int i) {
+  SPECTRUM_CLIENT *c=client[i];
+  set_receiver(c,-1);
+  close(c->fd);
+  g_free(c->pixels);
+  g_free(c->previous);
+  g_free(c->out);
+  g_free(c);
+  client[i]=client[--clients];
+  client[clients]=NULL;
+  g_atomic_int_set(&totals.clients,clients);
+}
+
+static gboolean new_client(void) {
+  int on=1;
+  int fd=accept(server_socket,NULL,NULL);
+  if(fd<0) return FALSE;
+  if(clients>=SPECTRUM_SERVER_MAX_CLIENTS) {
+    close(fd);
+    return TRUE;
+  }
+  fcntl(fd,F_SETFL,fcntl(fd,F_GETFL,0)|O_NONBLOCK);
+  setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,(void *)&on,sizeof(on));
+  // a few frames of socket buffer, so a client that stops reading is
+  // seen to be behind and skips frames instead of queueing seconds of them
+  int sndbuf=SEND_BUFFER_FRAMES*SPECTRUM_FRAME_MAX;
+  setsockopt(fd,SOL_SOCKET,SO_SNDBUF,(void *)&sndbuf,sizeof(sndbuf));
+#ifdef SO_NOSIGPIPE
+  setsockopt(fd,SOL_SOCKET,SO_NOSIGPIPE,(void *)&on,sizeof(on));
+#endif
+  SPECTRUM_CLIENT *c=g_new0(SPECTRUM_CLIENT,1);
+  c->fd=fd;
+  c->receiver=-1;
+  c->pixels=g_new0(guint8,SPECTRUM_MAX_WIDTH);
+  c->previous=g_new0(guint8,SPECTRUM_MAX_WIDTH);
+  c->out=g_new(guint8,SPECTRUM_FRAME_MAX);
+  client[clients++]=c;
+  g_atomic_int_set(&totals.clients,clients);
+  return TRUE;
+}
+
+static void client_command(SPECTRUM_CLIENT *c,char *command) {
+  int receiver, fps, width;
+
+  if(sscanf(command,"SUBSCRIBE %d %d %d",&receiver,&fps,&width)==3) {
+    if(receiver<0 || receiver>=MAX_RECEIVERS) return;
+    set_receiver(c,receiver);
+    c->fps=CLAMP(fps,1,MAX_FPS);
+    c->width=CLAMP(width,MIN_WIDTH,SPECTRUM_MAX_WIDTH);
+    c->next_time=0;
+    c->have_previous=FALSE;
+  } else if(strncmp(command,"UNSUBSCRIBE",11)==0) {
+    set_receiver(c,-1);
+  }
+}
+
+// Returns FALSE once the client has gone
+static gboolean client_read(SPECTRUM_CLIENT *c) {
+  char buffer[256];
+  int i;
+  ssize_t n=recv(c->fd,buffer,sizeof(buffer),0);
+
+  if(n==0) return FALSE;
+  if(n<0) return errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR;
+  for(i=0;i<n;i++) {
+    if(buffer[i]=='\n' || buffer[i]=='\r') {
+      c->command[c->command_length]='\0';
+      if(c->command_length>0) client_command(c,c->command);
+      c->command_length=0;
+    } else if(c->command_length<COMMAND_SIZE-1) {
+      c->command[c->command_length++]=buffer[i];
+    }
+  }
+  return TRUE;
+}
+
+static gboolean client_write(SPECTRUM_CLIENT *c) {
+  int flags=0;
+#ifdef MSG_NOSIGNAL
+  flags=MSG_NOSIGNAL;
+#endif
+  while(c->out_written<c->out_length) {
+    ssize_t n=send(c->fd,c->out+c->out_written,c->out_length-c->out_written,flags);
+    if(n<0) return errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR;
+    c->out_written+=n;
+    totals.bytes+=n;
+  }
+  return TRUE;
+}
+
+// Strongest sample under each of the client's pixels, source_mutex held
+static void resample(SPECTRUM_SOURCE *s,guint8 *pixels,int width) {
+  int x, i;
+  for(x=0;x<width;x++) {
+    int first=(int)((long long)x*s->n/width);
+    int last=(int)((long long)(x+1)*s->n/width);
+    float m=s->samples[first];
+    for(i=first+1;i<last;i++) {
+      m=s->samples[i]>m?s->samples[i]:m;
+    }
+    pixels[x]=spectrum_quantise(m);
+  }
+}
+
+static void client_frame(SPECTRUM_CLIENT *c,gint64 now) {
+  if(c->receiver<0 || now<c->next_time) return;
+  SPECTRUM_SOURCE *s=&source[c->receiver];
+
+  g_mutex_lock(&source_mutex);
+  if(s->n==0 || s->serial==c->serial) {
+    g_mutex_unlock(&source_mutex);
+    return;
+  }
+  gint64 period=G_USEC_PER_SEC/c->fps;
+  c->next_time=c->next_time+period>now?c->next_time+period:now+period;
+  c->serial=s->serial;
+  // a dropped frame uses up its sequence number, so the client sees the gap
+  guint32 sequence=c->sequence++;
+  if(c->out_written<c->out_length) {
+    // still writing the last one
+    g_mutex_unlock(&source_mutex);
+    totals.dropped++;
+    return;
+  }
+  resample(s,c->pixels,c->width);
+
+  SPECTRUM_FRAME f;
+  f.receiver=c->receiver;
+  f.width=c->width;
+  f.sequence=sequence;
+  f.start_hz=s->start_hz;
+  f.hz_per_pixel=s->hz_per_sample*(double)s->n/(double)c->width;
+  f.meter_db=s->meter_db;
+  g_mutex_unlock(&source_mutex);
+
+  // a new span or a periodic key frame lets the client start afresh
+  gboolean key=!c->have_previous || c->since_key>=KEY_INTERVAL ||
+               f.start_hz!=c->start_hz || f.hz_per_pixel!=c->hz_per_pixel;
+  c->out_length=spectrum_frame_encode(c->out,&f,c->pixels,key?NULL:c->previous);
+  c->out_written=0;
+  c->since_key=f.type==SPECTRUM_FRAME_KEY?0:c->since_key+1;
+  c->start_hz=f.start_hz;
+  c->hz_per_pixel=f.hz_per_pixel;
+  memcpy(c->previous,c->pixels,c->width);
+  c->have_previous=TRUE;
+  totals.frames++;
+}
+
+// Milliseconds until the first client that is held back by its frame
+// rate may send again, -1 if none is. The others wait for a publish.
+static int poll_timeout(gint64 now) {
+  gint64 first=G_MAXINT64;
+  int i;
+  for(i=0;i<clients;i++) {
+    SPECTRUM_CLIENT *c=client[i];
+    if(c->receiver>=0 && c->next_time>now && c->next_time<first) first=c->next_time;
+  }
+  if(first==G_MAXINT64) return -1;
+  return (int)((first-now+999)/1000);
+}
+
+static gpointer spectrum_server_thread(gpointer data) {
+  struct pollfd fds[SPECTRUM_SERVER_MAX_CLIENTS+2];
+  char drain[64];
+  int i;
+
+  while(g_atomic_int_get(&running)) {
+    fds[0].fd=server_socket;
+    fds[0].events=POLLIN;
+    fds[1].fd=wake_pipe[0];
+    fds[1].events=POLLIN;
+    for(i=0;i<clients;i++) {
+      fds[i+2].fd=client[i]->fd;
+      fds[i+2].events=POLLIN|(client[i]->out_written<client[i]->out_length?POLLOUT:0);
+      fds[i+2].revents=0;
+    }
+    int n=clients;
+    if(poll(fds,n+2,poll_timeout(g_get_monotonic_time()))<0 && errno!=EINTR) break;
+
+    if(fds[1].revents&POLLIN) {
+      while(read(wake_pipe[0],drain,sizeof(drain))>0);
+      // cleared before the sources are read, so a later publish wakes us again
+      g_atomic_int_set(&wake_pending,0);
+    }
+
+    // back to front, close_client moves the last client into the gap
+    gint64 now=g_get_monotonic_time();
+    for(i=n-1;i>=0;i--) {
+      SPECTRUM_CLIENT *c=client[i];
+      gboolean ok=TRUE;
+      if(fds[i+2].revents&(POLLERR|POLLHUP|POLLNVAL)) ok=FALSE;
+      if(ok && (fds[i+2].revents&POLLIN)) ok=client_read(c);
+      if(ok) {
+        client_frame(c,now);
+        ok=client_write(c);
+      }
+      if(!ok) close_client(i);
+    }
+    if(fds[0].revents&POLLIN) {
+      while(new_client());
+    }
+  }
+
+  while(clients>0) close_client(clients-1);
+  return NULL;
+}
+
+gboolean spectrum_server_start(int port) {
+  struct sockaddr_in address;
+  int on=1;
+
+  if(server_thread!=NULL) return TRUE;
+
+  server_socket=socket(AF_INET,SOCK_STREAM,0);
+  if(server_socket<0) {
+    perror("spectrum_server: socket failed");
+    return FALSE;
+  }
+  setsockopt(server_socket,SOL_SOCKET,SO_REUSEADDR,&on,sizeof(on));
+  memset(&address,0,sizeof(address));
+  address.sin_family=AF_INET;
+  address.sin_addr.s_addr=INADDR_ANY;
+  address.sin_port=htons(port);
+  if(bind(server_socket,(struct sockaddr *)&address,sizeof(address))<0 || listen(server_socket,SPECTRUM_SERVER_MAX_CLIENTS)<0) {
+    perror("spectrum_server: bind/listen failed");
+    close(server_socket);
+    server_socket=-1;
+    return FALSE;
+  }
+  fcntl(server_socket,F_SETFL,fcntl(server_socket,F_GETFL,0)|O_NONBLOCK);
+  if(pipe(wake_pipe)<0) {
+    perror("spectrum_server: pipe failed");
+    close(server_socket);
+    server_socket=-1;
+    return FALSE;
+  }
+  fcntl(wake_pipe[0],F_SETFL,fcntl(wake_pipe[0],F_GETFL,0)|O_NONBLOCK);
+  fcntl(wake_pipe[1],F_SETFL,fcntl(wake_pipe[1],F_GETFL,0)|O_NONBLOCK);
+
+  memset(&totals,0,sizeof(totals));
+  memset(subscribers,0,sizeof(subscribers));
+  g_atomic_int_set(&wake_pending,0);
+  g_atomic_int_set(&running,1);
+  server_thread=g_thread_new("spectrum server",spectrum_server_thread,NULL);
+  g_print("spectrum_server: listening on port %d\n",port);
+  return TRUE;
+}
+
+void spectrum_server_stop(void) {
+  if(server_thread==NULL) return;
+  g_atomic_int_set(&running,0);
+  if(write(wake_pipe[1],"x",1)<0) {
+    perror("spectrum_server: wake failed");
+  }
+  g_thread_join(server_thread);
+  server_thread=NULL;
+  close(server_socket);
+  close(wake_pipe[0]);
+  close(wake_pipe[1]);
+  server_socket=-1;
+  wake_pipe[0]=wake_pipe[1]=-1;
+}
+
+gboolean spectrum_server_running(void) {
+  return server_thread!=NULL;
+}
+
+// Counters are updated by the server thread without a lock, good enough
+// for the Stats tab
+void spectrum_server_stats(SPECTRUM_SERVER_STATS *stats) {
+  stats->clients=g_atomic_int_get(&totals.clients);
+  stats->frames=totals.frames;
+  stats->dropped=totals.dropped;
+  stats->bytes=totals.bytes;
+}
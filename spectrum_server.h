@@ -0,0 +1,38 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#ifndef _SPECTRUM_SERVER_H
+#define _SPECTRUM_SERVER_H
+
+#define SPECTRUM_SERVER_MAX_CLIENTS 64
+
+typedef struct _spectrum_server_stats {
+  gint clients;
+  guint64 frames;
+  guint64 dropped;            // frames not sent as the client was behind
+  guint64 bytes;
+} SPECTRUM_SERVER_STATS;
+
+extern gboolean spectrum_server_start(int port);
+extern void spectrum_server_stop(void);
+extern gboolean spectrum_server_running(void);
+extern void spectrum_server_publish(RECEIVER *rx);
+extern void spectrum_server_stats(SPECTRUM_SERVER_STATS *stats);
+
+#endif
@@ -0,0 +1,281 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <wdsp.h>
+
+#include "bpsk.h"
+#include "receiver.h"
+#include "transmitter.h"
+#include "wideband.h"
+#include "discovered.h"
+#include "adc.h"
+#include "dac.h"
+#include "radio.h"
+#include "audio.h"
+#include "analyzer_policy.h"
+#include "shared_analyzer.h"
+#include "spectrum_server.h"
+#include "display_renderer.h"
+#include "stats_dialog.h"
+
+#define STATS_INTERVAL 1000
+
+static GtkWidget *stats_label=NULL;
+static guint stats_timer_id=0;
+static gboolean profile_dsp=FALSE;
+
+static void add_dsp_profile(GString *text,int channel,const char *title) {
+  int i;
+  int n;
+  char name[32];
+  double min, avg, p99;
+
+  int stages=GetChannelProfileStages(channel);
+  if(stages==0) return;
+  g_string_append_printf(text,"%s (channel %d)\n",title,channel);
+  g_string_append_printf(text,"  %-16s %9s %9s %9s %6s\n","stage","min us","avg us","p99 us","blocks");
+  for(i=0;i<stages;i++) {
+    n=GetChannelProfileStage(channel,i,name,sizeof(name),&min,&avg,&p99);
+    if(n==0) continue;
+    g_string_append_printf(text,"  %-16s %9.1f %9.1f %9.1f %6d\n",name,min,avg,p99,n);
+  }
+  g_string_append(text,"\n");
+}
+
+static void add_audio_output(GString *text,RECEIVER *rx) {
+  int underflows, overflows;
+  double ppm, latency, target;
+
+  if(!audio_get_output_diags(rx,&underflows,&overflows,&ppm,&latency,&target)) return;
+  g_string_append_printf(text,"RX-%d local audio\n",rx->channel);
+  g_string_append_printf(text,"  latency %6.1f ms (target %.1f ms)  drift %+7.1f ppm\n",latency,target,ppm);
+  g_string_append_printf(text,"  underflows %d  overflows %d\n\n",underflows,overflows);
+}
+
+static void add_analyzer(GString *text,const char *title,void *data) {
+  ANALYZER_PLAN *plan=(ANALYZER_PLAN *)data;
+
+  if(plan==NULL) return;
+  g_string_append_printf(text,"%s analyzer\n",title);
+  g_string_append_printf(text,"  fft %d  overlap %d  %.1f fft/s  rbw %.1f Hz\n",plan->fft_size,plan->overlap,plan->ffts_per_second,plan->rbw);
+  g_string_append_printf(text,"  est. %.1f MFLOP/s  average %d frames\n\n",plan->cost,plan->num_average);
+}
+
+static void add_render(GString *text,RECEIVER *rx) {
+  FRAME_PACER *p=&rx->thread_context.pacer;
+
+  if(p->frames==0) return;
+  g_string_append_printf(text,"RX-%d display %.1f of %d fps%s\n",rx->channel,frame_pacer_fps(p,rx->fps),rx->fps,
+      rx==radio->active_receiver?" (active)":"");
+  g_string_append_printf(text,"  render last %.2f ms  avg %.2f ms  max %.2f ms  frames %u\n",
+      p->last_us/1000.0,p->avg_us/1000.0,p->max_us/1000.0,p->frames);
+  g_string_append_printf(text,"  dropped %u  late %u  skipped %u\n",p->dropped,p->late,p->skipped);
+  if(rx->deep_zoom_ddc!=NULL) {
+    DEEP_ZOOM *dz=rx->deep_zoom_ddc;
+    g_string_append_printf(text,"  deep zoom DDC to %d Hz (/%d, %d taps)  est. %.1f MFLOP/s\n",dz->out_rate,dz->decimation,dz->ncoef,dz->cost);
+  }
+  switch(g_atomic_int_get(&rx->shared_role)) {
+    case SHARED_FEEDER:
+      g_string_append_printf(text,"  analyzer shared by %d receivers on ADC-%d, fed by this one\n",shared_analyzer_members(rx->adc),rx->adc);
+      break;
+    case SHARED_MEMBER:
+      g_string_append_printf(text,"  analyzer shared by %d receivers on ADC-%d\n",shared_analyzer_members(rx->adc),rx->adc);
+      break;
+  }
+  g_string_append(text,"\n");
+}
+
+static void add_spectrum_server(GString *text) {
+  SPECTRUM_SERVER_STATS s;
+
+  if(!spectrum_server_running()) return;
+  spectrum_server_stats(&s);
+  g_string_append_printf(text,"Spectrum server\n");
+  g_string_append_printf(text,"  clients %d  frames %llu  dropped %llu  sent %.1f MB\n\n",s.clients,
+      (unsigned long long)s.frames,(unsigned long long)s.dropped,(double)s.bytes/1e6);
+}
+
+static void add_ps_calc(GString *text,TRANSMITTER *tx) {
+  double last, avg;
+  int count;
+
+  GetPSCalcTime(tx->channel,&last,&avg,&count);
+  if(count==0) return;
+  g_string_append_printf(text,"PureSignal correction (channel %d)\n",tx->channel);
+  g_string_append_printf(text,"  last %.2f ms  avg %.2f ms  fits %d\n\n",last/1000.0,avg/1000.0,count);
+}
+
+static gboolean stats_timeout(gpointer data) {
+  RADIO *r=(RADIO *)data;
+  int i;
+  char title[32];
+
+  if(stats_label==NULL) {
+    stats_timer_id=0;
+    return FALSE;
+  }
+
+  GString *text=g_string_new(NULL);
+  for(i=0;i<r->discovered->supported_receivers;i++) {
+    if(r->receiver[i]!=NULL && r->receiver[i]->local_audio) {
+      add_audio_output(text,r->receiver[i]);
+    }
+  }
+  for(i=0;i<r->discovered->supported_receivers;i++) {
+    if(r->receiver[i]!=NULL) {
+      g_snprintf(title,sizeof(title),"RX-%d",r->receiver[i]->channel);
+      add_analyzer(text,title,r->receiver[i]->analyzer_plan);
+      add_render(text,r->receiver[i]);
+    }
+  }
+  add_spectrum_server(text);
+  if(r->can_transmit && r->transmitter!=NULL) {
+    add_analyzer(text,"TX",r->transmitter->analyzer_plan);
+  }
+  if(r->can_transmit && r->transmitter!=NULL && r->transmitter->puresignal) {
+    add_ps_calc(text,r->transmitter);
+  }
+  if(profile_dsp) {
+    for(i=0;i<r->discovered->supported_receivers;i++) {
+      if(r->receiver[i]!=NULL) {
+        g_snprintf(title,sizeof(title),"RX-%d",r->receiver[i]->channel);
+        add_dsp_profile(text,r->receiver[i]->channel,title);
+      }
+    }
+    if(r->can_transmit && r->transmitter!=NULL) {
+      add_dsp_profile(text,r->transmitter->channel,"TX");
+    }
+  }
+  if(text->len==0) {
+    g_string_append(text,"No statistics enabled");
+  }
+
+  gchar *markup=g_markup_printf_escaped("<tt>%s</tt>",text->str);
+  gtk_label_set_markup(GTK_LABEL(stats_label),markup);
+  g_free(markup);
+  g_string_free(text,TRUE);
+  return TRUE;
+}
+
+static void set_profile_run(RADIO *r,int run) {
+  int i;
+  for(i=0;i<r->discovered->supported_receivers;i++) {
+    if(r->receiver[i]!=NULL) {
+      SetChannelProfileRun(r->receiver[i]->channel,run);
+    }
+  }
+  if(r->can_transmit && r->transmitter!=NULL) {
+    SetChannelProfileRun(r->transmitter->channel,run);
+  }
+}
+
+static void profile_dsp_cb(GtkWidget *widget,gpointer data) {
+  RADIO *r=(RADIO *)data;
+  profile_dsp=gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget));
+  set_profile_run(r,profile_dsp);
+  stats_timeout(r);
+}
+
+static void reset_cb(GtkWidget *widget,gpointer data) {
+  RADIO *r=(RADIO *)data;
+  int i;
+  for(i=0;i<r->discovered->supported_receivers;i++) {
+    if(r->receiver[i]!=NULL) {
+      ResetChannelProfile(r->receiver[i]->channel);
+      audio_reset_output_diags(r->receiver[i]);
+      frame_pacer_reset_stats(&r->receiver[i]->thread_context.pacer);
+    }
+  }
+  if(r->can_transmit && r->transmitter!=NULL) {
+    ResetChannelProfile(r->transmitter->channel);
+  }
+  stats_timeout(r);
+}
+
+static void destroy_cb(GtkWidget *widget,gpointer data) {
+  if(stats_timer_id!=0) {
+    g_source_remove(stats_timer_id);
+    stats_timer_id=0;
+  }
+  stats_label=NULL;
+}
+
+GtkWidget *create_stats_dialog(RADIO *r) {
+  int row=0;
+
+  GtkWidget *grid=gtk_grid_new();
+  gtk_grid_set_column_spacing (GTK_GRID(grid),10);
+  gtk_grid_set_row_spacing (GTK_GRID(grid),5);
+
+  GtkWidget *dsp_frame=gtk_frame_new("DSP");
+  GtkWidget *dsp_grid=gtk_grid_new();
+  gtk_grid_set_column_spacing (GTK_GRID(dsp_grid),10);
+  gtk_container_add(GTK_CONTAINER(dsp_frame),dsp_grid);
+  gtk_grid_attach(GTK_GRID(grid),dsp_frame,0,row++,1,1);
+
+  GtkWidget *profile_b=gtk_check_button_new_with_label("Profile DSP stages");
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(profile_b),profile_dsp);
+  gtk_grid_attach(GTK_GRID(dsp_grid),profile_b,0,0,1,1);
+  g_signal_connect(profile_b,"toggled",G_CALLBACK(profile_dsp_cb),r);
+
+  GtkWidget *reset_b=gtk_button_new_with_label("Reset");
+  gtk_grid_attach(GTK_GRID(dsp_grid),reset_b,1,0,1,1);
+  g_signal_connect(reset_b,"clicked",G_CALLBACK(reset_cb),r);
+
+  GtkWidget *display_frame=gtk_frame_new("Display");
+  GtkWidget *display_grid=gtk_grid_new();
+  gtk_grid_set_column_spacing (GTK_GRID(display_grid),10);
+  gtk_container_add(GTK_CONTAINER(display_frame),display_grid);
+  gtk_grid_attach(GTK_GRID(grid),display_frame,0,row++,1,1);
+
+  // what was chosen at startup and why
+  GtkWidget *renderer_label=gtk_label_new(NULL);
+  char renderer_text[160];
+  g_snprintf(renderer_text,sizeof(renderer_text),"Renderer: %s",display_renderer_report);
+  gtk_label_set_text(GTK_LABEL(renderer_label),renderer_text);
+  gtk_label_set_xalign(GTK_LABEL(renderer_label),0.0);
+  gtk_label_set_selectable(GTK_LABEL(renderer_label),TRUE);
+  gtk_grid_attach(GTK_GRID(display_grid),renderer_label,0,0,1,1);
+
+  GtkWidget *scrolled=gtk_scrolled_window_new(NULL,NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),GTK_POLICY_AUTOMATIC,GTK_POLICY_AUTOMATIC);
+  gtk_widget_set_size_request(scrolled,480,360);
+  gtk_widget_set_hexpand(scrolled,TRUE);
+  gtk_widget_set_vexpand(scrolled,TRUE);
+  stats_label=gtk_label_new(NULL);
+  gtk_label_set_xalign(GTK_LABEL(stats_label),0.0);
+  gtk_label_set_yalign(GTK_LABEL(stats_label),0.0);
+  gtk_label_set_selectable(GTK_LABEL(stats_label),TRUE);
+  gtk_container_add(GTK_CONTAINER(scrolled),stats_label);
+  gtk_grid_attach(GTK_GRID(grid),scrolled,0,row++,1,1);
+
+  g_signal_connect(grid,"destroy",G_CALLBACK(destroy_cb),NULL);
+
+  stats_timeout(r);
+  stats_timer_id=g_timeout_add(STATS_INTERVAL,stats_timeout,(gpointer)r);
+
+  return grid;
+}
@@ -46,6 +46,7 @@
 #include "mic_level.h"
 #include "property.h"
 #include "ext.h"
+#include "analyzer_policy.h"
 #ifdef SOAPYSDR
 #include "soapy_protocol.h"
 #endif
@@ -380,16 +381,20 @@ void transmitter_restore_state(TRANSMITTER *tx) {
 
 }
 
-static gboolean update_timer_cb(void *data) {
-  int rc;
+// Main thread, from the radio's display tick
+void transmitter_display_request(TRANSMITTER *tx,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req) {
+  req->first=display_pixels_request(p,tx->channel,0,tx->pixel_samples);
+  req->pixels=req->first>=0;
+  req->frame=req->pixels;
+}
+
+void transmitter_display_update(TRANSMITTER *tx,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req) {
   double constant1;
   double constant2;
   int fwd_cal_offset=6;
 
-  TRANSMITTER *tx=(TRANSMITTER *)data;
   //if(isTransmitting(radio)) {
-    GetPixels(tx->channel,0,tx->pixel_samples,&rc);
-    if(rc) {
+    if(display_pixels_ready(p,req->first)) {
       update_tx_panadapter(radio);
     }
   //}
@@ -471,13 +476,11 @@ static gboolean update_timer_cb(void *data) {
       tx->rev=(v1*v1)/constant2;
     }    
   }
-
-  return TRUE;
 }
 
 void transmitter_fps_changed(TRANSMITTER *tx) {
-  g_source_remove(tx->update_timer_id);
-  tx->update_timer_id=g_timeout_add(1000/tx->fps,update_timer_cb,(gpointer)tx);
+  // the display tick picks up the new rate, the FFT overlap depends on it
+  transmitter_init_analyzer(tx);
 }
 
 void transmitter_set_ps(TRANSMITTER *tx,gboolean state) {
@@ -959,10 +962,10 @@ void transmitter_init_analyzer(TRANSMITTER *tx) {
     int n_pixout=1;
     int spur_elimination_ffts = 1;
     int data_type = 1;
-    int fft_size = 8192;
+    int fft_size;
     int window_type = 4;
     double kaiser_pi = 14.0;
-    int overlap = 2048;
+    int overlap;
     int clip = 0;
     int span_clip_l = 0;
     int span_clip_h = 0;
@@ -981,11 +984,19 @@ void transmitter_init_analyzer(TRANSMITTER *tx) {
 
     if(tx->pixels>0) {
       tx->pixel_samples=g_new0(float,tx->pixels);
-      int max_w = fft_size + (int) fmin(keep_time * (double) tx->fps, keep_time * (double) fft_size * (double) tx->fps);
 
-      overlap = (int)max(0.0, ceil(fft_size - (double)tx->mic_sample_rate / (double)tx->fps));
+      // the spectrum is taken from the IQ output stream
+      if(tx->analyzer_plan==NULL) {
+        tx->analyzer_plan=g_new0(ANALYZER_PLAN,1);
+      }
+      ANALYZER_PLAN *plan=(ANALYZER_PLAN *)tx->analyzer_plan;
+      analyzer_plan(plan,tx->iq_output_rate,tx->fps,tx->pixels,1.0,0.0,0.0,ANALYZER_MIN_FFT,ANALYZER_MAX_FFT);
+      fft_size=plan->fft_size;
+      overlap=plan->overlap;
+
+      int max_w = fft_size + (int) fmin(keep_time * (double) tx->fps, keep_time * (double) fft_size * (double) tx->fps);
 
-      fprintf(stderr,"SetAnalyzer id=%d buffer_size=%d overlap=%d\n",tx->channel,tx->output_samples,overlap);
+      fprintf(stderr,"SetAnalyzer id=%d buffer_size=%d fft_size=%d overlap=%d\n",tx->channel,tx->output_samples,fft_size,overlap);
 
 
       SetAnalyzer(tx->channel,
@@ -1221,8 +1232,7 @@ g_print("create_transmitter: channel=%d\n",channel);
     fprintf(stderr, "XCreateAnalyzer channel=%d failed: %d\n",tx->channel,rc);
   } else {
     transmitter_init_analyzer(tx);
-g_print("update_timer: fps=%d\n",tx->fps);
-    tx->update_timer_id=g_timeout_add(1000/tx->fps,update_timer_cb,(gpointer)tx);
+    tx->analyzer_created=TRUE;
   }
 
   switch(radio->discovered->protocol) {
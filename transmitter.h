@@ -20,9 +20,24 @@
 #ifndef TRANSMITTER_H
 #define TRANSMITTER_H
 
+#include "display_tick.h"
+
 #define CTCSS_FREQUENCIES 38
 extern double ctcss_frequencies[CTCSS_FREQUENCIES];
 
+// Static layer of the TX panadapter: background, filter, dBm grid and cursor
+typedef struct {
+  cairo_surface_t *static_surface;
+  gint width;
+  gint height;
+  gint panadapter_high;
+  gint panadapter_low;
+  gint filter_low;
+  gint filter_high;
+  gdouble hz_per_pixel;
+  gboolean cw;
+} TxPanadapterCache;
+
 typedef struct _transmitter {
   gint channel; // WDSP channel
 
@@ -109,8 +124,10 @@ typedef struct _transmitter {
 
   gint fps;
   gint pixels;
+  void *analyzer_plan;
   gfloat *pixel_samples;
-  gint update_timer_id;
+  gboolean analyzer_created;
+  gint tick_phase;            // display_tick_due() accumulator
 
   gint panadapter_low;
   gint panadapter_high;
@@ -119,6 +136,7 @@ typedef struct _transmitter {
   gint panadapter_height;
   GtkWidget *panadapter;
   cairo_surface_t *panadapter_surface;
+  TxPanadapterCache panadapter_cache;
 
   GtkWidget *dialog;
 
@@ -162,6 +180,8 @@ extern void transmitter_set_mode(TRANSMITTER *tx,int mode);
 extern void transmitter_set_deviation(TRANSMITTER *tx);
 extern void transmitter_set_am_carrier_level(TRANSMITTER *tx);
 extern void transmitter_fps_changed(TRANSMITTER *tx);
+extern void transmitter_display_request(TRANSMITTER *tx,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
+extern void transmitter_display_update(TRANSMITTER *tx,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
 extern void transmitter_set_ctcss(TRANSMITTER *tx,gboolean run,int f);
 
 extern void transmitter_set_ps(TRANSMITTER *tx,gboolean state);
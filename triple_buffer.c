@@ -0,0 +1,74 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "triple_buffer.h"
+
+void triple_buffer_init(TRIPLE_BUFFER *b) {
+  memset(b,0,sizeof(TRIPLE_BUFFER));
+  b->back=0;
+  b->latest=1;
+  b->front=2;
+}
+
+// Neither thread may be using the buffer any more
+void triple_buffer_free(TRIPLE_BUFFER *b) {
+  int i;
+  for(i=0;i<3;i++) {
+    g_free(b->slot[i].samples);
+  }
+  triple_buffer_init(b);
+}
+
+static gint exchange(gint *atomic,gint value) {
+  gint old;
+  do {
+    old=g_atomic_int_get(atomic);
+  } while(!g_atomic_int_compare_and_exchange(atomic,old,value));
+  return old;
+}
+
+// producer: copy a frame into its slot and make it the latest
+void triple_buffer_publish(TRIPLE_BUFFER *b,const gfloat *samples,gint n,gint traces) {
+  TRIPLE_BUFFER_SLOT *s=&b->slot[b->back];
+  if(s->size<n*traces) {
+    g_free(s->samples);
+    s->samples=g_new(gfloat,n*traces);
+    s->size=n*traces;
+  }
+  memcpy(s->samples,samples,n*traces*sizeof(gfloat));
+  s->n=n;
+  s->traces=traces;
+  b->back=exchange(&b->latest,b->back|TRIPLE_BUFFER_FRESH)&~TRIPLE_BUFFER_FRESH;
+}
+
+// consumer: TRUE if a newer frame was swapped into its slot
+gboolean triple_buffer_take(TRIPLE_BUFFER *b) {
+  if(!(g_atomic_int_get(&b->latest)&TRIPLE_BUFFER_FRESH)) return FALSE;
+  b->front=exchange(&b->latest,b->front)&~TRIPLE_BUFFER_FRESH;
+  return TRUE;
+}
+
+// consumer: the frame it last took
+TRIPLE_BUFFER_SLOT *triple_buffer_front(TRIPLE_BUFFER *b) {
+  return &b->slot[b->front];
+}
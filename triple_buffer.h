@@ -0,0 +1,55 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#ifndef _TRIPLE_BUFFER_H
+#define _TRIPLE_BUFFER_H
+
+//
+// Hands analyzer frames from one producer thread to one consumer thread
+// without a lock. Each side owns one of three slots; publishing swaps the
+// producer's slot with the latest one and taking swaps the consumer's
+// slot with it, so neither side ever waits for the other and the consumer
+// always gets the newest complete frame. A slot is only resized by the
+// side that owns it.
+//
+
+#define TRIPLE_BUFFER_FRESH 4   // set in 'latest' until the consumer takes it
+
+typedef struct _triple_buffer_slot {
+  gfloat *samples;          // 'traces' runs of 'n' samples
+  gint size;
+  gint n;
+  gint traces;
+} TRIPLE_BUFFER_SLOT;
+
+typedef struct _triple_buffer {
+  TRIPLE_BUFFER_SLOT slot[3];
+  gint back;                // producer's slot
+  gint latest;              // last published slot, with TRIPLE_BUFFER_FRESH
+  gint front;               // consumer's slot
+} TRIPLE_BUFFER;
+
+extern void triple_buffer_init(TRIPLE_BUFFER *b);
+extern void triple_buffer_free(TRIPLE_BUFFER *b);
+extern void triple_buffer_publish(TRIPLE_BUFFER *b,const gfloat *samples,gint n,gint traces);
+extern gboolean triple_buffer_take(TRIPLE_BUFFER *b);
+extern TRIPLE_BUFFER_SLOT *triple_buffer_front(TRIPLE_BUFFER *b);
+
+#endif
@@ -105,6 +105,7 @@ GtkWidget *create_tx_panadapter(TRANSMITTER *tx) {
     tx->panadapter_width = 0;
     tx->panadapter_height = 0;
     tx->panadapter_surface = NULL;
+    tx->panadapter_cache.static_surface = NULL;
     tx->panadapter = gtk_drawing_area_new();
     gtk_widget_set_size_request(tx->panadapter, 600, 200);
 
@@ -120,73 +121,108 @@ GtkWidget *create_tx_panadapter(TRANSMITTER *tx) {
     return vbox;
 }
 
-// Updated panadapter rendering
-void update_tx_panadapter(RADIO *r) {
+// Everything that only changes with the size, scale, filter or mode
+static void draw_static_elements(TRANSMITTER *tx, cairo_t *cr, int width, int height, double hz_per_pixel) {
+    int i;
+
+    cairo_set_line_width(cr, 1.0);
+
+    // Modern background with gradient
+    cairo_pattern_t *pat = cairo_pattern_create_linear(0.0, 0.0, 0.0, height);
+    cairo_pattern_add_color_stop_rgb(pat, 0.0, 0.15, 0.15, 0.15);
+    cairo_pattern_add_color_stop_rgb(pat, 1.0, 0.05, 0.05, 0.05);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_set_source(cr, pat);
+    cairo_fill(cr);
+    cairo_pattern_destroy(pat);
+
+    double dbm_per_line = (double)height / ((double)tx->panadapter_high - (double)tx->panadapter_low);
+
+    // Filter with shadow
+    cairo_set_source_rgba(cr, COLOR_FILTER);
+    double filter_left = (double)width / 2.0 + ((double)tx->actual_filter_low / hz_per_pixel);
+    double filter_right = (double)width / 2.0 + ((double)tx->actual_filter_high / hz_per_pixel);
+    cairo_rectangle(cr, filter_left, 20.0, filter_right - filter_left, (double)height - 20.0);
+    cairo_fill(cr);
+
+    // Levels
+    cairo_set_source_rgb(cr, COLOR_TEXT);
+    cairo_set_line_width(cr, 1.0);
+    cairo_select_font_face(cr, "Roboto", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, 12);
+    char v[32];
+    for(i = tx->panadapter_high; i >= tx->panadapter_low; i--) {
+        int mod = abs(i) % 20;
+        if(mod == 0) {
+            double y = (double)(tx->panadapter_high - i) * dbm_per_line;
+            cairo_move_to(cr, 0.0, y);
+            cairo_line_to(cr, (double)width, y);
+            sprintf(v, "%d dBm", i);
+            cairo_move_to(cr, 5, y - 2);
+            cairo_show_text(cr, v);
+        }
+    }
+    cairo_stroke(cr);
+
+    // Cursor
+    SetColour(cr, 1); // TEXT_A
+    cairo_set_line_width(cr, 1.5);
+    cairo_move_to(cr, (double)(width / 2.0), 20.0);
+    cairo_line_to(cr, (double)(width / 2.0), (double)height);
+    cairo_stroke(cr);
+
+    // CW line
+    if(tx->panadapter_cache.cw) {
+        SetColour(cr, 2); // TEXT_B
+        double cw_frequency = filter_left + ((filter_right - filter_left) / 2.0);
+        cairo_move_to(cr, cw_frequency, 20.0);
+        cairo_line_to(cr, cw_frequency, (double)height);
+        cairo_stroke(cr);
+    }
+}
+
+// Draws into tx->panadapter_surface, which has to be width x height
+void tx_panadapter_render(RADIO *r, int width, int height) {
     TRANSMITTER *tx = r->transmitter;
-    int width = gtk_widget_get_allocated_width(tx->panadapter);
-    int height = gtk_widget_get_allocated_height(tx->panadapter);
+    TxPanadapterCache *px = &tx->panadapter_cache;
     float *samples = tx->pixel_samples;
     double hz_per_pixel = (double)tx->iq_output_rate / (double)tx->pixels;
+    gboolean cw = tx->rx != NULL && (tx->rx->mode_a == CWU || tx->rx->mode_a == CWL);
     char text[32];
     int i;
 
     if(tx->panadapter_surface != NULL) {
-        cairo_t *cr = cairo_create(tx->panadapter_surface);
-        cairo_set_line_width(cr, 1.0);
-
-        // Modern background with gradient
-        cairo_pattern_t *pat = cairo_pattern_create_linear(0.0, 0.0, 0.0, height);
-        cairo_pattern_add_color_stop_rgb(pat, 0.0, 0.15, 0.15, 0.15);
-        cairo_pattern_add_color_stop_rgb(pat, 1.0, 0.05, 0.05, 0.05);
-        cairo_rectangle(cr, 0, 0, width, height);
-        cairo_set_source(cr, pat);
-        cairo_fill(cr);
-        cairo_pattern_destroy(pat);
-
-        double dbm_per_line = (double)height / ((double)tx->panadapter_high - (double)tx->panadapter_low);
-
-        // Filter with shadow
-        cairo_set_source_rgba(cr, COLOR_FILTER);
-        double filter_left = (double)width / 2.0 + ((double)tx->actual_filter_low / hz_per_pixel);
-        double filter_right = (double)width / 2.0 + ((double)tx->actual_filter_high / hz_per_pixel);
-        cairo_rectangle(cr, filter_left, 20.0, filter_right - filter_left, (double)height - 20.0);
-        cairo_fill(cr);
-
-        // Levels
-        cairo_set_source_rgb(cr, COLOR_TEXT);
-        cairo_set_line_width(cr, 1.0);
-        cairo_select_font_face(cr, "Roboto", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-        cairo_set_font_size(cr, 12);
-        char v[32];
-        for(i = tx->panadapter_high; i >= tx->panadapter_low; i--) {
-            int mod = abs(i) % 20;
-            if(mod == 0) {
-                double y = (double)(tx->panadapter_high - i) * dbm_per_line;
-                cairo_move_to(cr, 0.0, y);
-                cairo_line_to(cr, (double)width, y);
-                sprintf(v, "%d dBm", i);
-                cairo_move_to(cr, 5, y - 2);
-                cairo_move_to(cr, 5, y - 2);
-                cairo_show_text(cr, v);
+        // Redraw the grid and its labels only when what they show changes
+        if(px->static_surface == NULL ||
+           px->width != width ||
+           px->height != height ||
+           px->panadapter_high != tx->panadapter_high ||
+           px->panadapter_low != tx->panadapter_low ||
+           px->filter_low != tx->actual_filter_low ||
+           px->filter_high != tx->actual_filter_high ||
+           px->hz_per_pixel != hz_per_pixel ||
+           px->cw != cw) {
+            px->width = width;
+            px->height = height;
+            px->panadapter_high = tx->panadapter_high;
+            px->panadapter_low = tx->panadapter_low;
+            px->filter_low = tx->actual_filter_low;
+            px->filter_high = tx->actual_filter_high;
+            px->hz_per_pixel = hz_per_pixel;
+            px->cw = cw;
+            if(px->static_surface != NULL) {
+                cairo_surface_destroy(px->static_surface);
             }
+            px->static_surface = cairo_surface_create_similar(tx->panadapter_surface, CAIRO_CONTENT_COLOR, width, height);
+            cairo_t *cr_static = cairo_create(px->static_surface);
+            draw_static_elements(tx, cr_static, width, height, hz_per_pixel);
+            cairo_destroy(cr_static);
         }
-        cairo_stroke(cr);
 
-        // Cursor
-        SetColour(cr, 1); // TEXT_A
-        cairo_set_line_width(cr, 1.5);
-        cairo_move_to(cr, (double)(width / 2.0), 20.0);
-        cairo_line_to(cr, (double)(width / 2.0), (double)height);
-        cairo_stroke(cr);
-
-        // CW line
-        if(tx->rx->mode_a == CWU || tx->rx->mode_a == CWL) {
-            SetColour(cr, 2); // TEXT_B
-            double cw_frequency = filter_left + ((filter_right - filter_left) / 2.0);
-            cairo_move_to(cr, cw_frequency, 20.0);
-            cairo_line_to(cr, cw_frequency, (double)height);
-            cairo_stroke(cr);
-        }
+        cairo_t *cr = cairo_create(tx->panadapter_surface);
+        cairo_set_source_surface(cr, px->static_surface, 0.0, 0.0);
+        cairo_paint(cr);
+        cairo_select_font_face(cr, "Roboto", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
 
         // Signal
         if(isTransmitting(radio)) {
@@ -291,6 +327,15 @@ void update_tx_panadapter(RADIO *r) {
 
         cairo_stroke(cr);
         cairo_destroy(cr);
+    }
+}
+
+// Updated panadapter rendering
+void update_tx_panadapter(RADIO *r) {
+    TRANSMITTER *tx = r->transmitter;
+
+    if(tx->panadapter_surface != NULL) {
+        tx_panadapter_render(r, gtk_widget_get_allocated_width(tx->panadapter), gtk_widget_get_allocated_height(tx->panadapter));
         gtk_widget_queue_draw(tx->panadapter);
 
         tx->updated = TRUE;
@@ -18,4 +18,5 @@
 */
 
 extern GtkWidget *create_tx_panadapter(TRANSMITTER *tx);
+extern void tx_panadapter_render(RADIO *r, int width, int height);
 extern void update_tx_panadapter(RADIO *r);
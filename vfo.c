@@ -1337,6 +1337,7 @@ GtkWidget *create_vfo(RECEIVER *rx) {
   VFO_DATA *v=g_new(VFO_DATA,1);
 
   v->vfo=gtk_layout_new(NULL,NULL);
+  v->refresh_id=0;
 
 
   gtk_widget_set_name(v->vfo,"vfo");
@@ -1723,7 +1724,58 @@ GtkWidget *create_vfo(RECEIVER *rx) {
   return v->vfo;
 }
 
-void update_vfo(RECEIVER *rx) {
+//
+// The VFO bar is made of GTK labels and buttons. Setting a label or a
+// button, even to the same value, makes GTK re-layout and redraw it, so
+// each widget is only touched when its value changed. Tuning can call
+// update_vfo hundreds of times a second; the refresh itself is coalesced
+// onto the widget's frame clock so the bar repaints at most once per
+// display frame. The receiver's frequency is always exact, only the
+// presentation is deferred.
+//
+static void vfo_set_markup(GtkWidget *label,const char *markup) {
+  if(g_strcmp0(gtk_label_get_label(GTK_LABEL(label)),markup)!=0) {
+    gtk_label_set_markup(GTK_LABEL(label),markup);
+  }
+}
+
+static void vfo_set_text(GtkWidget *label,const char *text) {
+  if(g_strcmp0(gtk_label_get_label(GTK_LABEL(label)),text)!=0) {
+    gtk_label_set_text(GTK_LABEL(label),text);
+  }
+}
+
+static void vfo_set_button_label(GtkWidget *button,const char *text) {
+  if(g_strcmp0(gtk_button_get_label(GTK_BUTTON(button)),text)!=0) {
+    gtk_button_set_label(GTK_BUTTON(button),text);
+  }
+}
+
+static void vfo_set_active(GtkWidget *button,GCallback cb,RECEIVER *rx,gboolean active) {
+  active=active?TRUE:FALSE;
+  if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(button))==active) return;
+  if(cb!=NULL) g_signal_handlers_block_by_func(button,cb,rx);
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(button),active);
+  if(cb!=NULL) g_signal_handlers_unblock_by_func(button,cb,rx);
+}
+
+static void vfo_set_level(GtkWidget *bar,double value) {
+  if(gtk_level_bar_get_value(GTK_LEVEL_BAR(bar))!=value) {
+    gtk_level_bar_set_value(GTK_LEVEL_BAR(bar),value);
+  }
+}
+
+static void vfo_set_frequency(GtkWidget *label,long long f,const char *colour) {
+  char temp[32];
+  char *markup;
+
+  sprintf(temp,"%5lld.%03lld.%03lld",f/(long long)1000000,(f%(long long)1000000)/(long long)1000,f%(long long)1000);
+  markup=g_markup_printf_escaped("<span foreground=\"%s\">%s</span>",colour,temp);
+  vfo_set_markup(label,markup);
+  g_free(markup);
+}
+
+void update_vfo_now(RECEIVER *rx) {
   char temp[32];
   char *markup;
 
@@ -1733,62 +1785,40 @@ void update_vfo(RECEIVER *rx) {
 
   if(v==NULL) return;
 
+  gboolean tx_rx=radio!=NULL && radio->transmitter!=NULL && rx==radio->transmitter->rx && isTransmitting(radio);
+
   // VFO A
   long long af=rx->frequency_a;
   if(rx->ctun) af=rx->ctun_frequency;
   if(rx->entering_frequency) af=rx->entered_frequency;
-
-  sprintf(temp,"%5lld.%03lld.%03lld",af/(long long)1000000,(af%(long long)1000000)/(long long)1000,af%(long long)1000);
-  if(radio!=NULL && radio->transmitter!=NULL && rx==radio->transmitter->rx && radio->transmitter->rx->split==SPLIT_OFF && isTransmitting(radio)) {
-    markup=g_markup_printf_escaped("<span foreground=\"#D94545\">%s</span>",temp);
-  } else {
-    markup=g_markup_printf_escaped("<span foreground=\"#A3CCD1\">%s</span>",temp);
-  }
-  gtk_label_set_markup(GTK_LABEL(v->frequency_a_text),markup);
+  vfo_set_frequency(v->frequency_a_text,af,tx_rx && rx->split==SPLIT_OFF?"#D94545":"#A3CCD1");
 
   // VFO B
-  if(radio!=NULL && radio->transmitter!=NULL && rx==radio->transmitter->rx && radio->transmitter->rx->split!=SPLIT_OFF && isTransmitting(radio)) {
-    markup=g_markup_printf_escaped("<span foreground=\"#D94545\">%s</span>","VFO B");
-  } else {
-    markup=g_markup_printf_escaped("<span foreground=\"#ED9D80\">%s</span>","VFO B");
-  }
-  gtk_label_set_markup(GTK_LABEL(v->vfo_b_text),markup);
+  markup=g_markup_printf_escaped("<span foreground=\"%s\">%s</span>",tx_rx && rx->split!=SPLIT_OFF?"#D94545":"#ED9D80","VFO B");
+  vfo_set_markup(v->vfo_b_text,markup);
+  g_free(markup);
 
-  long long bf=rx->frequency_b;
-  sprintf(temp,"%5lld.%03lld.%03lld",bf/(long long)1000000,(bf%(long long)1000000)/(long long)1000,bf%(long long)1000);
-  if(radio!=NULL && radio->transmitter!=NULL && rx==radio->transmitter->rx && radio->transmitter->rx->split!=SPLIT_OFF && isTransmitting(radio)) {
-    markup=g_markup_printf_escaped("<span foreground=\"#D94545\">%s</span>",temp);
-  } else {
-    markup=g_markup_printf_escaped("<span foreground=\"#ED9D80\">%s</span>",temp);
-  }
-  gtk_label_set_markup(GTK_LABEL(v->frequency_b_text),markup);
+  vfo_set_frequency(v->frequency_b_text,rx->frequency_b,tx_rx && rx->split!=SPLIT_OFF?"#D94545":"#ED9D80");
 
   // ASSIGNED TX
   if(radio!=NULL && radio->transmitter!=NULL) {
     TRANSMITTER *tx=radio->transmitter;
 
-    if(tx->rx==rx) {
-      gtk_label_set_text(GTK_LABEL(v->tx_label),"ASSIGNED TX");
-    } else {
-      gtk_label_set_text(GTK_LABEL(v->tx_label),"");
-    }
-
-    g_signal_handlers_block_by_func(v->xit_b,G_CALLBACK(xit_b_cb),rx);
-    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->xit_b),tx->xit_enabled);
-    g_signal_handlers_unblock_by_func(v->xit_b,G_CALLBACK(xit_b_cb),rx);
+    vfo_set_text(v->tx_label,tx->rx==rx?"ASSIGNED TX":"");
+    vfo_set_active(v->xit_b,G_CALLBACK(xit_b_cb),rx,tx->xit_enabled);
   }
 
   // update AF Gain scale
-  gtk_level_bar_set_value(GTK_LEVEL_BAR(v->afgain_scale),rx->volume);
+  vfo_set_level(v->afgain_scale,rx->volume);
 
   // update AGC Gain scale
-  gtk_level_bar_set_value(GTK_LEVEL_BAR(v->agcgain_scale),rx->agc_gain+20.0);
+  vfo_set_level(v->agcgain_scale,rx->agc_gain+20.0);
 
   // update Lock button
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->lock_b),rx->locked);
+  vfo_set_active(v->lock_b,NULL,rx,rx->locked);
 
   // update mode button
-  gtk_button_set_label(GTK_BUTTON(v->mode_b),mode_string[rx->mode_a]);
+  vfo_set_button_label(v->mode_b,mode_string[rx->mode_a]);
 
   // update filter button
   FILTER *band_filters=filters[rx->mode_a];
@@ -1801,41 +1831,21 @@ void update_vfo(RECEIVER *rx) {
   } else {
     strcpy(temp,band_filters[rx->filter_a].title);
   }
-  gtk_button_set_label(GTK_BUTTON(v->filter_b),temp);
+  vfo_set_button_label(v->filter_b,temp);
 
   // update NB button
-  if(rx->nb) {
-      gtk_button_set_label(GTK_BUTTON(v->nb_b),"NB");
-  } else if(rx->nb2) {
-      gtk_button_set_label(GTK_BUTTON(v->nb_b),"NB2");
-  } else {
-      gtk_button_set_label(GTK_BUTTON(v->nb_b),"NB");
-  }
-  g_signal_handlers_block_by_func(v->nb_b,G_CALLBACK(nb_b_pressed_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->nb_b),rx->nb|rx->nb2);
-  g_signal_handlers_unblock_by_func(v->nb_b,G_CALLBACK(nb_b_pressed_cb),rx);
+  vfo_set_button_label(v->nb_b,!rx->nb && rx->nb2?"NB2":"NB");
+  vfo_set_active(v->nb_b,G_CALLBACK(nb_b_pressed_cb),rx,rx->nb|rx->nb2);
 
   // update NR button
-  if(rx->nr) {
-      gtk_button_set_label(GTK_BUTTON(v->nr_b),"NR");
-  } else if(rx->nr2) {
-      gtk_button_set_label(GTK_BUTTON(v->nr_b),"NR2");
-  } else {
-      gtk_button_set_label(GTK_BUTTON(v->nr_b),"NR");
-  }
-  g_signal_handlers_block_by_func(v->nr_b,G_CALLBACK(nr_b_pressed_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->nr_b),rx->nr|rx->nr2);
-  g_signal_handlers_unblock_by_func(v->nr_b,G_CALLBACK(nr_b_pressed_cb),rx);
+  vfo_set_button_label(v->nr_b,!rx->nr && rx->nr2?"NR2":"NR");
+  vfo_set_active(v->nr_b,G_CALLBACK(nr_b_pressed_cb),rx,rx->nr|rx->nr2);
 
   // update SNB button
-  g_signal_handlers_block_by_func(v->snb_b,G_CALLBACK(snb_b_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->snb_b),rx->snb);
-  g_signal_handlers_unblock_by_func(v->snb_b,G_CALLBACK(snb_b_cb),rx);
+  vfo_set_active(v->snb_b,G_CALLBACK(snb_b_cb),rx,rx->snb);
  
   // update ANF button
-  g_signal_handlers_block_by_func(v->anf_b,G_CALLBACK(anf_b_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->anf_b),rx->anf);
-  g_signal_handlers_unblock_by_func(v->anf_b,G_CALLBACK(anf_b_cb),rx);
+  vfo_set_active(v->anf_b,G_CALLBACK(anf_b_cb),rx,rx->anf);
  
   // update AGC button
   switch(rx->agc) {
@@ -1855,114 +1865,75 @@ void update_vfo(RECEIVER *rx) {
       strcpy(temp,"AGC FAST");
       break;
   }
-  gtk_button_set_label(GTK_BUTTON(v->agc_b),temp);
-  g_signal_handlers_block_by_func(v->agc_b,G_CALLBACK(agc_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->agc_b),rx->agc!=AGC_OFF);
-  g_signal_handlers_unblock_by_func(v->agc_b,G_CALLBACK(agc_cb),rx);
+  vfo_set_button_label(v->agc_b,temp);
+  vfo_set_active(v->agc_b,G_CALLBACK(agc_cb),rx,rx->agc!=AGC_OFF);
 
   // update RIT button
-  g_signal_handlers_block_by_func(v->rit_b,G_CALLBACK(rit_b_press_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->rit_b),rx->rit_enabled);
-  g_signal_handlers_unblock_by_func(v->rit_b,G_CALLBACK(rit_b_press_cb),rx);
+  vfo_set_active(v->rit_b,G_CALLBACK(rit_b_press_cb),rx,rx->rit_enabled);
 
   // update XIT button
   if(radio->transmitter!=NULL && radio->transmitter->rx==rx) {
-    g_signal_handlers_block_by_func(v->xit_b,G_CALLBACK(xit_b_press_cb),rx);
-    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->xit_b),radio->transmitter->xit_enabled);
-    g_signal_handlers_unblock_by_func(v->xit_b,G_CALLBACK(xit_b_press_cb),rx);
+    vfo_set_active(v->xit_b,G_CALLBACK(xit_b_press_cb),rx,radio->transmitter->xit_enabled);
   }
 
   // update CTUN button
-  g_signal_handlers_block_by_func(v->ctun_b,G_CALLBACK(ctun_b_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->ctun_b),rx->ctun);
-  g_signal_handlers_unblock_by_func(v->ctun_b,G_CALLBACK(ctun_b_cb),rx);
+  vfo_set_active(v->ctun_b,G_CALLBACK(ctun_b_cb),rx,rx->ctun);
 
   // update DUP button
-  g_signal_handlers_block_by_func(v->dup_b,G_CALLBACK(dup_b_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->dup_b),rx->duplex);
-  g_signal_handlers_unblock_by_func(v->dup_b,G_CALLBACK(dup_b_cb),rx);
+  vfo_set_active(v->dup_b,G_CALLBACK(dup_b_cb),rx,rx->duplex);
 
   // update BPSK button
-  g_signal_handlers_block_by_func(v->bpsk_b,G_CALLBACK(bpsk_b_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->bpsk_b),rx->bpsk_enable);
-  g_signal_handlers_unblock_by_func(v->bpsk_b,G_CALLBACK(bpsk_b_cb),rx);
+  vfo_set_active(v->bpsk_b,G_CALLBACK(bpsk_b_cb),rx,rx->bpsk_enable);
  
   // update ZOOM button
   sprintf(temp,"ZOOM x%d",rx->zoom);
-  gtk_button_set_label(GTK_BUTTON(v->zoom_b),temp);
+  vfo_set_button_label(v->zoom_b,temp);
 
   // update STEP button
   sprintf(temp,"STEP %s",step_labels[get_step(rx->step)]);
-  gtk_button_set_label(GTK_BUTTON(v->step_b),temp);
+  vfo_set_button_label(v->step_b,temp);
 
   // update SPLIT button
   switch(rx->split) {
      case SPLIT_OFF:
      case SPLIT_ON:
-       gtk_button_set_label(GTK_BUTTON(v->split_b),"SPLIT");
+       vfo_set_button_label(v->split_b,"SPLIT");
        break;
      case SPLIT_SAT:
-       gtk_button_set_label(GTK_BUTTON(v->split_b),"SAT");
+       vfo_set_button_label(v->split_b,"SAT");
        break;
      case SPLIT_RSAT:
-       gtk_button_set_label(GTK_BUTTON(v->split_b),"RSAT");
+       vfo_set_button_label(v->split_b,"RSAT");
        break;
   }
-  g_signal_handlers_block_by_func(v->split_b,G_CALLBACK(split_b_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->split_b),rx->split!=SPLIT_OFF);
-  g_signal_handlers_unblock_by_func(v->split_b,G_CALLBACK(split_b_cb),rx);
+  vfo_set_active(v->split_b,G_CALLBACK(split_b_cb),rx,rx->split!=SPLIT_OFF);
 
   // SUBRX button
-  g_signal_handlers_block_by_func(v->subrx_b,G_CALLBACK(subrx_b_cb),rx);
-  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(v->subrx_b),rx->subrx!=NULL);
-  g_signal_handlers_unblock_by_func(v->subrx_b,G_CALLBACK(subrx_b_cb),rx);
+  vfo_set_active(v->subrx_b,G_CALLBACK(subrx_b_cb),rx,rx->subrx!=NULL);
 
 }
 
+static gboolean vfo_tick_cb(GtkWidget *widget,GdkFrameClock *clock,gpointer data) {
+  RECEIVER *rx=(RECEIVER *)data;
+  VFO_DATA *v=(VFO_DATA *)g_object_get_data((GObject *)widget,"vfo_data");
+  if(v!=NULL) v->refresh_id=0;
+  update_vfo_now(rx);
+  return G_SOURCE_REMOVE;
+}
+
+void update_vfo(RECEIVER *rx) {
+  if(rx->vfo==NULL) return;
 
-// now only used by meter.c
+  VFO_DATA *v=(VFO_DATA *)g_object_get_data((GObject *)rx->vfo,"vfo_data");
 
-void SetColour(cairo_t *cr, const int colour) {
-  switch(colour) {
-    case BACKGROUND:
-      cairo_set_source_rgb(cr, 0.10, 0.10, 0.10);
-      break;
-    case OFF_WHITE:
-      cairo_set_source_rgb(cr, 0.90, 0.90, 0.90);
-      break;
-    case BOX_ON:
-      cairo_set_source_rgb(cr, 0.00, 0.50, 0.00);
-      break;
-    case BOX_OFF:
-      cairo_set_source_rgb(cr, 0.20, 0.20, 0.20);
-      break;
-    case TEXT_A:
-      cairo_set_source_rgb(cr, 0.92, 0.61, 0.50);
-      break;
-    case TEXT_B:
-      cairo_set_source_rgb(cr, 0.64, 0.80, 0.82);
-      break;
-    case TEXT_C:
-      cairo_set_source_rgb(cr, 0.90, 0.90, 0.90);
-      break;
-    case WARNING:
-      cairo_set_source_rgb(cr, 0.85, 0.27, 0.27);
-      break;
-    case DARK_LINES:
-      cairo_set_source_rgb(cr, 0.30, 0.30, 0.30);
-      break;
-    case DARK_TEXT:
-      cairo_set_source_rgb(cr, 0.70, 0.70, 0.70);
-      break;
-    case INFO_ON:
-      cairo_set_source_rgb(cr, 0.15, 0.58, 0.60);
-      break;
-    case INFO_OFF:
-      cairo_set_source_rgb(cr, 0.20, 0.20, 0.20);
-      break;
-    default:
-      // Fallback: black
-      cairo_set_source_rgb(cr, 0.00, 0.00, 0.00);
-      break;
+  if(v==NULL) return;
+
+  if(!gtk_widget_get_mapped(v->vfo)) {
+    // no frame clock ticks for an unmapped widget
+    update_vfo_now(rx);
+    return;
   }
-}
\ No newline at end of file
+  if(v->refresh_id==0) {
+    v->refresh_id=gtk_widget_add_tick_callback(v->vfo,vfo_tick_cb,rx,NULL);
+  }
+}
@@ -19,23 +19,9 @@
 
 extern GtkWidget *create_vfo(RECEIVER *rx);
 extern void update_vfo(RECEIVER *r);
+extern void update_vfo_now(RECEIVER *r);
 
-extern void SetColour(cairo_t *cr, const int colour);
-
-enum {
-  BACKGROUND=0,
-  OFF_WHITE=1,
-  BOX_ON = 2,
-  BOX_OFF = 3,
-  TEXT_A = 4,
-  TEXT_B = 5,
-  TEXT_C = 6,
-  WARNING = 7,
-  DARK_LINES = 8,
-  DARK_TEXT = 9,
-  INFO_ON = 10,
-  INFO_OFF = 11
-};
+#include "colour.h"
 
 enum {
   CLICK_ON=0,
@@ -77,6 +63,7 @@ typedef struct _vfo_data {
   GtkWidget *xit_b;
   GtkWidget *xit_value;
   GtkWidget *dup_b;
+  guint refresh_id;    // pending frame clock refresh
 } VFO_DATA;
 
 #define STEPS 15
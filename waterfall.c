@@ -29,19 +29,18 @@
 #include "transmitter.h"
 #include "radio.h"
 #include "waterfall.h"
+#include "waterfall_ring.h"
+#include "colormap.h"
+#include "spectrum_history.h"
 #include "main.h"
-
-static int colorLowR=0; // black
-static int colorLowG=0;
-static int colorLowB=0;
-
-static int colorHighR=255; // yellow
-static int colorHighG=255;
-static int colorHighB=0;
+#include "display_renderer.h"
 
 static gboolean resize_timeout(void *data) {
   
   RECEIVER *rx=(RECEIVER *)data;
+  ReceiverThreadContext *ctx=&rx->thread_context;
+  // the render thread writes into the pixbuf
+  g_mutex_lock(&ctx->render_mutex);
   rx->pixels = rx->waterfall_resize_width * rx->zoom;
   rx->hz_per_pixel = (double)rx->sample_rate / rx->pixels;
 
@@ -56,16 +55,17 @@ static gboolean resize_timeout(void *data) {
     guchar *pixels = gdk_pixbuf_get_pixels (rx->waterfall_pixbuf);
     memset(pixels, 0, rx->waterfall_width*rx->waterfall_height*3);
   }
+  rx->waterfall_head=0;
+  g_atomic_int_inc(&rx->waterfall_generation);
   rx->waterfall_frequency=0;
   rx->waterfall_sample_rate=0;
   rx->waterfall_resize_timer=-1;
+  g_mutex_unlock(&ctx->render_mutex);
   return FALSE;
 }
 
-static gboolean waterfall_configure_event_cb(GtkWidget *widget,GdkEventConfigure *event,gpointer data) {
-  RECEIVER *rx=(RECEIVER *)data;
-  gint width=gtk_widget_get_allocated_width (widget);
-  gint height=gtk_widget_get_allocated_height (widget);
+// main thread: the widget size, applied once it has settled
+void waterfall_resize(RECEIVER *rx,int width,int height) {
   if(width!=rx->waterfall_width || height!=rx->waterfall_height) {
     rx->waterfall_resize_width=width;
     rx->waterfall_resize_height=height;
@@ -74,19 +74,8 @@ static gboolean waterfall_configure_event_cb(GtkWidget *widget,GdkEventConfigure
     }
     rx->waterfall_resize_timer=g_timeout_add(250,resize_timeout,(gpointer)rx);
   }
-  return TRUE;
-}
-
-static gboolean waterfall_draw_cb(GtkWidget *widget,cairo_t *cr,gpointer data) {
-  RECEIVER *rx=(RECEIVER *)data;
-  if(rx->waterfall_pixbuf) {
-    gdk_cairo_set_source_pixbuf (cr, rx->waterfall_pixbuf, 0, 0);
-    cairo_paint (cr);
-  }
-  return FALSE;
 }
 
-
 GtkWidget *create_waterfall(RECEIVER *rx) {
   GtkWidget *waterfall;
 
@@ -94,13 +83,11 @@ GtkWidget *create_waterfall(RECEIVER *rx) {
   rx->waterfall_height=0;
   rx->waterfall_resize_timer=-1;
   rx->waterfall_pixbuf=NULL;
+  rx->waterfall_head=0;
 
-  waterfall = gtk_drawing_area_new ();
+  waterfall = rx->renderer->waterfall_widget(rx);
   //gtk_widget_set_size_request (waterfall, rx->width, rx->height/3);
 
-  g_signal_connect(waterfall,"configure-event",G_CALLBACK (waterfall_configure_event_cb),(gpointer)rx);
-  g_signal_connect(waterfall,"draw",G_CALLBACK (waterfall_draw_cb),(gpointer)rx);
-
   g_signal_connect(waterfall,"motion-notify-event",G_CALLBACK(receiver_motion_notify_event_cb),rx);
   g_signal_connect(waterfall,"button-press-event",G_CALLBACK(receiver_button_press_event_cb),rx);
   g_signal_connect(waterfall,"button-release-event",G_CALLBACK(receiver_button_release_event_cb),rx);
@@ -121,21 +108,101 @@ GtkWidget *create_waterfall(RECEIVER *rx) {
 // Define maximum number of points to process (same as panadapter for consistency)
 #define MAX_PLOT_POINTS 640
 
-void update_waterfall(RECEIVER *rx) {
-    if (rx->waterfall_pixbuf && rx->waterfall_height > 1) {
+// Fastest rate a scrolled back waterfall is redrawn from the history
+#define WATERFALL_HISTORY_REDRAW_US 250000
+
+static float *waterfall_line(RECEIVER *rx, int width) {
+    if (rx->waterfall_line_size < width) {
+        g_free(rx->waterfall_line);
+        rx->waterfall_line = g_new(float, width);
+        rx->waterfall_line_size = width;
+    }
+    return rx->waterfall_line;
+}
+
+static COLORMAP *waterfall_colormap(RECEIVER *rx) {
+    if (rx->waterfall_colormap == NULL) {
+        rx->waterfall_colormap = create_colormap(rx->waterfall_palette, rx->waterfall_low, rx->waterfall_high);
+    }
+    COLORMAP *map = (COLORMAP *)rx->waterfall_colormap;
+    if (map->palette != rx->waterfall_palette || map->low != rx->waterfall_low || map->high != rx->waterfall_high) {
+        colormap_update(map, rx->waterfall_palette, rx->waterfall_low, rx->waterfall_high);
+    }
+    return map;
+}
+
+// The history file is opened on first use. It is named after the radio
+// so another radio does not show this one's history, and a second
+// instance of the program gets no history for the receivers it shares.
+static SPECTRUM_HISTORY *waterfall_history(RECEIVER *rx) {
+    if (!rx->waterfall_history) return NULL;
+    if (rx->spectrum_history == NULL && !rx->spectrum_history_failed) {
+        char id[80];
+        char filename[256];
+        radio_id(radio, id, sizeof(id));
+        snprintf(filename, sizeof(filename), "%s/.local/share/linhpsdr/%s-rx%d.hist", g_get_home_dir(), id, rx->channel);
+        rx->spectrum_history = create_spectrum_history(filename);
+        rx->spectrum_history_failed = rx->spectrum_history == NULL;
+    }
+    return (SPECTRUM_HISTORY *)rx->spectrum_history;
+}
+
+// Redraw every row of the pixbuf from the history, newest at the top
+static void waterfall_redraw(RECEIVER *rx, SPECTRUM_HISTORY *h, int level, gint64 before_us,
+                             double start_hz, double hz_per_pixel, float attenuation) {
+    guchar *pixels = gdk_pixbuf_get_pixels(rx->waterfall_pixbuf);
+    int width = gdk_pixbuf_get_width(rx->waterfall_pixbuf);
+    int height = gdk_pixbuf_get_height(rx->waterfall_pixbuf);
+    int rowstride = gdk_pixbuf_get_rowstride(rx->waterfall_pixbuf);
+    float *line = waterfall_line(rx, width);
+    COLORMAP *map = waterfall_colormap(rx);
+    guint64 serial = spectrum_history_find(h, level, before_us);
+    int y;
+
+    for (y = 0; y < height; y++) {
+        if (serial == 0 || !spectrum_history_row(h, level, serial - 1, start_hz, hz_per_pixel, width, line)) {
+            break;
+        }
+        serial--;
+        colormap_row(map, line, attenuation, pixels + y * rowstride, width);
+    }
+    if (y < height) {
+        memset(pixels + y * rowstride, 0, (height - y) * rowstride);
+    }
+    g_atomic_int_set(&rx->waterfall_head, 0);
+    g_atomic_int_inc(&rx->waterfall_generation);
+}
+
+// Runs on the receiver's render thread with render_mutex held. 'samples'
+// is a panadapter frame, or a line from the waterfall stream when the
+// waterfall has its own rate.
+void update_waterfall(RECEIVER *rx, const float *samples, int samples_n) {
+    if (rx->waterfall_pixbuf && rx->waterfall_height > 1 && samples != NULL && samples_n > 0) {
         guchar *pixels = gdk_pixbuf_get_pixels(rx->waterfall_pixbuf);
         guchar *p;
         int width = gdk_pixbuf_get_width(rx->waterfall_pixbuf);
         int height = gdk_pixbuf_get_height(rx->waterfall_pixbuf);
         int rowstride = gdk_pixbuf_get_rowstride(rx->waterfall_pixbuf);
+        guchar *row;
+        float attenuation = (float)radio->adc[rx->adc].attenuation;
+
+        // Absolute frequency of the first sample, as the panadapter draws it
+        double hz_per_sample = (double)rx->sample_rate / (double)rx->pixels;
+        double start_hz = (double)rx->frequency_a - ((double)rx->pixels / 2.0 - (double)rx->pan) * hz_per_sample;
+        double hz_per_pixel = hz_per_sample * (double)samples_n / (double)width;
+        gint64 now = g_get_real_time();
+
+        SPECTRUM_HISTORY *history = waterfall_history(rx);
+        if (history != NULL) {
+            spectrum_history_add(history, now, start_hz, hz_per_sample, samples, samples_n);
+        }
 
         // Check for changes in frequency, pan, zoom, or sample rate
-        if (rx->waterfall_frequency != rx->frequency_a ||
+        gboolean changed = rx->waterfall_frequency != rx->frequency_a ||
             rx->waterfall_pan != rx->pan ||
             rx->waterfall_zoom != rx->zoom ||
-            rx->waterfall_sample_rate != rx->sample_rate) {
-            // Clear the entire pixbuf
-            memset(pixels, 0, width * height * 3);
+            rx->waterfall_sample_rate != rx->sample_rate;
+        if (changed) {
             // Update stored values
             rx->waterfall_frequency = rx->frequency_a;
             rx->waterfall_pan = rx->pan;
@@ -143,127 +210,104 @@ void update_waterfall(RECEIVER *rx) {
             rx->waterfall_sample_rate = rx->sample_rate;
         }
 
-        // Move existing rows down
-        memmove(&pixels[rowstride], pixels, (height - 1) * rowstride);
-
-        // Capped resolution loop
-        float *samples = rx->pixel_samples;
-        int offset = rx->pan;
-        int average = 0;
+        // Scrolled back or at a coarser time scale everything comes from
+        // the history, redrawn when a row is added to the level shown
+        int level = rx->waterfall_history_level;
+        if (level < 0) level = 0;
+        if (level >= HISTORY_LEVELS) level = HISTORY_LEVELS - 1;
+        if (history != NULL && (level > 0 || rx->waterfall_scrollback > 0)) {
+            guint64 serial = spectrum_history_serial(history, level);
+            gboolean moved = level != rx->waterfall_history_shown_level ||
+                rx->waterfall_scrollback != rx->waterfall_history_shown_scrollback;
+            if (changed || moved || (serial != rx->waterfall_history_serial &&
+                                     now - rx->waterfall_history_time >= WATERFALL_HISTORY_REDRAW_US)) {
+                waterfall_redraw(rx, history, level, now - (gint64)rx->waterfall_scrollback * G_USEC_PER_SEC,
+                                 start_hz, hz_per_pixel, attenuation);
+                rx->waterfall_history_serial = serial;
+                rx->waterfall_history_time = now;
+                rx->waterfall_history_shown_level = level;
+                rx->waterfall_history_shown_scrollback = rx->waterfall_scrollback;
+            }
+            return;
+        }
+        if (rx->waterfall_history_shown_level != 0 || rx->waterfall_history_shown_scrollback != 0) {
+            // back to live
+            rx->waterfall_history_shown_level = 0;
+            rx->waterfall_history_shown_scrollback = 0;
+            changed = TRUE;
+        }
 
-        int plot_points = MIN(width, MAX_PLOT_POINTS);
-        double sample_step = (double)width / plot_points;
-        double pixel_step = (double)width / (plot_points - 1);
+        if (changed) {
+            // Show what the history has for the new view instead of a blank
+            // waterfall, less the row added above which is drawn below
+            if (history != NULL) {
+                waterfall_redraw(rx, history, 0, now - 1, start_hz, hz_per_pixel, attenuation);
+            } else {
+                memset(pixels, 0, height * rowstride);
+                g_atomic_int_set(&rx->waterfall_head, 0);
+                g_atomic_int_inc(&rx->waterfall_generation);
+            }
+        }
 
-        int sample_width = rx->pixels / rx->zoom;
-        if (sample_width > width) sample_width = width;
+        // The pixbuf is a ring of rows, only the newest row is written
+        gint head;
+        row = waterfall_ring_next_row(rx->waterfall_pixbuf, rx->waterfall_head, &head);
 
-        long long half = ((long long)rx->sample_rate / 2) / (rx->zoom);
-        long long min_display = rx->frequency_a - half;
+        float *line = waterfall_line(rx, width);
+        int offset = 0;                     // samples are already the visible slice
+        double average = 0.0;
+        int count = 0;
 
-        guchar *colors = g_new(guchar, plot_points * 3);
-        for (int i = 0; i < plot_points; i++) {
-            double sample_idx = i * sample_step + offset;
-            int idx_floor = (int)sample_idx;
-            double frac = sample_idx - idx_floor;
+        int sample_width = samples_n;
+        if (sample_width > width) sample_width = width;
 
-            if (idx_floor < 0) idx_floor = 0;
-            if (idx_floor >= rx->pixels) idx_floor = rx->pixels - 1;
-            if (idx_floor + 1 >= rx->pixels) idx_floor = rx->pixels - 1;
+        if (rx->waterfall_subsample) {
+            // Capped resolution: interpolate at most MAX_PLOT_POINTS samples,
+            // then stretch them over the row
+            int plot_points = MIN(width, MAX_PLOT_POINTS);
+            double sample_step = (double)width / plot_points;
 
-            double s;
-            if (idx_floor + 1 < rx->pixels) {
-                double s_floor = (double)samples[idx_floor] + radio->adc[rx->adc].attenuation;
-                double s_ceil = (double)samples[idx_floor + 1] + radio->adc[rx->adc].attenuation;
-                s = s_floor + (s_ceil - s_floor) * frac;
-            } else {
-                s = (double)samples[idx_floor] + radio->adc[rx->adc].attenuation;
-            }
+            for (int i = 0; i < plot_points; i++) {
+                double sample_idx = i * sample_step + offset;
+                int idx_floor = (int)sample_idx;
+                double frac = sample_idx - idx_floor;
 
-            if (i > 0 && i < plot_points - 1) {
-                average += (int)s;
-            }
+                if (idx_floor < 0) idx_floor = 0;
+                if (idx_floor >= samples_n) idx_floor = samples_n - 1;
 
-            guchar r, g, b;
-            if (s < (float)rx->waterfall_low) {
-                r = colorLowR;
-                g = colorLowG;
-                b = colorLowB;
-            } else if (s > (float)rx->waterfall_high) {
-                r = colorHighR;
-                g = colorHighG;
-                b = colorHighB;
-            } else {
-                float range = (float)rx->waterfall_high - (float)rx->waterfall_low;
-                float offset = s - (float)rx->waterfall_low;
-                float percent = offset / range;
-                if (percent < (2.0f / 9.0f)) {
-                    float local_percent = percent / (2.0f / 9.0f);
-                    r = (int)((1.0f - local_percent) * colorLowR);
-                    g = (int)((1.0f - local_percent) * colorLowG);
-                    b = (int)(colorLowB + local_percent * (255 - colorLowB));
-                } else if (percent < (3.0f / 9.0f)) {
-                    float local_percent = (percent - 2.0f / 9.0f) / (1.0f / 9.0f);
-                    r = 0;
-                    g = (int)(local_percent * 255);
-                    b = 255;
-                } else if (percent < (4.0f / 9.0f)) {
-                    float local_percent = (percent - 3.0f / 9.0f) / (1.0f / 9.0f); // Fixed range
-                    r = 0;
-                    g = 255;
-                    b = (int)((1.0f - local_percent) * 255);
-                } else if (percent < (5.0f / 9.0f)) {
-                    float local_percent = (percent - 4.0f / 9.0f) / (1.0f / 9.0f);
-                    r = (int)(local_percent * 255);
-                    g = 255;
-                    b = 0;
-                } else if (percent < (7.0f / 9.0f)) {
-                    float local_percent = (percent - 5.0f / 9.0f) / (2.0f / 9.0f);
-                    r = 255;
-                    g = (int)((1.0f - local_percent) * 255);
-                    b = 0;
-                } else if (percent < (8.0f / 9.0f)) {
-                    float local_percent = (percent - 7.0f / 9.0f) / (1.0f / 9.0f);
-                    r = 255;
-                    g = 0;
-                    b = (int)(local_percent * 255);
+                double s;
+                if (idx_floor + 1 < samples_n) {
+                    s = samples[idx_floor] + (samples[idx_floor + 1] - samples[idx_floor]) * frac;
                 } else {
-                    float local_percent = (percent - 8.0f / 9.0f) / (1.0f / 9.0f);
-                    r = (int)((0.75f + 0.25f * (1.0f - local_percent)) * 255.0f);
-                    g = (int)(local_percent * 255.0f * 0.5f);
-                    b = 255;
+                    s = samples[idx_floor];
+                }
+                line[i] = (float)s;
+                if (i > 0 && i < plot_points - 1) {
+                    average += s;
+                    count++;
                 }
             }
-
-            colors[i * 3] = r;
-            colors[i * 3 + 1] = g;
-            colors[i * 3 + 2] = b;
-        }
-
-        guchar *line_buffer = g_new(guchar, width * 3);
-        for (int x = 0; x < width; x++) {
-            double t = (double)x * sample_width / width;
-            t = t * plot_points / sample_width;
-            int i = (int)t;
-            double frac = t - i;
-            if (i + 1 >= plot_points) {
-                i = plot_points - 1;
-                frac = 0.0;
+            // Expand in place from the right, each pixel only reads at or before itself
+            for (int x = width - 1; x >= 0; x--) {
+                int i = (int)((long long)x * plot_points / width);
+                if (i >= plot_points) i = plot_points - 1;
+                line[x] = line[i];
             }
-
-            guchar r = colors[i * 3];
-            guchar g = colors[i * 3 + 1];
-            guchar b = colors[i * 3 + 2];
-
-            line_buffer[x * 3] = r;
-            line_buffer[x * 3 + 1] = g;
-            line_buffer[x * 3 + 2] = b;
+        } else {
+            // Full resolution: one analyzer pixel per waterfall pixel
+            for (int x = 0; x < width; x++) {
+                int idx = offset + (int)((long long)x * sample_width / width);
+                if (idx < 0) idx = 0;
+                if (idx >= samples_n) idx = samples_n - 1;
+                line[x] = samples[idx];
+            }
+            for (int x = 1; x < width - 1; x++) {
+                average += line[x];
+            }
+            count = width - 2;
         }
 
-        memcpy(pixels, line_buffer, width * 3);
-
-        g_free(colors);
-        g_free(line_buffer);
+        colormap_row(waterfall_colormap(rx), line, attenuation, row, width);
 
         // FT8 marker logic
         if (rx->waterfall_ft8_marker) {
@@ -271,7 +315,7 @@ void update_waterfall(RECEIVER *rx) {
             int tim = time(NULL);
             if (tim % 15 == 0) {
                 if (tim0 == 0) {
-                    p = pixels;
+                    p = row;
                     for (int i = 0; i < width; i++) {
                         *p++ = 255;
                         *p++ = 0;
@@ -284,11 +328,11 @@ void update_waterfall(RECEIVER *rx) {
             }
         }
 
-        if (rx->waterfall_automatic) {
-            rx->waterfall_low = (average / (plot_points - 2)) - 14;
+        waterfall_ring_publish(&rx->waterfall_head, head);
+
+        if (rx->waterfall_automatic && count > 0) {
+            rx->waterfall_low = (int)(average / count + attenuation) - 14;
             rx->waterfall_high = rx->waterfall_low + 80;
         }
-
-        gtk_widget_queue_draw(rx->waterfall);
     }
-}
\ No newline at end of file
+}
@@ -18,4 +18,5 @@
 */
 
 extern GtkWidget *create_waterfall(RECEIVER *rx);
-extern void update_waterfall(RECEIVER *rx);
+extern void waterfall_resize(RECEIVER *rx,int width,int height);
+extern void update_waterfall(RECEIVER *rx,const float *samples,int samples_n);
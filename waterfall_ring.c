@@ -0,0 +1,74 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+#include <gtk/gtk.h>
+
+#include "waterfall_ring.h"
+
+//
+// Waterfall pixbufs are used as a circular buffer of rows. 'head' is the
+// row holding the newest line; older lines follow it downwards and wrap
+// around to row 0. Adding a line only writes one row instead of scrolling
+// the whole image, and the draw handler undoes the rotation with two blits.
+//
+// The row is filled before the new head is published, so a draw handler
+// on another thread never shows a half written line at the top.
+//
+
+guchar *waterfall_ring_next_row(GdkPixbuf *pixbuf,gint head,gint *next) {
+  int height=gdk_pixbuf_get_height(pixbuf);
+  int rowstride=gdk_pixbuf_get_rowstride(pixbuf);
+  guchar *pixels=gdk_pixbuf_get_pixels(pixbuf);
+
+  if(head<=0 || head>height) {
+    head=height;
+  }
+  *next=head-1;
+  return pixels+(*next*rowstride);
+}
+
+void waterfall_ring_publish(gint *head,gint next) {
+  g_atomic_int_set(head,next);
+}
+
+void waterfall_ring_draw(cairo_t *cr,GdkPixbuf *pixbuf,gint head) {
+  int width=gdk_pixbuf_get_width(pixbuf);
+  int height=gdk_pixbuf_get_height(pixbuf);
+  int newer=height-head;   // rows from head to the bottom of the pixbuf
+
+  if(head<=0 || head>=height) {
+    gdk_cairo_set_source_pixbuf(cr,pixbuf,0,0);
+    cairo_paint(cr);
+    return;
+  }
+
+  cairo_surface_t *surface=gdk_cairo_surface_create_from_pixbuf(pixbuf,1,NULL);
+
+  // newest rows at the top
+  cairo_set_source_surface(cr,surface,0,-head);
+  cairo_rectangle(cr,0,0,width,newer);
+  cairo_fill(cr);
+
+  // older rows, which wrapped to the start of the pixbuf, below them
+  cairo_set_source_surface(cr,surface,0,newer);
+  cairo_rectangle(cr,0,newer,width,head);
+  cairo_fill(cr);
+
+  cairo_surface_destroy(surface);
+}
@@ -0,0 +1,98 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "waterfall_stream.h"
+
+void waterfall_stream_init(WATERFALL_STREAM *s) {
+  memset(s,0,sizeof(WATERFALL_STREAM));
+}
+
+void waterfall_stream_free(WATERFALL_STREAM *s) {
+  g_free(s->line);
+  waterfall_stream_init(s);
+}
+
+// main thread, for every analyzer frame: TRUE when s->line holds a
+// finished line, valid until the next call. Averaging is done on the dB
+// values, like the display averaging.
+gboolean waterfall_stream_add(WATERFALL_STREAM *s,const gfloat *samples,gint n,gint combine,gint rate,gint64 now_us) {
+  gint64 interval=G_USEC_PER_SEC/(rate>0?rate:1);
+  int i;
+
+  if(n<=0) return FALSE;
+  if(n!=s->n) {
+    if(s->size<n) {
+      g_free(s->line);
+      s->line=g_new(gfloat,n);
+      s->size=n;
+    }
+    s->n=n;
+    s->frames=0;
+  }
+
+  if(s->frames==0) {
+    memcpy(s->line,samples,n*sizeof(gfloat));
+    if(s->next_us==0 || now_us-s->next_us>G_USEC_PER_SEC) {
+      // first line, or the frames stopped for a while
+      s->next_us=now_us+interval;
+    }
+  } else if(combine==WATERFALL_COMBINE_PEAK) {
+    for(i=0;i<n;i++) {
+      s->line[i]=samples[i]>s->line[i]?samples[i]:s->line[i];
+    }
+  } else {
+    for(i=0;i<n;i++) {
+      s->line[i]+=samples[i];
+    }
+  }
+  s->frames++;
+
+  if(now_us<s->next_us) return FALSE;
+
+  if(combine!=WATERFALL_COMBINE_PEAK && s->frames>1) {
+    const gfloat scale=1.0f/(gfloat)s->frames;
+    for(i=0;i<n;i++) {
+      s->line[i]*=scale;
+    }
+  }
+  s->frames=0;
+  s->next_us+=interval;
+  if(s->next_us<now_us) s->next_us=now_us;
+  s->lines++;
+  return TRUE;
+}
+
+// main thread, after publishing a line: TRUE if the render thread has to
+// be woken, FALSE if it has not taken the previous line yet
+gboolean waterfall_stream_submit(WATERFALL_STREAM *s) {
+  if(!g_atomic_int_compare_and_exchange(&s->pending,0,1)) {
+    s->dropped++;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// render thread, before taking the newest line
+void waterfall_stream_take(WATERFALL_STREAM *s) {
+  g_atomic_int_set(&s->pending,0);
+}
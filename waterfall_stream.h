@@ -0,0 +1,52 @@
+/* Copyright (C)
+* 2025
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+*/
+
+
+#ifndef _WATERFALL_STREAM_H
+#define _WATERFALL_STREAM_H
+
+//
+// Waterfall lines at their own rate, built from the analyzer frames the
+// panadapter gets. Every frame between two lines is combined into the
+// next one, so a slow waterfall does not need a low panadapter frame rate
+// and a fast one does not redraw the panadapter. The analyzer runs at
+// the receiver's fps, a faster line rate gives one line per frame.
+//
+
+#define WATERFALL_COMBINE_AVERAGE 0
+#define WATERFALL_COMBINE_PEAK 1
+
+typedef struct _waterfall_stream {
+  gfloat *line;             // line being built
+  gint size;
+  gint n;
+  gint frames;              // analyzer frames in it so far
+  gint64 next_us;           // when the line is due
+  gint pending;             // a line is waiting for the render thread
+  guint lines;
+  guint dropped;            // superseded before the render thread took them
+} WATERFALL_STREAM;
+
+extern void waterfall_stream_init(WATERFALL_STREAM *s);
+extern void waterfall_stream_free(WATERFALL_STREAM *s);
+extern gboolean waterfall_stream_add(WATERFALL_STREAM *s,const gfloat *samples,gint n,gint combine,gint rate,gint64 now_us);
+extern gboolean waterfall_stream_submit(WATERFALL_STREAM *s);
+extern void waterfall_stream_take(WATERFALL_STREAM *s);
+
+#endif
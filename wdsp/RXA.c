@@ -74,8 +74,7 @@ void create_rxa (int channel)
         ch[channel].dsp_rate,                           // samplerate
         0.100,                                          // averaging time constant
         0.100,                                          // peak decay time constant
-        rxa[channel].meter,                             // result vector
-        rxa[channel].pmtupdate,                         // locks for meter access
+        rxa[channel].pmeter,                            // meters for lock-free reads
         RXA_ADC_AV,                                     // index for average value
         RXA_ADC_PK,                                     // index for peak value
         -1,                                             // index for gain value
@@ -147,8 +146,7 @@ void create_rxa (int channel)
         ch[channel].dsp_rate,                           // samplerate
         0.100,                                          // averaging time constant
         0.100,                                          // peak decay time constant
-        rxa[channel].meter,                             // result vector
-        rxa[channel].pmtupdate,                         // locks for meter access
+        rxa[channel].pmeter,                            // meters for lock-free reads
         RXA_S_AV,                                       // index for average value
         RXA_S_PK,                                       // index for peak value
         -1,                                             // index for gain value
@@ -366,8 +364,7 @@ void create_rxa (int channel)
         ch[channel].dsp_rate,                           // samplerate
         0.100,                                          // averaging time constant
         0.100,                                          // peak decay time constant
-        rxa[channel].meter,                             // result vector
-        rxa[channel].pmtupdate,                         // locks for meter access
+        rxa[channel].pmeter,                            // meters for lock-free reads
         RXA_AGC_AV,                                     // index for average value
         RXA_AGC_PK,                                     // index for peak value
         RXA_AGC_GAIN,                                   // index for gain value
@@ -560,41 +557,43 @@ void flush_rxa (int channel)
 
 void xrxa (int channel)
 {
-    xshift (rxa[channel].shift.p);
-    xresample (rxa[channel].rsmpin.p);
-    xgen (rxa[channel].gen0.p);
-    xmeter (rxa[channel].adcmeter.p);
-    xbpsnbain (rxa[channel].bpsnba.p, 0);
-    xnbp (rxa[channel].nbp0.p, 0);
-    xmeter (rxa[channel].smeter.p);
-    xsender (rxa[channel].sender.p);
-    xamsqcap (rxa[channel].amsq.p);
-    xbpsnbaout (rxa[channel].bpsnba.p, 0);
-    xamd (rxa[channel].amd.p);
-    xfmd (rxa[channel].fmd.p);
-    xfmsq (rxa[channel].fmsq.p);
-    xbpsnbain (rxa[channel].bpsnba.p, 1);
-    xbpsnbaout (rxa[channel].bpsnba.p, 1);
-    xsnba (rxa[channel].snba.p);
-    xeqp (rxa[channel].eqp.p);
-    xanf (rxa[channel].anf.p, 0);
-    xanr (rxa[channel].anr.p, 0);
-    xemnr (rxa[channel].emnr.p, 0);
-    xbandpass (rxa[channel].bp1.p, 0);
-    xwcpagc (rxa[channel].agc.p);
-    xanf (rxa[channel].anf.p, 1);
-    xanr (rxa[channel].anr.p, 1);
-    xemnr (rxa[channel].emnr.p, 1);
-    xbandpass (rxa[channel].bp1.p, 1);
-    xmeter (rxa[channel].agcmeter.p);
-    xsiphon (rxa[channel].sip1.p, 0);
-    xcbl (rxa[channel].cbl.p);
-    xspeak (rxa[channel].speak.p);
-    xmpeak (rxa[channel].mpeak.p);
-    xssql (rxa[channel].ssql.p);
-    xpanel (rxa[channel].panel.p);
-    xamsq (rxa[channel].amsq.p);
-    xresample (rxa[channel].rsmpout.p);
+    PROF p = begin_prof (channel);
+    xshift (rxa[channel].shift.p);                  PROF_MARK (p, "shift");
+    xresample (rxa[channel].rsmpin.p);              PROF_MARK (p, "rsmpin");
+    xgen (rxa[channel].gen0.p);                     PROF_MARK (p, "gen0");
+    xmeter (rxa[channel].adcmeter.p);               PROF_MARK (p, "adcmeter");
+    xbpsnbain (rxa[channel].bpsnba.p, 0);           PROF_MARK (p, "bpsnbain 0");
+    xnbp (rxa[channel].nbp0.p, 0);                  PROF_MARK (p, "nbp0 0");
+    xmeter (rxa[channel].smeter.p);                 PROF_MARK (p, "smeter");
+    xsender (rxa[channel].sender.p);                PROF_MARK (p, "sender");
+    xamsqcap (rxa[channel].amsq.p);                 PROF_MARK (p, "amsqcap");
+    xbpsnbaout (rxa[channel].bpsnba.p, 0);          PROF_MARK (p, "bpsnbaout 0");
+    xamd (rxa[channel].amd.p);                      PROF_MARK (p, "amd");
+    xfmd (rxa[channel].fmd.p);                      PROF_MARK (p, "fmd");
+    xfmsq (rxa[channel].fmsq.p);                    PROF_MARK (p, "fmsq");
+    xbpsnbain (rxa[channel].bpsnba.p, 1);           PROF_MARK (p, "bpsnbain 1");
+    xbpsnbaout (rxa[channel].bpsnba.p, 1);          PROF_MARK (p, "bpsnbaout 1");
+    xsnba (rxa[channel].snba.p);                    PROF_MARK (p, "snba");
+    xeqp (rxa[channel].eqp.p);                      PROF_MARK (p, "eqp");
+    xanf (rxa[channel].anf.p, 0);                   PROF_MARK (p, "anf 0");
+    xanr (rxa[channel].anr.p, 0);                   PROF_MARK (p, "anr 0");
+    xemnr (rxa[channel].emnr.p, 0);                 PROF_MARK (p, "emnr 0");
+    xbandpass (rxa[channel].bp1.p, 0);              PROF_MARK (p, "bp1 0");
+    xwcpagc (rxa[channel].agc.p);                   PROF_MARK (p, "agc");
+    xanf (rxa[channel].anf.p, 1);                   PROF_MARK (p, "anf 1");
+    xanr (rxa[channel].anr.p, 1);                   PROF_MARK (p, "anr 1");
+    xemnr (rxa[channel].emnr.p, 1);                 PROF_MARK (p, "emnr 1");
+    xbandpass (rxa[channel].bp1.p, 1);              PROF_MARK (p, "bp1 1");
+    xmeter (rxa[channel].agcmeter.p);               PROF_MARK (p, "agcmeter");
+    xsiphon (rxa[channel].sip1.p, 0);               PROF_MARK (p, "sip1 0");
+    xcbl (rxa[channel].cbl.p);                      PROF_MARK (p, "cbl");
+    xspeak (rxa[channel].speak.p);                  PROF_MARK (p, "speak");
+    xmpeak (rxa[channel].mpeak.p);                  PROF_MARK (p, "mpeak");
+    xssql (rxa[channel].ssql.p);                    PROF_MARK (p, "ssql");
+    xpanel (rxa[channel].panel.p);                  PROF_MARK (p, "panel");
+    xamsq (rxa[channel].amsq.p);                    PROF_MARK (p, "amsq");
+    xresample (rxa[channel].rsmpout.p);             PROF_MARK (p, "rsmpout");
+    PROF_END (p);
 }
 
 void setInputSamplerate_rxa (int channel)
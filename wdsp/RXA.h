@@ -62,8 +62,7 @@ struct _rxa
     double* outbuff;
     double* midbuff;
     int mode;
-    double meter[RXA_METERTYPE_LAST];
-    CRITICAL_SECTION* pmtupdate[RXA_METERTYPE_LAST];
+    METER pmeter[RXA_METERTYPE_LAST];
     struct
     {
         METER p;
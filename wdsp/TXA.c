@@ -85,8 +85,7 @@ void create_txa (int channel)
         ch[channel].dsp_rate,                       // samplerate
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
-        txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        txa[channel].pmeter,                        // meters for lock-free reads
         TXA_MIC_AV,                                 // index for average value
         TXA_MIC_PK,                                 // index for peak value
         -1,                                         // index for gain value
@@ -135,8 +134,7 @@ void create_txa (int channel)
         ch[channel].dsp_rate,                       // samplerate
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
-        txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        txa[channel].pmeter,                        // meters for lock-free reads
         TXA_EQ_AV,                                  // index for average value
         TXA_EQ_PK,                                  // index for peak value
         -1,                                         // index for gain value
@@ -188,8 +186,7 @@ void create_txa (int channel)
         ch[channel].dsp_rate,                       // samplerate
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
-        txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        txa[channel].pmeter,                        // meters for lock-free reads
         TXA_LVLR_AV,                                // index for average value
         TXA_LVLR_PK,                                // index for peak value
         TXA_LVLR_GAIN,                              // index for gain value
@@ -229,8 +226,7 @@ void create_txa (int channel)
         ch[channel].dsp_rate,                       // samplerate
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
-        txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        txa[channel].pmeter,                        // meters for lock-free reads
         TXA_CFC_AV,                                 // index for average value
         TXA_CFC_PK,                                 // index for peak value
         TXA_CFC_GAIN,                               // index for gain value
@@ -301,8 +297,7 @@ void create_txa (int channel)
         ch[channel].dsp_rate,                       // samplerate
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
-        txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        txa[channel].pmeter,                        // meters for lock-free reads
         TXA_COMP_AV,                                // index for average value
         TXA_COMP_PK,                                // index for peak value
         -1,                                         // index for gain value
@@ -384,8 +379,7 @@ void create_txa (int channel)
         ch[channel].dsp_rate,                       // samplerate
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
-        txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        txa[channel].pmeter,                        // meters for lock-free reads
         TXA_ALC_AV,                                 // index for average value
         TXA_ALC_PK,                                 // index for peak value
         TXA_ALC_GAIN,                               // index for gain value
@@ -467,8 +461,7 @@ void create_txa (int channel)
         ch[channel].out_rate,                       // samplerate
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
-        txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        txa[channel].pmeter,                        // meters for lock-free reads
         TXA_OUT_AV,                                 // index for average value
         TXA_OUT_PK,                                 // index for peak value
         -1,                                         // index for gain value
@@ -556,39 +549,41 @@ void flush_txa (int channel)
 
 void xtxa (int channel)
 {
-    xresample (txa[channel].rsmpin.p);              // input resampler
-    xgen (txa[channel].gen0.p);                     // input signal generator
-    xpanel (txa[channel].panel.p);                  // includes MIC gain
-    xphrot (txa[channel].phrot.p);                  // phase rotator
-    xmeter (txa[channel].micmeter.p);               // MIC meter
-    xamsqcap (txa[channel].amsq.p);                 // downward expander capture
-    xamsq (txa[channel].amsq.p);                    // downward expander action
-    xeqp (txa[channel].eqp.p);                      // pre-EQ
-    xmeter (txa[channel].eqmeter.p);                // EQ meter
-    xemphp (txa[channel].preemph.p, 0);             // FM pre-emphasis (first option)
-    xwcpagc (txa[channel].leveler.p);               // Leveler
-    xmeter (txa[channel].lvlrmeter.p);              // Leveler Meter
-    xcfcomp (txa[channel].cfcomp.p, 0);             // Continuous Frequency Compressor with post-EQ
-    xmeter (txa[channel].cfcmeter.p);               // CFC+PostEQ Meter
-    xbandpass (txa[channel].bp0.p, 0);              // primary bandpass filter
-    xcompressor (txa[channel].compressor.p);        // COMP compressor
-    xbandpass (txa[channel].bp1.p, 0);              // aux bandpass (runs if COMP)
-    xosctrl (txa[channel].osctrl.p);                // CESSB Overshoot Control
-    xbandpass (txa[channel].bp2.p, 0);              // aux bandpass (runs if CESSB)
-    xmeter (txa[channel].compmeter.p);              // COMP meter
-    xwcpagc (txa[channel].alc.p);                   // ALC
-    xammod (txa[channel].ammod.p);                  // AM Modulator
-    xemphp (txa[channel].preemph.p, 1);             // FM pre-emphasis (second option)
-    xfmmod (txa[channel].fmmod.p);                  // FM Modulator
-    xgen (txa[channel].gen1.p);                     // output signal generator (TUN and Two-tone)
-    xuslew (txa[channel].uslew.p);                  // up-slew for AM, FM, and gens
-    xmeter (txa[channel].alcmeter.p);               // ALC Meter
-    xsiphon (txa[channel].sip1.p, 0);               // siphon data for display
-    xiqc (txa[channel].iqc.p0);                     // PureSignal correction
-    xcfir(txa[channel].cfir.p);                     // compensating FIR filter (used Protocol_2 only)
-    xresample (txa[channel].rsmpout.p);             // output resampler
-    xmeter (txa[channel].outmeter.p);               // output meter
+    PROF p = begin_prof (channel);
+    xresample (txa[channel].rsmpin.p);              PROF_MARK (p, "rsmpin");        // input resampler
+    xgen (txa[channel].gen0.p);                     PROF_MARK (p, "gen0");          // input signal generator
+    xpanel (txa[channel].panel.p);                  PROF_MARK (p, "panel");         // includes MIC gain
+    xphrot (txa[channel].phrot.p);                  PROF_MARK (p, "phrot");         // phase rotator
+    xmeter (txa[channel].micmeter.p);               PROF_MARK (p, "micmeter");      // MIC meter
+    xamsqcap (txa[channel].amsq.p);                 PROF_MARK (p, "amsqcap");       // downward expander capture
+    xamsq (txa[channel].amsq.p);                    PROF_MARK (p, "amsq");          // downward expander action
+    xeqp (txa[channel].eqp.p);                      PROF_MARK (p, "eqp");           // pre-EQ
+    xmeter (txa[channel].eqmeter.p);                PROF_MARK (p, "eqmeter");       // EQ meter
+    xemphp (txa[channel].preemph.p, 0);             PROF_MARK (p, "preemph 0");     // FM pre-emphasis (first option)
+    xwcpagc (txa[channel].leveler.p);               PROF_MARK (p, "leveler");       // Leveler
+    xmeter (txa[channel].lvlrmeter.p);              PROF_MARK (p, "lvlrmeter");     // Leveler Meter
+    xcfcomp (txa[channel].cfcomp.p, 0);             PROF_MARK (p, "cfcomp 0");      // Continuous Frequency Compressor with post-EQ
+    xmeter (txa[channel].cfcmeter.p);               PROF_MARK (p, "cfcmeter");      // CFC+PostEQ Meter
+    xbandpass (txa[channel].bp0.p, 0);              PROF_MARK (p, "bp0 0");         // primary bandpass filter
+    xcompressor (txa[channel].compressor.p);        PROF_MARK (p, "compressor");    // COMP compressor
+    xbandpass (txa[channel].bp1.p, 0);              PROF_MARK (p, "bp1 0");         // aux bandpass (runs if COMP)
+    xosctrl (txa[channel].osctrl.p);                PROF_MARK (p, "osctrl");        // CESSB Overshoot Control
+    xbandpass (txa[channel].bp2.p, 0);              PROF_MARK (p, "bp2 0");         // aux bandpass (runs if CESSB)
+    xmeter (txa[channel].compmeter.p);              PROF_MARK (p, "compmeter");     // COMP meter
+    xwcpagc (txa[channel].alc.p);                   PROF_MARK (p, "alc");           // ALC
+    xammod (txa[channel].ammod.p);                  PROF_MARK (p, "ammod");         // AM Modulator
+    xemphp (txa[channel].preemph.p, 1);             PROF_MARK (p, "preemph 1");     // FM pre-emphasis (second option)
+    xfmmod (txa[channel].fmmod.p);                  PROF_MARK (p, "fmmod");         // FM Modulator
+    xgen (txa[channel].gen1.p);                     PROF_MARK (p, "gen1");          // output signal generator (TUN and Two-tone)
+    xuslew (txa[channel].uslew.p);                  PROF_MARK (p, "uslew");         // up-slew for AM, FM, and gens
+    xmeter (txa[channel].alcmeter.p);               PROF_MARK (p, "alcmeter");      // ALC Meter
+    xsiphon (txa[channel].sip1.p, 0);               PROF_MARK (p, "sip1 0");        // siphon data for display
+    xiqc (txa[channel].iqc.p0);                     PROF_MARK (p, "iqc");           // PureSignal correction
+    xcfir (txa[channel].cfir.p);                    PROF_MARK (p, "cfir");          // compensating FIR filter (used Protocol_2 only)
+    xresample (txa[channel].rsmpout.p);             PROF_MARK (p, "rsmpout");       // output resampler
+    xmeter (txa[channel].outmeter.p);               PROF_MARK (p, "outmeter");      // output meter
     // print_peak_env ("env_exception.txt", ch[channel].dsp_outsize, txa[channel].outbuff, 0.7);
+    PROF_END (p);
 }
 
 void setInputSamplerate_txa (int channel)
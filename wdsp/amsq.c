@@ -177,7 +177,8 @@ void xamsq (AMSQ a)
 
 void xamsqcap (AMSQ a)
 {
-    memcpy (a->trigsig, a->trigger, a->size * sizeof (complex));
+    if (a->run)
+        memcpy (a->trigsig, a->trigger, a->size * sizeof (complex));
 }
 
 void setBuffers_amsq (AMSQ a, double* in, double* out, double* trigger)
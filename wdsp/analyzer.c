@@ -413,6 +413,19 @@ void detector ( int det_type,           // detector type
             }
             break;
 
+        case 5:     // negative peak
+            for (i = 0; i < num_pixels; i++)
+                pixels[i]   = + 1.0e300;
+
+            for (i = imin; i < ilim; i++)
+            {
+                pix_count = (int)(det_offset + (double)i * pix_per_bin);
+                if (pix_count >= num_pixels) pix_count = num_pixels - 1;
+                if (bins[i] < pixels[pix_count])
+                    pixels[pix_count] = bins[i];
+            }
+            break;
+
         case 4:     // rms
             psum = 0.0;
             bcount = 0;
@@ -460,6 +473,99 @@ void detector ( int det_type,           // detector type
 
 }
 
+// detector types that multi_detector() can produce from one pass over the bins
+int multi_detectable (int det_type)
+{
+    return (det_type == 0) || (det_type == 2) || (det_type == 4) || (det_type == 5);
+}
+
+// Positive peak, average, rms and negative peak detection for several
+// outputs in a single pass over the bins, giving the same pixels as
+// detector() for each of them.  Only for pix_per_bin <= 1.0, where every
+// pixel covers one or more whole bins.
+void multi_detector (   int n_out,              // number of outputs
+                        int* det_type,          // detector type of each output
+                        double** outputs,       // output buffers
+                        int m,                  // number of bins
+                        int num_pixels,         // number of output pixels
+                        double pix_per_bin,     // pixels per bin
+                        double* bins,           // input buffer
+                        double inv_enb,         // inverse equivalent noise bandwidth
+                        double fsclipL,
+                        double fsclipH,
+                        double det_offset
+                        )
+{
+    int i, j, imin, ilim, pix_count;
+    int cur = -1, bcount = 0;
+    double maxi = - 1.0e300, mini = + 1.0e300, psum = 0.0, psqsum = 0.0;
+
+    if (fsclipL == floor(fsclipL)) imin = 0;
+    else  imin = 1;
+    if (fsclipH == floor(fsclipH)) ilim = m;
+    else  ilim = m - 1;
+
+    // the peak detectors leave pixels without bins at their start values
+    for (j = 0; j < n_out; j++)
+    {
+        if (det_type[j] == 0)
+            for (i = 0; i < num_pixels; i++) outputs[j][i] = - 1.0e300;
+        else if (det_type[j] == 5)
+            for (i = 0; i < num_pixels; i++) outputs[j][i] = + 1.0e300;
+    }
+
+    for (i = imin; i <= ilim; i++)
+    {
+        // one step past the last bin flushes the last pixel
+        if (i < ilim)
+        {
+            pix_count = (int)(det_offset + (double)i * pix_per_bin);
+            if (pix_count >= num_pixels) pix_count = num_pixels - 1;
+        }
+        else
+            pix_count = -1;
+        if (pix_count != cur)
+        {
+            if (bcount > 0)
+            {
+                for (j = 0; j < n_out; j++)
+                {
+                    switch (det_type[j])
+                    {
+                    case 0:
+                        outputs[j][cur] = maxi;
+                        break;
+                    case 2:
+                        outputs[j][cur] = psum / (double)bcount * inv_enb;
+                        break;
+                    case 4:
+                        outputs[j][cur] = sqrt (psqsum / (double)bcount) * inv_enb;
+                        break;
+                    case 5:
+                        outputs[j][cur] = mini;
+                        break;
+                    }
+                }
+            }
+            cur = pix_count;
+            bcount = 0;
+            maxi = - 1.0e300;
+            mini = + 1.0e300;
+            psum = 0.0;
+            psqsum = 0.0;
+        }
+        if (i < ilim)
+        {
+            double b = bins[i];
+            if (b > maxi) maxi = b;
+            if (b < mini) mini = b;
+            psum += b;
+            psqsum += b * b;
+            bcount++;
+        }
+    }
+}
+
 void avenger (  int av_mode,                // averaging mode
                 int num_pixels,             // number of pixels
                 int* avail_frames,          // number of available frames for window averaging
@@ -557,6 +663,10 @@ void stitch(int disp)
     DP a = pdisp[disp];
     int i, j, k, n, m;
     double* ptr;
+    int n_multi;
+    int multi[dMAX_PIXOUTS];
+    int multi_type[dMAX_PIXOUTS];
+    double* multi_out[dMAX_PIXOUTS];
 
     // stitch
     m = 0;
@@ -567,6 +677,31 @@ void stitch(int disp)
         ptr += a->ss_bins[n];
         m += a->ss_bins[n];
     }
+    // with several outputs, detect all the types multi_detector() knows in one pass
+    n_multi = 0;
+    if (a->num_pixout > 1 && a->pix_per_bin <= 1.0)
+    {
+        EnterCriticalSection(&a->ResampleSection);
+        for (i = 0; i < a->num_pixout; i++)
+        {
+            multi[i] = 0;
+            if (multi_detectable (a->det_type[i]))
+            {
+                for (j = 0; j < i; j++)
+                    if (a->det_type[i] == a->det_type[j]) break;
+                if (j == i)
+                {
+                    multi[i] = 1;
+                    multi_type[n_multi] = a->det_type[i];
+                    multi_out[n_multi++] = a->t_pixels[i];
+                }
+            }
+        }
+        if (n_multi > 1)
+            multi_detector (n_multi, multi_type, multi_out, m, a->num_pixels, a->pix_per_bin, a->pre_av_out,
+                a->inv_enb, a->fsclipL, a->fsclipH, a->det_offset);
+        LeaveCriticalSection(&a->ResampleSection);
+    }
     for (i = 0; i < a->num_pixout; i++) // for each output
     {
         EnterCriticalSection(&a->ResampleSection);
@@ -579,7 +714,9 @@ void stitch(int disp)
                 k = j;
             j--;
         }
-        if (k == i)
+        if (n_multi > 1 && multi[i])
+            ;   // already detected above
+        else if (k == i)
             // detect
             detector (a->det_type[i], m, a->num_pixels, a->pix_per_bin, a->bin_per_pix, a->pre_av_out,
                 a->t_pixels[i], a->inv_enb, a->fsclipL, a->fsclipH, a->det_offset);
@@ -1311,14 +1448,8 @@ void DestroyAnalyzer(int disp)
     _aligned_free (a);
 }
 
-PORT
-void GetPixels  (   int disp,
-                    int pixout,
-                    dOUTREAL *pix,      //if new pixel values avail, copies to pix and sets flag = 1
-                    int *flag           //else, returns 0 (try again later)
-                )
+static int get_pixels (DP a, int pixout, dOUTREAL *pix)
 {
-    DP a = pdisp[disp];
     EnterCriticalSection(&a->PB_ControlsSection[pixout]);
         a->r_pix_buff[pixout] = a->last_pix_buff[pixout];
     LeaveCriticalSection(&a->PB_ControlsSection[pixout]);
@@ -1326,11 +1457,42 @@ void GetPixels  (   int disp,
     if (_InterlockedAnd(&(a->pb_ready[pixout][a->r_pix_buff[pixout]]), 1))
     {
         memcpy (pix, a->pixels[pixout][a->r_pix_buff[pixout]], a->num_pixels * sizeof(dOUTREAL));
-        *flag = 1;
         InterlockedBitTestAndReset(&(a->pb_ready[pixout][a->r_pix_buff[pixout]]), 0);
+        return 1;
     }
-    else
-        *flag = 0;
+    return 0;
+}
+
+PORT
+void GetPixels  (   int disp,
+                    int pixout,
+                    dOUTREAL *pix,      //if new pixel values avail, copies to pix and sets flag = 1
+                    int *flag           //else, returns 0 (try again later)
+                )
+{
+    *flag = get_pixels (pdisp[disp], pixout, pix);
+}
+
+// The pixels of several displays and outputs in one call, for an
+// application that refreshes all of its displays from a single timer.
+// Request i is display disp[i], output pixout[i], and flag[i] is set as
+// GetPixels() sets it.  Returns the number of requests with new pixels.
+PORT
+int GetPixelsMulti (    int n,              //number of requests
+                        const int *disp,
+                        const int *pixout,
+                        dOUTREAL **pix,     //one destination per request
+                        int *flag
+                    )
+{
+    int i;
+    int ready = 0;
+    for (i = 0; i < n; i++)
+    {
+        flag[i] = get_pixels (pdisp[disp[i]], pixout[i], pix[i]);
+        ready += flag[i];
+    }
+    return ready;
 }
 
 PORT
@@ -429,15 +429,13 @@ void calc (CALCC a)
             a->yc[i] = cval;
             a->ys[i] = sval;
         }
-        xbuilder(a->ccbld, a->tsamps, a->x, a->ym, a->ints, a->t, &(a->binfo[1]), a->cm, a->ptol);
-        xbuilder(a->ccbld, a->tsamps, a->x, a->yc, a->ints, a->t, &(a->binfo[2]), a->cc, a->ptol);
-        xbuilder(a->ccbld, a->tsamps, a->x, a->ys, a->ints, a->t, &(a->binfo[3]), a->cs, a->ptol);
     }
-    else
+
     {
-        xbuilder(a->ccbld, a->nsamps, a->x, a->ym, a->ints, a->t, &(a->binfo[1]), a->cm, a->ptol);
-        xbuilder(a->ccbld, a->nsamps, a->x, a->yc, a->ints, a->t, &(a->binfo[2]), a->cc, a->ptol);
-        xbuilder(a->ccbld, a->nsamps, a->x, a->ys, a->ints, a->t, &(a->binfo[3]), a->cs, a->ptol);
+        // magnitude, cosine and sine curves share 'x'; fit all three from one factorization
+        double* y[3] = { a->ym, a->yc, a->ys };
+        double* c[3] = { a->cm, a->cc, a->cs };
+        xbuilderM(a->ccbld, a->pin ? a->tsamps : a->nsamps, a->x, 3, y, a->ints, a->t, &(a->binfo[1]), c, a->ptol);
     }
 
     if (a->pin) // tune
@@ -482,6 +480,21 @@ cleanup:
     return;
 }
 
+// A capture is the sample set handed to calc(), with the parameters that
+// shape the fit, so PSBenchCapture() can replay it without a radio.
+static void save_capture (CALCC a, char* filename)
+{
+    int i;
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) return;
+    fprintf(file, "%d %d %d %d %.17e %.17e\n", a->ints, a->spi, a->npsamps, a->pin, a->hw_scale, a->ptol);
+    for (i = 0; i < a->nsamps; i++)
+        fprintf(file, "%.17e\t%.17e\t%.17e\t%.17e\n",
+            a->txs[2 * i + 0], a->txs[2 * i + 1], a->rxs[2 * i + 0], a->rxs[2 * i + 1]);
+    fflush(file);
+    fclose(file);
+}
+
 void __cdecl doPSCalcCorrection (void *arg)
 {
     CALCC a = (CALCC)arg;
@@ -490,7 +503,15 @@ void __cdecl doPSCalcCorrection (void *arg)
         WaitForSingleObject(a->Sem_CalcCorr, INFINITE);
         if (!InterlockedAnd(&a->calccorr_bypass, 0xffffffff))
         {
+            long long t0 = prof_now ();
             calc(a);
+            a->calc_last = 1.0e-3 * (double)(prof_now () - t0);
+            if (a->calc_count++ == 0)
+                a->calc_avg = a->calc_last;
+            else
+                a->calc_avg = 0.9 * a->calc_avg + 0.1 * a->calc_last;
+            if (InterlockedBitTestAndReset(&a->util.savecap, 0) & 1)
+                save_capture (a, a->util.capfile);
             if (a->scOK)
             {
                 EnterCriticalSection (&a->ctrl.cs_SafeToEnd);
@@ -857,6 +878,72 @@ void PSSaveCorr (int channel, char* filename)
     LeaveCriticalSection (&txa[channel].calcc.cs_update);
 }
 
+PORT
+void PSSaveCapture (int channel, char* filename)
+{
+    // written by the calc thread after its next fit
+    CALCC a;
+    EnterCriticalSection (&txa[channel].calcc.cs_update);
+    a = txa[channel].calcc.p;
+    strncpy (a->util.capfile, filename, sizeof (a->util.capfile) - 1);
+    InterlockedBitTestAndSet(&a->util.savecap, 0);
+    LeaveCriticalSection (&txa[channel].calcc.cs_update);
+}
+
+PORT
+int PSBenchCapture (char* filename, int iterations, double* min, double* avg)
+{
+    // replays a saved capture through calc(); times in microseconds
+    // returns -1 if the capture can't be read, else whether the last fit was good
+    int i, ok;
+    long long t0;
+    double t;
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) return -1;
+    CALCC a = (CALCC) malloc0 (sizeof (calcc));
+    if (fscanf(file, "%d %d %d %d %le %le", &a->ints, &a->spi, &a->npsamps, &a->pin, &a->hw_scale, &a->ptol) != 6
+        || a->ints < 1 || a->spi < 1 || a->npsamps < 0)
+    {
+        fclose(file);
+        _aligned_free (a);
+        return -1;
+    }
+    a->util.ints = a->ints;
+    a->info  = (int *) malloc0 (16 * sizeof (int));
+    a->binfo = (int *) malloc0 (16 * sizeof (int));
+    size_calcc (a);
+    InitializeCriticalSectionAndSpinCount (&a->disp.cs_disp, 2500);
+    ok = 1;
+    for (i = 0; i < a->nsamps && ok; i++)
+        ok = fscanf(file, "%le %le %le %le",
+            &a->txs[2 * i + 0], &a->txs[2 * i + 1], &a->rxs[2 * i + 0], &a->rxs[2 * i + 1]) == 4;
+    fclose(file);
+    if (ok)
+    {
+        // ctrl.running stays clear, so every pass fits the capture from scratch
+        *min = 0.0;
+        *avg = 0.0;
+        for (i = 0; i < iterations; i++)
+        {
+            t0 = prof_now ();
+            calc (a);
+            t = 1.0e-3 * (double)(prof_now () - t0);
+            if (i == 0 || t < *min) *min = t;
+            *avg += t;
+        }
+        if (iterations > 0) *avg /= iterations;
+        ok = a->scOK;
+    }
+    else
+        ok = -1;
+    DeleteCriticalSection (&a->disp.cs_disp);
+    desize_calcc (a);
+    _aligned_free (a->binfo);
+    _aligned_free (a->info);
+    _aligned_free (a);
+    return ok;
+}
+
 PORT
 void PSRestoreCorr (int channel, char* filename)
 {
@@ -909,6 +996,19 @@ void GetPSInfo (int channel, int *info)
     LeaveCriticalSection (&txa[channel].calcc.cs_update);
 }
 
+PORT
+void GetPSCalcTime (int channel, double* last, double* avg, int* count)
+{
+    // times in microseconds
+    CALCC a;
+    EnterCriticalSection (&txa[channel].calcc.cs_update);
+    a = txa[channel].calcc.p;
+    *last = a->calc_last;
+    *avg = a->calc_avg;
+    *count = a->calc_count;
+    LeaveCriticalSection (&txa[channel].calcc.cs_update);
+}
+
 PORT
 void SetPSReset (int channel, int reset)
 {
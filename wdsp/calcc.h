@@ -71,6 +71,9 @@ typedef struct _calcc
     int* binfo;
     double txdel;
     BLDR ccbld;
+    double calc_last;
+    double calc_avg;
+    int calc_count;
     volatile long savecorr_bypass;
     HANDLE Sem_SaveCorr;
     volatile long restcorr_bypass;
@@ -122,6 +125,8 @@ typedef struct _calcc
     {
         char savefile[256];
         char restfile[256];
+        char capfile[256];
+        volatile long savecap;
         int ints;
         int channel;
         double* pm;
@@ -150,6 +155,10 @@ extern void __cdecl doPSCalcCorrection(void* arg);
 
 extern void __cdecl doPSTurnoff(void* arg);
 
+extern __declspec(dllexport) void PSSaveCapture (int channel, char* filename);
+
+extern __declspec(dllexport) int PSBenchCapture (char* filename, int iterations, double* min, double* avg);
+
 #endif
 
 // 'info' assignments:
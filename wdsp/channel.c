@@ -115,6 +115,7 @@ void pre_main_destroy (int channel)
 void post_main_destroy (int channel)
 {
     destroy_iobuffs (channel);
+    destroy_prof (channel);
     DeleteCriticalSection ( &ch[channel].csEXCH  );
     DeleteCriticalSection ( &ch[channel].csDSP );
 }
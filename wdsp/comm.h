@@ -95,6 +95,7 @@ warren@wpratt.com
 #include "nobII.h"
 #include "osctrl.h"
 #include "patchpanel.h"
+#include "profile.h"
 #include "resample.h"
 #include "rmatch.h"
 #include "RXA.h"
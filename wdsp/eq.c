@@ -203,7 +203,7 @@ void xeqp (EQP a)
 {
     if (a->run)
         xfircore (a->p);
-    else
+    else if (a->in != a->out)
         memcpy (a->out, a->in, a->size * sizeof (complex));
 }
 
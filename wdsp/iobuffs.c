@@ -467,10 +467,17 @@ void fexchange0 (int channel, double* in, double* out, int* error)
     int n;
     int doit = 0;
     IOB a;
+    PROF p = 0;
+    long long t0 = 0, t1 = 0, t2 = 0;
     *error = 0;
     if (_InterlockedAnd (&ch[channel].exchange, 1))
     {
         EnterCriticalSection (&ch[channel].csEXCH);
+        if (pprof[channel] != 0 && pprof[channel]->run)
+        {
+            p = pprof[channel];
+            t0 = prof_now ();
+        }
         a = ch[channel].iob.pe;
         if (_InterlockedAnd (&a->slew.upflag, 1))
             upslew0 (a, in);
@@ -491,7 +498,9 @@ void fexchange0 (int channel, double* in, double* out, int* error)
             doit = 1;
         if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
         LeaveCriticalSection (&a->r2_ControlSection);
+        if (p) t1 = prof_now ();
         if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
+        if (p) t2 = prof_now ();
         if (a->bfo || doit)
             if (_InterlockedAnd (&a->slew.downflag, 1))
             {
@@ -511,6 +520,7 @@ void fexchange0 (int channel, double* in, double* out, int* error)
         }
         if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
             a->r2_outidx = 0;
+        if (p) exch_prof (p, (t1 - t0) + (prof_now () - t2), t2 - t1);
         LeaveCriticalSection (&ch[channel].csEXCH);
     }
 }
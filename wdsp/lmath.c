@@ -189,7 +189,6 @@ BLDR create_builder(int points, int ints)
     BLDR a = (BLDR)malloc0 (sizeof(bldr));
     a->catxy = (double*)malloc0(2 * points * sizeof(double));
     a->sx    = (double*)malloc0(    points * sizeof(double));
-    a->sy    = (double*)malloc0(    points * sizeof(double));
     a->h     = (double*)malloc0(    ints   * sizeof(double));
     a->p     = (int*)   malloc0(    ints   * sizeof(int));
     a->np    = (int*)   malloc0(    ints   * sizeof(int));
@@ -209,10 +208,10 @@ BLDR create_builder(int points, int ints)
     a->A     = (double*)malloc0(intp1 * intp1 * sizeof(double));
     a->B     = (double*)malloc0(intp1 * intp1 * sizeof(double));
     a->C     = (double*)malloc0(intm1 * intp1 * sizeof(double));
-    a->D     = (double*)malloc0(intp1         * sizeof(double));
+    a->D     = (double*)malloc0(BLDR_MAXRHS * intp1 * sizeof(double));
     a->E     = (double*)malloc0(intp1 * intp1 * sizeof(double));
     a->F     = (double*)malloc0(intm1 * intp1 * sizeof(double));
-    a->G     = (double*)malloc0(intp1         * sizeof(double));
+    a->G     = (double*)malloc0(BLDR_MAXRHS * intp1 * sizeof(double));
     a->MAT   = (double*)malloc0(nsize * nsize * sizeof(double));
     a->RHS   = (double*)malloc0(nsize         * sizeof(double));
     a->SLN   = (double*)malloc0(nsize         * sizeof(double));
@@ -229,7 +228,6 @@ void destroy_builder(BLDR a)
     _aligned_free(a->wrk);
     _aligned_free(a->catxy);
     _aligned_free(a->sx);
-    _aligned_free(a->sy);
     _aligned_free(a->h);
     _aligned_free(a->p);
     _aligned_free(a->np);
@@ -267,7 +265,6 @@ void flush_builder(BLDR a, int points, int ints)
 {
     memset(a->catxy, 0, 2 * points * sizeof(double));
     memset(a->sx,    0, points * sizeof(double));
-    memset(a->sy,    0, points * sizeof(double));
     memset(a->h,     0, ints * sizeof(double));
     memset(a->p,     0, ints * sizeof(int));
     memset(a->np,    0, ints * sizeof(int));
@@ -287,10 +284,10 @@ void flush_builder(BLDR a, int points, int ints)
     memset(a->A,     0, intp1 * intp1 * sizeof(double));
     memset(a->B,     0, intp1 * intp1 * sizeof(double));
     memset(a->C,     0, intm1 * intp1 * sizeof(double));
-    memset(a->D,     0, intp1         * sizeof(double));
+    memset(a->D,     0, BLDR_MAXRHS * intp1 * sizeof(double));
     memset(a->E,     0, intp1 * intp1 * sizeof(double));
     memset(a->F,     0, intm1 * intp1 * sizeof(double));
-    memset(a->G,     0, intp1         * sizeof(double));
+    memset(a->G,     0, BLDR_MAXRHS * intp1 * sizeof(double));
     memset(a->MAT,   0, nsize * nsize * sizeof(double));
     memset(a->RHS,   0, nsize * sizeof(double));
     memset(a->SLN,   0, nsize * sizeof(double));
@@ -356,11 +353,16 @@ void decomp(int n, double* a, int* piv, int* info, double* wrk)
         t_piv = piv[k];
         piv[k] = piv[j];
         piv[j] = t_piv;
-        for (i = k + 1; i < n; i++)
         {
-            a[n * piv[i] + k] /= a[n * piv[k] + k];
-            for (j = k + 1; j < n; j++)
-                a[n * piv[i] + j] -= a[n * piv[i] + k] * a[n * piv[k] + j];
+            // rows are distinct, so the inner update vectorizes
+            double* restrict rk = a + n * piv[k];
+            for (i = k + 1; i < n; i++)
+            {
+                double* restrict ri = a + n * piv[i];
+                double m = (ri[k] /= rk[k]);
+                for (j = k + 1; j < n; j++)
+                    ri[j] -= m * rk[j];
+            }
         }
     }
     if (a[n * n - 1] == 0.0)
@@ -376,18 +378,20 @@ void dsolve(int n, double* a, int* piv, double* b, double* x)
 
     for (k = 0; k < n; k++)
     {
+        const double* rk = a + n * piv[k];
         sum = 0.0;
         for (j = 0; j < k; j++)
-            sum += a[n * piv[k] + j] * x[j];
+            sum += rk[j] * x[j];
         x[k] = b[piv[k]] - sum;
     }
 
     for (k = n - 1; k >= 0; k--)
     {
+        const double* rk = a + n * piv[k];
         sum = 0.0;
         for (j = k + 1; j < n; j++)
-            sum += a[n * piv[k] + j] * x[j];
-        x[k] = (x[k] - sum) / a[n * piv[k] + k];
+            sum += rk[j] * x[j];
+        x[k] = (x[k] - sum) / rk[k];
     }
 }
 
@@ -410,31 +414,42 @@ void cull(int* n, int ints, double* x, double* t, double ptol)
 
 void xbuilder(BLDR a, int points, double* x, double* y, int ints, double* t, int* info, double* c, double ptol)
 {
-    double u, v, alpha, beta, gamma, delta;
+    xbuilderM(a, points, x, 1, &y, ints, t, info, &c, ptol);
+}
+
+void xbuilderM(BLDR a, int points, double* x, int ny, double** y, int ints, double* t, int* info, double** c, double ptol)
+{
+    // Fits 'ny' (<= BLDR_MAXRHS) data sets that share the abscissae 'x'.  The sort, the basis sums,
+    // and the LU decomposition depend only on 'x' and 't', so they are done once; each data set
+    // then costs one pass to accumulate its right-hand side plus one back-substitution.
+    double u, v, alpha, beta, gamma, delta, sy;
     int nsize = 3 * ints + 1;
     int intp1 = ints + 1;
     int intm1 = ints - 1;
-    int i, j, k, m;
+    int i, j, k, m, n;
     int dinfo;
+    double* D;
+    double* G;
     flush_builder(a, points, ints);
+    // sort (x, index) pairs so every data set can be read in x order
     for (i = 0; i < points; i++)
     {
         a->catxy[2 * i + 0] = x[i];
-        a->catxy[2 * i + 1] = y[i];
+        a->catxy[2 * i + 1] = (double)i;
     }
     qsort(a->catxy, points, 2 * sizeof(double), fcompare);
     for (i = 0; i < points; i++)
-    {
         a->sx[i] = a->catxy[2 * i + 0];
-        a->sy[i] = a->catxy[2 * i + 1];
-    }
     cull(&points, ints, a->sx, t, ptol);
     if (points <= 0 || a->sx[points - 1] > t[ints])
     {
-        *info = -1000;
+        for (n = 0; n < ny; n++)
+            info[n] = -1000;
         goto cleanup;
     }
-    else *info = 0;
+    else
+        for (n = 0; n < ny; n++)
+            info[n] = 0;
 
     for (j = 0; j < ints; j++)
         a->h[j] = t[j + 1] - t[j];
@@ -471,10 +486,17 @@ void xbuilder(BLDR a, int points, double* x, double* y, int ints, double* t, int
             a->tgg[i] += gamma * gamma;
             a->tgd[i] += gamma * delta;
             a->tdd[i] += delta * delta;
-            a->D[i + 0] += 2.0 * a->sy[j] * alpha;
-            a->D[i + 1] += 2.0 * a->sy[j] * beta;
-            a->G[i + 0] += 2.0 * a->sy[j] * gamma;
-            a->G[i + 1] += 2.0 * a->sy[j] * delta;
+            m = (int)a->catxy[2 * j + 1];
+            for (n = 0; n < ny; n++)
+            {
+                D = a->D + n * intp1;
+                G = a->G + n * intp1;
+                sy = 2.0 * y[n][m];
+                D[i + 0] += sy * alpha;
+                D[i + 1] += sy * beta;
+                G[i + 0] += sy * gamma;
+                G[i + 1] += sy * delta;
+            }
         }
     for (i = 0; i < ints; i++)
     {
@@ -508,7 +530,6 @@ void xbuilder(BLDR a, int points, double* x, double* y, int ints, double* t, int
             a->MAT[k * nsize + m] = a->B[j * intp1 + i];
         for (j = 0, m = 2 * intp1; j < intm1; j++, m++)
             a->MAT[k * nsize + m] = a->C[j * intp1 + i];
-        a->RHS[k] = a->D[i];
     }
     for (i = 0, k = intp1; i < intp1; i++, k++)
     {
@@ -518,7 +539,6 @@ void xbuilder(BLDR a, int points, double* x, double* y, int ints, double* t, int
             a->MAT[k * nsize + m] = a->E[i * intp1 + j];
         for (j = 0, m = 2 * intp1; j < intm1; j++, m++)
             a->MAT[k * nsize + m] = a->F[j * intp1 + i];
-        a->RHS[k] = a->G[i];
     }
     for (i = 0, k = 2 * intp1; i < intm1; i++, k++)
     {
@@ -528,27 +548,38 @@ void xbuilder(BLDR a, int points, double* x, double* y, int ints, double* t, int
             a->MAT[k * nsize + m] = a->F[i * intp1 + j];
         for (j = 0, m = 2 * intp1; j < intm1; j++, m++)
             a->MAT[k * nsize + m] = 0.0;
-        a->RHS[k] = 0.0;
     }
     decomp(nsize, a->MAT, a->ipiv, &dinfo, a->wrk);
-    dsolve(nsize, a->MAT, a->ipiv, a->RHS, a->SLN);
     if (dinfo != 0)
     {
-        *info = dinfo;
+        for (n = 0; n < ny; n++)
+            info[n] = dinfo;
         goto cleanup;
     }
 
-    for (i = 0; i <= ints; i++)
-    {
-        a->z[i] = a->SLN[i];
-        a->zp[i] = a->SLN[i + ints + 1];
-    }
-    for (i = 0; i < ints; i++)
+    for (n = 0; n < ny; n++)
     {
-        c[4 * i + 0] = a->z[i];
-        c[4 * i + 1] = a->zp[i];
-        c[4 * i + 2] = -3.0 / (a->h[i] * a->h[i]) * (a->z[i] - a->z[i + 1]) - 1.0 / a->h[i] * (2.0 * a->zp[i] + a->zp[i + 1]);
-        c[4 * i + 3] = 2.0 / (a->h[i] * a->h[i] * a->h[i]) * (a->z[i] - a->z[i + 1]) + 1.0 / (a->h[i] * a->h[i]) * (a->zp[i] + a->zp[i + 1]);
+        D = a->D + n * intp1;
+        G = a->G + n * intp1;
+        for (i = 0, k = 0; i < intp1; i++, k++)
+            a->RHS[k] = D[i];
+        for (i = 0, k = intp1; i < intp1; i++, k++)
+            a->RHS[k] = G[i];
+        for (i = 0, k = 2 * intp1; i < intm1; i++, k++)
+            a->RHS[k] = 0.0;
+        dsolve(nsize, a->MAT, a->ipiv, a->RHS, a->SLN);
+        for (i = 0; i <= ints; i++)
+        {
+            a->z[i] = a->SLN[i];
+            a->zp[i] = a->SLN[i + ints + 1];
+        }
+        for (i = 0; i < ints; i++)
+        {
+            c[n][4 * i + 0] = a->z[i];
+            c[n][4 * i + 1] = a->zp[i];
+            c[n][4 * i + 2] = -3.0 / (a->h[i] * a->h[i]) * (a->z[i] - a->z[i + 1]) - 1.0 / a->h[i] * (2.0 * a->zp[i] + a->zp[i + 1]);
+            c[n][4 * i + 3] = 2.0 / (a->h[i] * a->h[i] * a->h[i]) * (a->z[i] - a->z[i + 1]) + 1.0 / (a->h[i] * a->h[i]) * (a->zp[i] + a->zp[i + 1]);
+        }
     }
 cleanup:
     return;
@@ -42,11 +42,12 @@ extern void median(int n, double* a, double* med);
 #ifndef _bldr_h
 #define _bldr_h
 
+#define BLDR_MAXRHS 3                   // maximum number of data sets per xbuilderM() call
+
 typedef struct _bldr
 {
     double* catxy;
     double* sx;
-    double* sy;
     double* h;
     int* p;
     int* np;
@@ -84,6 +85,8 @@ extern void flush_builder(BLDR a, int points, int ints);
 
 extern void xbuilder(BLDR a, int points, double* x, double* y, int ints, double* t, int* info, double* c, double ptol);
 
+extern void xbuilderM(BLDR a, int points, double* x, int ny, double** y, int ints, double* t, int* info, double** c, double ptol);
+
 extern int fcompare(const void* a, const void* b);
 
 extern void decomp(int n, double* a, int* piv, int* info, double* wrk);
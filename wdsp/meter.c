@@ -28,12 +28,27 @@ warren@wpratt.com
 
 void calc_meter (METER a)
 {
+    int i;
     a->mult_average = exp(-1.0 / (a->rate * a->tau_average));
     a->mult_peak = exp(-1.0 / (a->rate * a->tau_peak_decay));
+    // The per-sample recursions avg = avg * m + (1 - m) * smag and peak *= mp, applied over a
+    // block of 'size' samples, collapse to one scale of the old value plus a weighted sum.
+    a->mult_average_block = pow(a->mult_average, (double)a->size);
+    a->mult_peak_block = pow(a->mult_peak, (double)a->size);
+    a->weight = (double *) malloc0 (a->size * sizeof (double));
+    for (i = 0; i < a->size; i++)
+        a->weight[i] = (1.0 - a->mult_average) * pow(a->mult_average, (double)(a->size - 1 - i));
+    // stop metering after about one second without a read
+    a->idle_max = (int)(a->rate / (double)a->size) + 1;
     flush_meter(a);
 }
 
-METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, double* result, CRITICAL_SECTION** pmtupdate, int enum_av, int enum_pk, int enum_gain, double* pgain)
+void decalc_meter (METER a)
+{
+    _aligned_free (a->weight);
+}
+
+METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, METER* pmeter, int enum_av, int enum_pk, int enum_gain, double* pgain)
 {
     METER a = (METER) malloc0 (sizeof (meter));
     a->run = run;
@@ -43,22 +58,20 @@ METER create_meter (int run, int* prun, int size, double* buff, int rate, double
     a->rate = (double)rate;
     a->tau_average = tau_av;
     a->tau_peak_decay = tau_decay;
-    a->result = result;
     a->enum_av = enum_av;
     a->enum_pk = enum_pk;
     a->enum_gain = enum_gain;
     a->pgain = pgain;
     calc_meter(a);
-    InitializeCriticalSectionAndSpinCount (&a->mtupdate, 2500);
-    pmtupdate[enum_av]   = &a->mtupdate;
-    pmtupdate[enum_pk]   = &a->mtupdate;
-    pmtupdate[enum_gain] = &a->mtupdate;
+    if (enum_av   >= 0) pmeter[enum_av]   = a;
+    if (enum_pk   >= 0) pmeter[enum_pk]   = a;
+    if (enum_gain >= 0) pmeter[enum_gain] = a;
     return a;
 }
 
 void destroy_meter (METER a)
 {
-    DeleteCriticalSection (&a->mtupdate);
+    decalc_meter (a);
     _aligned_free (a);
 }
 
@@ -66,16 +79,13 @@ void flush_meter (METER a)
 {
     a->avg  = 0.0;
     a->peak = 0.0;
-    a->result[a->enum_av] = -400.0;
-    a->result[a->enum_pk] = -400.0;
-    if ((a->pgain != 0) && (a->enum_gain >= 0))
-        a->result[a->enum_gain] = -400.0;
+    a->active = 0;
+    a->skipped = 1;
 }
 
 void xmeter (METER a)
 {
     int srun;
-    EnterCriticalSection (&a->mtupdate);
     if (a->prun != 0)
         srun = *(a->prun);
     else
@@ -83,28 +93,80 @@ void xmeter (METER a)
     if (a->run && srun)
     {
         int i;
-        double smag;
-        double np = 0.0;
-        for (i = 0; i < a->size; i++)
+        double smag, np;
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        double p0 = 0.0, p1 = 0.0, p2 = 0.0, p3 = 0.0;
+        double* w = a->weight;
+        double* b = a->buff;
+        if (a->idle >= a->idle_max)
+        {
+            // nobody is reading this meter
+            a->skipped = 1;
+            return;
+        }
+        a->idle++;
+        // four independent accumulators so the loop pipelines / vectorizes
+        for (i = 0; i + 3 < a->size; i += 4)
+        {
+            double m0 = b[2 * i + 0] * b[2 * i + 0] + b[2 * i + 1] * b[2 * i + 1];
+            double m1 = b[2 * i + 2] * b[2 * i + 2] + b[2 * i + 3] * b[2 * i + 3];
+            double m2 = b[2 * i + 4] * b[2 * i + 4] + b[2 * i + 5] * b[2 * i + 5];
+            double m3 = b[2 * i + 6] * b[2 * i + 6] + b[2 * i + 7] * b[2 * i + 7];
+            s0 += w[i + 0] * m0;
+            s1 += w[i + 1] * m1;
+            s2 += w[i + 2] * m2;
+            s3 += w[i + 3] * m3;
+            if (m0 > p0) p0 = m0;
+            if (m1 > p1) p1 = m1;
+            if (m2 > p2) p2 = m2;
+            if (m3 > p3) p3 = m3;
+        }
+        for (; i < a->size; i++)
+        {
+            smag = b[2 * i + 0] * b[2 * i + 0] + b[2 * i + 1] * b[2 * i + 1];
+            s0 += w[i] * smag;
+            if (smag > p0) p0 = smag;
+        }
+        np = p0;
+        if (p1 > np) np = p1;
+        if (p2 > np) np = p2;
+        if (p3 > np) np = p3;
+        if (a->skipped)
         {
-            smag = a->buff[2 * i + 0] * a->buff[2 * i + 0] + a->buff[2 * i + 1] * a->buff[2 * i + 1];
-            a->avg = a->avg * a->mult_average + (1.0 - a->mult_average) * smag;
-            a->peak *= a->mult_peak;
-            if (smag > np) np = smag;
+            // resuming after a gap; start from this block rather than from stale history
+            a->avg = (s0 + s1 + s2 + s3) / (1.0 - a->mult_average_block);
+            a->peak = np;
+            a->skipped = 0;
         }
-        if (np > a->peak) a->peak = np;
-        a->result[a->enum_av] = 10.0 * mlog10 (a->avg + 1.0e-40);
-        a->result[a->enum_pk] = 10.0 * mlog10 (a->peak + 1.0e-40);
-        if ((a->pgain != 0) && (a->enum_gain >= 0))
-            a->result[a->enum_gain] = 20.0 * mlog10 (*a->pgain + 1.0e-40);
+        else
+        {
+            a->avg = a->avg * a->mult_average_block + (s0 + s1 + s2 + s3);
+            a->peak *= a->mult_peak_block;
+            if (np > a->peak) a->peak = np;
+        }
+        a->active = 1;
     }
     else
-    {
-        if (a->enum_av   >= 0) a->result[a->enum_av]   = - 400.0;
-        if (a->enum_pk   >= 0) a->result[a->enum_pk]   = - 400.0;
-        if (a->enum_gain >= 0) a->result[a->enum_gain] = +   0.0;
-    }
-    LeaveCriticalSection (&a->mtupdate);
+        a->active = 0;
+}
+
+double read_meter (METER a, int mt)
+{
+    // called from the UI thread; converts to dB here instead of on every block
+    double val;
+    if (a == 0) return -400.0;
+    a->idle = 0;
+    if (!a->active)
+        return (mt == a->enum_gain) ? 0.0 : -400.0;
+    if (mt == a->enum_av)
+        val = 10.0 * mlog10 (a->avg + 1.0e-40);
+    else if (mt == a->enum_pk)
+        val = 10.0 * mlog10 (a->peak + 1.0e-40);
+    else if (a->pgain != 0)
+        val = 20.0 * mlog10 (*a->pgain + 1.0e-40);
+    else
+        val = 0.0;
+    return val;
 }
 
 void setBuffers_meter (METER a, double* in)
@@ -114,14 +176,16 @@ void setBuffers_meter (METER a, double* in)
 
 void setSamplerate_meter (METER a, int rate)
 {
+    decalc_meter(a);
     a->rate = rate;
     calc_meter(a);
 }
 
 void setSize_meter (METER a, int size)
 {
+    decalc_meter(a);
     a->size = size;
-    flush_meter (a);
+    calc_meter(a);
 }
 
 /********************************************************************************************************
@@ -133,12 +197,7 @@ void setSize_meter (METER a, int size)
 PORT
 double GetRXAMeter (int channel, int mt)
 {
-    double val;
-    CRITICAL_SECTION* a = rxa[channel].pmtupdate[mt];
-    EnterCriticalSection (a);
-    val = rxa[channel].meter[mt];
-    LeaveCriticalSection (a);
-    return val;
+    return read_meter (rxa[channel].pmeter[mt], mt);
 }
 
 /********************************************************************************************************
@@ -150,10 +209,5 @@ double GetRXAMeter (int channel, int mt)
 PORT
 double GetTXAMeter (int channel, int mt)
 {
-    double val;
-    CRITICAL_SECTION* a = txa[channel].pmtupdate[mt];
-    EnterCriticalSection (a);
-    val = txa[channel].meter[mt];
-    LeaveCriticalSection (a);
-    return val;
+    return read_meter (txa[channel].pmeter[mt], mt);
 }
@@ -38,17 +38,22 @@ typedef struct _meter
     double tau_peak_decay;
     double mult_average;
     double mult_peak;
-    double* result;
+    double mult_average_block;
+    double mult_peak_block;
+    double* weight;
     int enum_av;
     int enum_pk;
     int enum_gain;
     double* pgain;
-    double avg;
-    double peak;
-    CRITICAL_SECTION mtupdate;
+    volatile double avg;            // linear power, written once per block, read lock-free
+    volatile double peak;
+    volatile long active;
+    volatile long idle;             // blocks since the last read; reset by read_meter()
+    int idle_max;
+    int skipped;
 } meter, *METER;
 
-extern METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, double* result, CRITICAL_SECTION** pmtupdate, int enum_av, int enum_pk, int enum_gain, double* pgain);
+extern METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, METER* pmeter, int enum_av, int enum_pk, int enum_gain, double* pgain);
 
 extern void destroy_meter (METER a);
 
@@ -56,6 +61,8 @@ extern void flush_meter (METER a);
 
 extern void xmeter (METER a);
 
+extern double read_meter (METER a, int mt);
+
 extern void setBuffers_meter (METER a, double* in);
 
 extern void setSamplerate_meter (METER a, int rate);
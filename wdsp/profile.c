@@ -0,0 +1,183 @@
+/*  profile.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2025
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include "comm.h"
+
+PROF pprof[MAX_CHANNELS];
+
+long long prof_now (void)
+{
+#if defined(linux) || defined(__APPLE__)
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + (long long)ts.tv_nsec;
+#else
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency (&freq);
+    QueryPerformanceCounter (&count);
+    return (long long)((double)count.QuadPart * 1.0e9 / (double)freq.QuadPart);
+#endif
+}
+
+PROF create_prof (void)
+{
+    PROF a = (PROF) malloc0 (sizeof (prof));
+    a->stage[PROF_EXCH_COPY].name = "fexchange copy";
+    a->stage[PROF_EXCH_WAIT].name = "fexchange wait";
+    a->stage[PROF_TOTAL].name     = "dsp total";
+    a->nstages = PROF_FIRST;
+    InitializeCriticalSectionAndSpinCount (&a->update, 2500);
+    return a;
+}
+
+void destroy_prof (int channel)
+{
+    PROF a = pprof[channel];
+    if (a == 0) return;
+    pprof[channel] = 0;
+    DeleteCriticalSection (&a->update);
+    _aligned_free (a);
+}
+
+static void push_prof (profstage* s, double us)
+{
+    s->samps[s->idx] = us;
+    if (++s->idx == PROF_NSAMPS) s->idx = 0;
+    if (s->count < PROF_NSAMPS) s->count++;
+}
+
+void mark_prof (PROF a, const char* name)
+{
+    long long t = prof_now ();
+    if (a->mark < PROF_MAX_STAGES - PROF_FIRST)
+    {
+        a->curname[a->mark] = name;
+        a->cur[a->mark++] = 1.0e-3 * (double)(t - a->tmark);
+    }
+    a->tmark = t;
+}
+
+void end_prof (PROF a)
+{
+    int i;
+    double total = 1.0e-3 * (double)(a->tmark - a->tbegin);
+    EnterCriticalSection (&a->update);
+    for (i = 0; i < a->mark; i++)
+    {
+        profstage* s = &a->stage[PROF_FIRST + i];
+        if (s->name != a->curname[i])
+        {
+            // stage list changed (e.g. channel type); restart this slot
+            s->name = a->curname[i];
+            s->idx = s->count = 0;
+        }
+        push_prof (s, a->cur[i]);
+    }
+    push_prof (&a->stage[PROF_TOTAL], total);
+    a->nstages = PROF_FIRST + a->mark;
+    LeaveCriticalSection (&a->update);
+}
+
+void exch_prof (PROF a, long long tcopy, long long twait)
+{
+    EnterCriticalSection (&a->update);
+    push_prof (&a->stage[PROF_EXCH_COPY], 1.0e-3 * (double)tcopy);
+    push_prof (&a->stage[PROF_EXCH_WAIT], 1.0e-3 * (double)twait);
+    LeaveCriticalSection (&a->update);
+}
+
+static int cmp_prof (const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/********************************************************************************************************
+*                                                                                                       *
+*                                           Channel Properties                                          *
+*                                                                                                       *
+********************************************************************************************************/
+
+PORT
+void SetChannelProfileRun (int channel, int run)
+{
+    EnterCriticalSection (&ch[channel].csDSP);
+    EnterCriticalSection (&ch[channel].csEXCH);
+    if (run && pprof[channel] == 0)
+        pprof[channel] = create_prof ();
+    if (pprof[channel] != 0)
+        pprof[channel]->run = run;
+    LeaveCriticalSection (&ch[channel].csEXCH);
+    LeaveCriticalSection (&ch[channel].csDSP);
+}
+
+PORT
+void ResetChannelProfile (int channel)
+{
+    int i;
+    PROF a = pprof[channel];
+    if (a == 0) return;
+    EnterCriticalSection (&a->update);
+    for (i = 0; i < PROF_MAX_STAGES; i++)
+        a->stage[i].idx = a->stage[i].count = 0;
+    LeaveCriticalSection (&a->update);
+}
+
+PORT
+int GetChannelProfileStages (int channel)
+{
+    PROF a = pprof[channel];
+    if (a == 0) return 0;
+    return a->nstages;
+}
+
+PORT
+int GetChannelProfileStage (int channel, int stage, char* name, int size, double* min, double* avg, double* p99)
+{
+    // returns the number of blocks in the window; times are in microseconds
+    int i, n;
+    double sum;
+    double samps[PROF_NSAMPS];
+    PROF a = pprof[channel];
+    if (a == 0 || stage < 0 || stage >= a->nstages) return 0;
+    EnterCriticalSection (&a->update);
+    n = a->stage[stage].count;
+    memcpy (samps, a->stage[stage].samps, n * sizeof (double));
+    if (name != 0 && size > 0)
+    {
+        strncpy (name, a->stage[stage].name ? a->stage[stage].name : "", size - 1);
+        name[size - 1] = 0;
+    }
+    LeaveCriticalSection (&a->update);
+    *min = *avg = *p99 = 0.0;
+    if (n == 0) return 0;
+    qsort (samps, n, sizeof (double), cmp_prof);
+    for (i = 0, sum = 0.0; i < n; i++)
+        sum += samps[i];
+    *min = samps[0];
+    *avg = sum / (double)n;
+    *p99 = samps[(99 * (n - 1)) / 100];
+    return n;
+}
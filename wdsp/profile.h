@@ -0,0 +1,95 @@
+/*  profile.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2025
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+// 'profile' times each stage of a channel's xrxa()/xtxa() chain, plus the copy and wait time
+//  spent in fexchange0(), and keeps a rolling window of the results for min/avg/p99 queries.
+//  It is OFF by default; when OFF the only cost per stage is a test of a NULL pointer.
+
+#ifndef _profile_h
+#define _profile_h
+
+#define PROF_MAX_STAGES                 48                  // maximum number of timed stages per channel
+#define PROF_NSAMPS                     256                 // number of blocks in the rolling window
+#define PROF_EXCH_COPY                  0                   // stage index for fexchange0() copy time
+#define PROF_EXCH_WAIT                  1                   // stage index for fexchange0() wait time
+#define PROF_TOTAL                      2                   // stage index for the whole xrxa()/xtxa() call
+#define PROF_FIRST                      3                   // index of the first dsp stage
+
+typedef struct _profstage
+{
+    const char* name;
+    int idx;
+    int count;
+    double samps[PROF_NSAMPS];                              // microseconds
+} profstage;
+
+typedef struct _prof
+{
+    volatile long run;
+    int nstages;
+    int mark;
+    long long tbegin;
+    long long tmark;
+    const char* curname[PROF_MAX_STAGES];
+    double cur[PROF_MAX_STAGES];
+    profstage stage[PROF_MAX_STAGES];
+    CRITICAL_SECTION update;
+} prof, *PROF;
+
+extern PROF pprof[];
+
+extern long long prof_now (void);
+
+extern void destroy_prof (int channel);
+
+extern void mark_prof (PROF a, const char* name);
+
+extern void end_prof (PROF a);
+
+extern void exch_prof (PROF a, long long tcopy, long long twait);
+
+static __inline PROF begin_prof (int channel)
+{
+    PROF a = pprof[channel];
+    if (a == 0 || !a->run)
+        return 0;
+    a->mark = 0;
+    a->tbegin = a->tmark = prof_now ();
+    return a;
+}
+
+#define PROF_MARK(a, name)  do { if (a) mark_prof (a, name); } while (0)
+
+#define PROF_END(a)         do { if (a) end_prof (a); } while (0)
+
+// Channel Properties
+
+extern __declspec (dllexport) void SetChannelProfileRun (int channel, int run);
+
+extern __declspec (dllexport) void ResetChannelProfile (int channel);
+
+extern __declspec (dllexport) int GetChannelProfileStages (int channel);
+
+extern __declspec (dllexport) int GetChannelProfileStage (int channel, int stage, char* name, int size,
+    double* min, double* avg, double* p99);
+
+#endif
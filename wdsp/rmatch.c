@@ -148,8 +148,7 @@ void calc_rmatch (RMATCH a)
     a->inv_nom_ratio = (double)a->nom_inrate / (double)a->nom_outrate;
     a->feed_forward = 1.0;
     a->av_deviation = 0.0;
-    InitializeCriticalSectionAndSpinCount (&a->cs_ring, 2500);
-    InitializeCriticalSectionAndSpinCount (&a->cs_var,  2500);
+    a->inbound = 0;
     a->ntslew = (int)(a->tslew * a->nom_outrate);
     if (a->ntslew + 1 > a->rsize / 2) a->ntslew = a->rsize / 2 - 1;
     a->cslew = (double *) malloc0 ((a->ntslew + 1) * sizeof (double));
@@ -160,7 +159,8 @@ void calc_rmatch (RMATCH a)
         a->cslew[m] = 0.5 * (1.0 - cos (theta));
         theta += dtheta;
     }
-    a->baux = (double *) malloc0 (a->ringsize / 2 * sizeof (complex));
+    a->ucnt = -1;
+    a->ocnt = -1;
     a->readsamps = 0;
     a->writesamps = 0;
     a->read_startup = (unsigned int)((double)a->nom_outrate * a->startup_delay);
@@ -173,10 +173,7 @@ void calc_rmatch (RMATCH a)
 
 void decalc_rmatch (RMATCH a)
 {
-    _aligned_free (a->baux);
     _aligned_free (a->cslew);
-    DeleteCriticalSection (&a->cs_var);
-    DeleteCriticalSection (&a->cs_ring);
     destroy_mav (a->propmav);
     destroy_aamav (a->ffmav);
     destroy_varsamp (a->v);
@@ -253,6 +250,12 @@ void reset_rmatch (RMATCH a)
     InterlockedBitTestAndSet (&a->run, 0);
 }
 
+// xrmatchIN() and xrmatchOUT() are a single-producer/single-consumer pair:  the producer owns
+// 'iin' and the consumer owns 'iout', and the fill count 'n_ring' is the only ring state they share.
+// Ring data is written before 'n_ring' is increased and read before it is decreased; the interlocked
+// operations order those accesses.  The control loop runs only on the consumer side, with the input
+// sample counts handed over through 'inbound'.
+
 void control (RMATCH a, int change)
 {
     {
@@ -262,38 +265,39 @@ void control (RMATCH a, int change)
         a->feed_forward = a->ff_alpha * current_ratio + (1.0 - a->ff_alpha) * a->feed_forward;
     }
     {
-        int deviation = a->n_ring - a->rsize / 2;
+        int deviation = InterlockedAnd (&a->n_ring, 0xFFFFFFFF) - a->rsize / 2;
         xmav (a->propmav, deviation, &a->av_deviation);
     }
-    EnterCriticalSection (&a->cs_var);
-    a->var = a->feed_forward - a->pr_gain * a->av_deviation;
-    if (a->var > 1.04) a->var = 1.04;
-    if (a->var < 0.96) a->var = 0.96;
-    LeaveCriticalSection (&a->cs_var);
+    {
+        double var = a->feed_forward - a->pr_gain * a->av_deviation;
+        if (var > 1.04) var = 1.04;
+        if (var < 0.96) var = 0.96;
+        a->var = var;
+    }
 }
 
-void blend (RMATCH a)
+void upslew (double* buff, int n, double* cslew, int ntslew, int* cnt)
 {
-    int i, j;
-    for (i = 0, j = a->iout; i <= a->ntslew; i++, j = (j + 1) % a->rsize)
+    int i = 0;
+    while (*cnt >= 0 && i < n)
     {
-        a->ring[2 * j + 0] = a->cslew[i] * a->ring[2 * j + 0] + (1.0 - a->cslew[i]) * a->baux[2 * i + 0];
-        a->ring[2 * j + 1] = a->cslew[i] * a->ring[2 * j + 1] + (1.0 - a->cslew[i]) * a->baux[2 * i + 1];
+        buff[2 * i + 0] *= cslew[ntslew - *cnt];
+        buff[2 * i + 1] *= cslew[ntslew - *cnt];
+        (*cnt)--;
+        i++;
     }
 }
 
-void upslew (RMATCH a, int newsamps)
+void downslew (double* buff, int n, double* cslew, int ntslew)
 {
+    // fade the last 'ntslew + 1' samples of 'buff' to zero
     int i, j;
-    i = 0;
-    j = a->iin;
-    while (a->ucnt >= 0 && i < newsamps)
+    i = n > ntslew + 1 ? n - (ntslew + 1) : 0;
+    j = n > ntslew + 1 ? ntslew : n - 1;
+    for (; i < n; i++, j--)
     {
-        a->ring[2 * j + 0] *= a->cslew[a->ntslew - a->ucnt];
-        a->ring[2 * j + 1] *= a->cslew[a->ntslew - a->ucnt];
-        a->ucnt--;
-        i++;
-        j = (j + 1) % a->rsize;
+        buff[2 * i + 0] *= cslew[j];
+        buff[2 * i + 1] *= cslew[j];
     }
 }
 
@@ -303,37 +307,23 @@ void xrmatchIN (void* b, double* in)
     RMATCH a = (RMATCH)b;
     if (InterlockedAnd (&a->run, 1))
     {
-        int newsamps, first, second, ovfl;
+        int newsamps, space, first, second;
         double var;
         a->v->in = a->in = in;
-        EnterCriticalSection (&a->cs_var);
         if (!a->force)
             var = a->var;
         else
             var = a->fvar;
-        LeaveCriticalSection (&a->cs_var);
         newsamps = xvarsamp (a->v, var);
-        EnterCriticalSection (&a->cs_ring);
-        a->n_ring += newsamps;
-        if ((ovfl = a->n_ring - a->rsize) > 0)
+        if (a->ocnt >= 0) upslew (a->resout, newsamps, a->cslew, a->ntslew, &a->ocnt);
+        space = a->rsize - InterlockedAnd (&a->n_ring, 0xFFFFFFFF);
+        if (newsamps > space)
         {
+            // the consumer has fallen behind; keep what fits, fade it out, and fade in the next block
             InterlockedIncrement (&a->overflows);
-            // a->n_ring = a->rsize / 2;
-            a->n_ring = a->rsize; //
-            if ((a->ntslew + 1) > (a->rsize - a->iout))
-            {
-                first = a->rsize - a->iout;
-                second = (a->ntslew + 1) - first;
-            }
-            else
-            {
-                first = a->ntslew + 1;
-                second = 0;
-            }
-            memcpy (a->baux, a->ring + 2 * a->iout, first * sizeof (complex));
-            memcpy (a->baux + 2 * first, a->ring, second * sizeof (complex));
-            // a->iout = (a->iout + ovfl + a->rsize / 2) % a->rsize;
-            a->iout = (a->iout + ovfl) % a->rsize; //
+            newsamps = space;
+            downslew (a->resout, newsamps, a->cslew, a->ntslew);
+            a->ocnt = a->ntslew;
         }
         if (newsamps > (a->rsize - a->iin))
         {
@@ -347,81 +337,44 @@ void xrmatchIN (void* b, double* in)
         }
         memcpy (a->ring + 2 * a->iin, a->resout, first * sizeof (complex));
         memcpy (a->ring, a->resout + 2 * first, second * sizeof (complex));
-        if (a->ucnt >= 0) upslew(a, newsamps);
         a->iin = (a->iin + newsamps) % a->rsize;
-        if (ovfl > 0) blend (a);
-        if (!a->control_flag)
-        {
-            a->writesamps += a->insize;
-            if ((a->readsamps >= a->read_startup) && (a->writesamps >= a->write_startup))
-                a->control_flag = 1;
-        }
-        if (a->control_flag) control (a, a->insize);
-        LeaveCriticalSection (&a->cs_ring);
+        InterlockedExchangeAdd (&a->n_ring, newsamps);
+        InterlockedExchangeAdd (&a->inbound, a->insize);
     }
 }
 
-void dslew (RMATCH a)
+void dslew (RMATCH a, int n)
 {
-    int i, j, k, n;
-    int zeros, first, second;
-    if (a->n_ring > a->ntslew + 1)
+    // 'n' (< outsize) samples are in the output buffer; fade them out, continuing the fade
+    // from the last sample if there are too few, and zero-fill the remainder
+    int i, j;
+    if (n > 0)
     {
-        i = (a->iout + (a->n_ring - (a->ntslew + 1))) % a->rsize;
+        a->dlast[0] = a->out[2 * (n - 1) + 0];
+        a->dlast[1] = a->out[2 * (n - 1) + 1];
+    }
+    if (n > a->ntslew + 1)
+    {
+        i = n - (a->ntslew + 1);
         j = a->ntslew;
-        k = a->ntslew + 1;
-        n = a->n_ring - (a->ntslew + 1);
     }
     else
     {
-        i = a->iout;
+        i = 0;
         j = a->ntslew;
-        k = a->n_ring;
-        n = 0;
     }
-    while (k > 0 && j >= 0)
+    for (; i < n; i++, j--)
     {
-        if (k == 1)
-        {
-            a->dlast[0] = a->ring[2 * i + 0];
-            a->dlast[1] = a->ring[2 * i + 1];
-        }
-        a->ring[2 * i + 0] *= a->cslew[j];
-        a->ring[2 * i + 1] *= a->cslew[j];
-        i = (i + 1) % a->rsize;
-        j--;
-        k--;
-        n++;
+        a->out[2 * i + 0] *= a->cslew[j];
+        a->out[2 * i + 1] *= a->cslew[j];
     }
-    while (j >= 0)
+    for (; j >= 0 && i < a->outsize; i++, j--)
     {
-        a->ring[2 * i + 0] = a->dlast[0] * a->cslew[j];
-        a->ring[2 * i + 1] = a->dlast[1] * a->cslew[j];
-        i = (i + 1) % a->rsize;
-        j--;
-        n++;
+        a->out[2 * i + 0] = a->dlast[0] * a->cslew[j];
+        a->out[2 * i + 1] = a->dlast[1] * a->cslew[j];
     }
-    // zeros = a->outsize + a->rsize / 2 - n;
-    if ((zeros = a->outsize - n) > 0) //
-    { //
-        if (zeros > a->rsize - i)
-        {
-            first = a->rsize - i;
-            second = zeros - first;
-        }
-        else
-        {
-            first = zeros;
-            second = 0;
-        }
-        memset (a->ring + 2 * i, 0, first  * sizeof (complex));
-        memset (a->ring,         0, second * sizeof (complex));
-        n += zeros; //
-    } //
-    // a->n_ring = a->outsize + a->rsize / 2;
-    a->n_ring = n; //
-    // a->iin = (a->iout + a->outsize + a->rsize/2) % a->rsize;
-    a->iin = (a->iout + a->n_ring) % a->rsize; //
+    if (i < a->outsize)
+        memset (a->out + 2 * i, 0, (a->outsize - i) * sizeof (complex));
 }
 
 PORT
@@ -430,39 +383,50 @@ void xrmatchOUT (void* b, double* out)
     RMATCH a = (RMATCH)b;
     if (InterlockedAnd (&a->run, 1))
     {
-        int first, second;
+        int n, first, second, underflow, inbound;
         a->out = out;
-        EnterCriticalSection (&a->cs_ring);
-        if (a->n_ring < a->outsize)
-        {
-            dslew (a);
-            a->ucnt = a->ntslew;
-            InterlockedIncrement (&a->underflows);
-        }
-        if (a->outsize > (a->rsize - a->iout))
+        n = InterlockedAnd (&a->n_ring, 0xFFFFFFFF);
+        if ((underflow = (n < a->outsize)) == 0)
+            n = a->outsize;
+        if (n > (a->rsize - a->iout))
         {
             first = a->rsize - a->iout;
-            second = a->outsize - first;
+            second = n - first;
         }
         else
         {
-            first = a->outsize;
+            first = n;
             second = 0;
         }
         memcpy (a->out, a->ring + 2 * a->iout, first * sizeof (complex));
         memcpy (a->out + 2 * first, a->ring, second * sizeof (complex));
-        a->iout = (a->iout + a->outsize) % a->rsize;
-        a->n_ring -= a->outsize;
-        a->dlast[0] = a->out[2 * (a->outsize - 1) + 0];
-        a->dlast[1] = a->out[2 * (a->outsize - 1) + 1];
+        a->iout = (a->iout + n) % a->rsize;
+        InterlockedExchangeAdd (&a->n_ring, -n);
+        if (a->ucnt >= 0) upslew (a->out, n, a->cslew, a->ntslew, &a->ucnt);
+        if (underflow)
+        {
+            dslew (a, n);
+            a->ucnt = a->ntslew;
+            InterlockedIncrement (&a->underflows);
+        }
+        else
+        {
+            a->dlast[0] = a->out[2 * (a->outsize - 1) + 0];
+            a->dlast[1] = a->out[2 * (a->outsize - 1) + 1];
+        }
+        inbound = InterlockedExchange (&a->inbound, 0);
         if (!a->control_flag)
         {
+            a->writesamps += inbound;
             a->readsamps += a->outsize;
             if ((a->readsamps >= a->read_startup) && (a->writesamps >= a->write_startup))
                 a->control_flag = 1;
         }
-        if (a->control_flag) control (a, -(a->outsize));
-        LeaveCriticalSection (&a->cs_ring);
+        if (a->control_flag)
+        {
+            if (inbound > 0) control (a, inbound);
+            control (a, -(a->outsize));
+        }
     }
 }
 
@@ -472,11 +436,9 @@ void getRMatchDiags (void* b, int* underflows, int* overflows, double* var, int*
     RMATCH a = (RMATCH)b;
     *underflows = InterlockedAnd (&a->underflows, 0xFFFFFFFF);
     *overflows  = InterlockedAnd (&a->overflows,  0xFFFFFFFF);
-    EnterCriticalSection (&a->cs_var);
     *var = a->var;
     *ringsize = a->ringsize;
-    *nring = a->n_ring;
-    LeaveCriticalSection (&a->cs_var);
+    *nring = InterlockedAnd (&a->n_ring, 0xFFFFFFFF);
 }
 
 PORT
@@ -491,10 +453,8 @@ PORT
 void forceRMatchVar (void* b, int force, double fvar)
 {
     RMATCH a = (RMATCH)b;
-    EnterCriticalSection (&a->cs_var);
-    a->force = force;
     a->fvar = fvar;
-    LeaveCriticalSection (&a->cs_var);
+    a->force = force;
 }
 
 PORT
@@ -597,10 +557,8 @@ PORT
 void setRMatchFeedbackGain (void* b, double feedback_gain)
 {
     RMATCH a = (RMATCH)b;
-    EnterCriticalSection(&a->cs_var);
     a->prop_gain = feedback_gain;
     a->pr_gain = a->prop_gain * 48000.0 / (double)a->nom_outrate;
-    LeaveCriticalSection(&a->cs_var);
 }
 
 PORT
@@ -700,9 +658,7 @@ PORT
 void getControlFlag(void* ptr, int* control_flag)
 {
     RMATCH a = (RMATCH)ptr;
-    EnterCriticalSection(&a->cs_ring);
     *control_flag = a->control_flag;
-    LeaveCriticalSection(&a->cs_ring);
 }
 
 // the following function is DEPRECATED
@@ -74,9 +74,10 @@ typedef struct _rmatch
     int ringsize;
     int rsize;
     double* ring;
-    int n_ring;
-    int iin;
-    int iout;
+    volatile long n_ring;   // samples in the ring; the only index shared by both sides
+    int iin;                // owned by xrmatchIN()
+    int iout;               // owned by xrmatchOUT()
+    volatile long inbound;  // input samples not yet seen by control()
     double var;
     int R;
     AAMAV ffmav;
@@ -92,15 +93,13 @@ typedef struct _rmatch
     double av_deviation;
     VARSAMP v;
     int varmode;
-    CRITICAL_SECTION cs_ring;
-    CRITICAL_SECTION cs_var;
-    // blend / slew
+    // slew
     double tslew;
     int ntslew;
     double* cslew;
-    double* baux;
     double dlast[2];
-    int ucnt;
+    int ucnt;               // output up-slew count after an underflow, owned by xrmatchOUT()
+    int ocnt;               // input up-slew count after an overflow, owned by xrmatchIN()
     // variables to check start-up time for control to become active
     unsigned int readsamps;
     unsigned int writesamps;
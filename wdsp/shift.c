@@ -125,3 +125,35 @@ void SetRXAShiftFreq (int channel, double fshift)
     calc_shift (rxa[channel].shift.p);
     LeaveCriticalSection (&ch[channel].csDSP);
 }
+
+// exported calls, a stand-alone frequency shifter
+
+PORT
+void* create_shiftV (int rate, double fshift)
+{
+    return (void *)create_shift (1, 0, 0, 0, rate, fshift);
+}
+
+PORT
+void xshiftV (double* input, double* output, int numsamps, void* ptr)
+{
+    SHIFT a = (SHIFT)ptr;
+    a->in = input;
+    a->out = output;
+    a->size = numsamps;
+    xshift (a);
+}
+
+PORT
+void SetShiftFreqV (void* ptr, double fshift)
+{
+    SHIFT a = (SHIFT)ptr;
+    a->shift = fshift;
+    calc_shift (a);
+}
+
+PORT
+void destroy_shiftV (void* ptr)
+{
+    destroy_shift ((SHIFT)ptr);
+}
@@ -61,4 +61,14 @@ extern __declspec (dllexport) void SetRXAShiftRun (int channel, int run);
 
 extern __declspec (dllexport) void SetRXAShiftFreq (int channel, double fshift);
 
+// Stand-alone
+
+extern __declspec (dllexport) void* create_shiftV (int rate, double fshift);
+
+extern __declspec (dllexport) void xshiftV (double* input, double* output, int numsamps, void* ptr);
+
+extern __declspec (dllexport) void SetShiftFreqV (void* ptr, double fshift);
+
+extern __declspec (dllexport) void destroy_shiftV (void* ptr);
+
 #endif
@@ -16,6 +16,7 @@ extern "C" {
 #define DETECTOR_MODE_AVERAGE      2
 #define DETECTOR_MODE_SAMPLE       3
 #define DETECTOR_MODE_RMS          4
+#define DETECTOR_MODE_MIN          5
 
 #define AVERAGE_PEAK_HOLD         -1
 #define AVERAGE_MODE_NONE          0
@@ -168,6 +169,12 @@ extern void GetPixels  (   int disp,
                     dOUTREAL *pix,
                     int *flag
                 );
+extern int GetPixelsMulti (    int n,
+                    const int *disp,
+                    const int *pixout,
+                    dOUTREAL **pix,
+                    int *flag
+                );
 extern void SnapSpectrum(  int disp,
                     int ss,
                     int LO,
@@ -248,9 +255,12 @@ extern void pscc (int channel, int size, double* tx, double* rx);
 extern void psccF (int channel, int size, float *Itxbuff, float *Qtxbuff, float *Irxbuff, float *Qrxbuff, int mox, int solidmox);
 extern void PSSaveCorr (int channel, char* filename);
 extern void PSRestoreCorr (int channel, char* filename);
+extern void PSSaveCapture (int channel, char* filename);
+extern int PSBenchCapture (char* filename, int iterations, double* min, double* avg);
 extern void SetPSRunCal (int channel, int run);
 extern void SetPSMox (int channel, int mox);
 extern void GetPSInfo (int channel, int *info);
+extern void GetPSCalcTime (int channel, double* last, double* avg, int* count);
 extern void SetPSReset (int channel, int reset);
 extern void SetPSMancal (int channel, int mancal);
 extern void SetPSAutomode (int channel, int automode);
@@ -742,6 +752,15 @@ extern void SetTXAPanelRun (int channel, int run);
 extern void SetTXAPanelGain1 (int channel, double gain);
 extern void SetTXAPanelSelect (int channel, int select);
 
+//
+// Interfaces from profile.c
+//
+
+extern void SetChannelProfileRun (int channel, int run);
+extern void ResetChannelProfile (int channel);
+extern int GetChannelProfileStages (int channel);
+extern int GetChannelProfileStage (int channel, int stage, char* name, int size, double* min, double* avg, double* p99);
+
 //
 // Interfaces from resample.c
 //
@@ -796,6 +815,10 @@ extern void SetRXASpectrum (int channel, int flag, int disp, int ss, int LO);
 
 extern void SetRXAShiftRun (int channel, int run);
 extern void SetRXAShiftFreq (int channel, double fshift);
+extern void* create_shiftV (int rate, double fshift);
+extern void xshiftV (double* input, double* output, int numsamps, void* ptr);
+extern void SetShiftFreqV (void* ptr, double fshift);
+extern void destroy_shiftV (void* ptr);
 
 //
 // Interfaces from siphon.c
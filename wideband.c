@@ -107,7 +107,6 @@ void wideband_restore_state(WIDEBAND *w) {
 
 static gboolean window_delete(GtkWidget *widget,GdkEvent *event, gpointer data) {
   WIDEBAND *w=(WIDEBAND *)data;
-  g_source_remove(w->update_timer_id);
   delete_wideband(w);
   return FALSE;
 }
@@ -151,37 +150,77 @@ gboolean wideband_scroll_event_cb(GtkWidget *widget, GdkEventScroll *event, gpoi
   return TRUE;
 }
 
-static gboolean update_timer_cb(void *data) {
-  int rc;
-  WIDEBAND *w=(WIDEBAND *)data;
+static gboolean wideband_visible(WIDEBAND *w) {
+  if(w->window==NULL || !gtk_widget_get_mapped(w->window)) return FALSE;
+  GdkWindow *window=gtk_widget_get_window(w->window);
+  return window!=NULL && (gdk_window_get_state(window)&GDK_WINDOW_STATE_ICONIFIED)==0;
+}
 
-  if(w->panadapter_resize_timer==-1) {
-    GetPixels(w->channel,0,w->pixel_samples,&rc);
-    if(rc) {
-      update_wideband_panadapter(w);
-      update_wideband_waterfall(w);
-    }
+// Main thread, from the radio's display tick
+void wideband_display_request(WIDEBAND *w,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req) {
+  // the receive thread only feeds the analyzer while there is something to see
+  gboolean visible=wideband_visible(w);
+  g_atomic_int_set(&w->visible,visible);
+  req->first=-1;
+  if(visible && w->panadapter_resize_timer==-1) {
+    req->first=display_pixels_request(p,w->channel,0,w->pixel_samples);
   }
-  return TRUE;
-}
- 
-static void full_wideband_buffer(WIDEBAND *w) {
-  Spectrum0(1, w->channel, 0, 0, w->input_buffer);
+  req->pixels=req->first>=0;
+  req->frame=req->pixels;
 }
 
+void wideband_display_update(WIDEBAND *w,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req) {
+  if(display_pixels_ready(p,req->first)) {
+    update_wideband_panadapter(w);
+    update_wideband_waterfall(w);
+  }
+}
+ 
 void reset_wideband_buffer_index(WIDEBAND *w) {
   if(w!=NULL) {
     w->samples=0;
   }
 }
 
-void add_wideband_sample(WIDEBAND *w,double sample) {
-  w->input_buffer[w->samples*2]=sample;
-  w->input_buffer[(w->samples*2)+1]=0.0;
-  w->samples=w->samples+1;
-  if(w->samples>=w->buffer_size) {
-    full_wideband_buffer(w);
-    w->samples=0;
+//
+// Add n 16 bit ADC samples from a packet, little endian for protocol 1 and
+// big endian for protocol 2. The ADC samples are real, so the analyzer
+// runs a real input FFT of half the work of a complex one. Only one buffer
+// per display frame is passed to the analyzer and none while the window
+// is hidden; the others are counted but not converted so buffers stay
+// aligned with the packet sequence.
+//
+void add_wideband_samples(WIDEBAND *w,const unsigned char *buffer,int n,gboolean big_endian) {
+  int hi=big_endian?0:1;
+  int lo=big_endian?1:0;
+  int i;
+
+  while(n>0) {
+    if(w->samples==0) {
+      gint64 now=g_get_monotonic_time();
+      w->collecting=g_atomic_int_get(&w->visible) && now>=w->next_frame_time;
+      if(w->collecting) {
+        w->next_frame_time=now+(G_USEC_PER_SEC/w->fps);
+      }
+    }
+    int count=w->buffer_size-w->samples;
+    if(count>n) count=n;
+    if(w->collecting) {
+      gfloat *out=w->input_buffer+w->samples;
+      for(i=0;i<count;i++) {
+        gint16 sample=(gint16)((buffer[i*2+hi]<<8)|buffer[i*2+lo]);
+        out[i]=(gfloat)sample*(1.0f/32767.0f);
+      }
+    }
+    buffer+=count*2;
+    n-=count;
+    w->samples+=count;
+    if(w->samples>=w->buffer_size) {
+      if(w->collecting) {
+        Spectrum(w->channel,0,0,w->input_buffer,w->input_buffer);
+      }
+      w->samples=0;
+    }
   }
 }
 
@@ -237,7 +276,7 @@ void wideband_init_analyzer(WIDEBAND *w) {
     double keep_time = 0.1;
     int n_pixout=1;
     int spur_elimination_ffts = 1;
-    int data_type = 1;
+    int data_type = 0;      // ADC samples are real
     int fft_size = w->fft_size;
     int window_type = 4;
     double kaiser_pi = 14.0;
@@ -257,7 +296,7 @@ void wideband_init_analyzer(WIDEBAND *w) {
     w->pixel_samples=NULL;
   }
   if(w->pixels>0) {
-    w->pixel_samples=g_new0(float,w->pixels*2);
+    w->pixel_samples=g_new0(float,w->pixels);
     int max_w = fft_size + (int) min(keep_time * (double) w->fps, keep_time * (double) fft_size * (double) w->fps);
 
     //overlap = (int)max(0.0, ceil(fft_size - (double)w->sample_rate / (double)w->fps));
@@ -275,7 +314,7 @@ void wideband_init_analyzer(WIDEBAND *w) {
             clip, //number of fft output bins to be clipped from EACH side of each sub-span
             span_clip_l, //number of bins to clip from low end of entire span
             span_clip_h, //number of bins to clip from high end of entire span
-            pixels*2, //number of pixel values to return.  may be either <= or > number of bins
+            pixels, //number of pixel values to return.  may be either <= or > number of bins
             stitches, //number of sub-spans to concatenate to form a complete span
             calibration_data_set, //identifier of which set of calibration data to use
             span_min_freq, //frequency at first pixel value8192
@@ -304,7 +343,11 @@ g_print("create_wideband: channel=%d\n",channel);
   w->pixel_samples=NULL;
   w->sequence=0;
   w->buffer_size=16384;
-  w->input_buffer=g_new0(gdouble,w->buffer_size*2);
+  w->input_buffer=g_new0(gfloat,w->buffer_size);
+  w->samples=0;
+  w->collecting=FALSE;
+  w->next_frame_time=0;
+  w->visible=FALSE;
 
   w->fps=10;
 
@@ -359,7 +402,5 @@ g_print("create_wideband: channel=%d\n",channel);
     }
   }
 
-g_print("create_widband: update_timer: %d\n",1000/w->fps);
-  w->update_timer_id=g_timeout_add(1000/w->fps,update_timer_cb,(gpointer)w);
   return w;
 }
@@ -20,6 +20,8 @@
 #ifndef WIDEBAND_H
 #define WIDEBAND_H
 
+#include "display_tick.h"
+
 // Optimization: Cache for static elements (grid, markers)
 typedef struct {
   cairo_surface_t *static_surface;
@@ -29,6 +31,10 @@ typedef struct {
   gdouble hz_per_pixel;
   gint panadapter_high;
   gint panadapter_low;
+  cairo_surface_t *plot_surface;  // filled spectrum, reused every frame
+  guint32 *fill_column;           // fill colour for each row
+  gint *fill_top;                 // first filled row for each column
+  gdouble *y_values;
 } wPanadapterCache;
 
 
@@ -41,12 +47,15 @@ typedef struct _wideband {
   gint fft_size;
 
   guint32 sequence;
-  gdouble *input_buffer;
+  gfloat *input_buffer;       // real samples, one analyzer buffer
   gfloat *pixel_samples;
 
-  gint update_timer_id;
+  gint tick_phase;            // display_tick_due() accumulator
 
   gint samples;
+  gboolean collecting;        // current buffer goes to the analyzer
+  gint64 next_frame_time;
+  gint visible;               // set by the main thread, read by the receive thread
   gint pixels;
   gint fps;
 
@@ -77,10 +86,13 @@ typedef struct _wideband {
   gint waterfall_resize_height;
   guint waterfall_resize_timer;
   GdkPixbuf *waterfall_pixbuf;
+  gint waterfall_head;
 
   gint waterfall_low;
   gint waterfall_high;
   gboolean waterfall_automatic;
+  gint waterfall_palette;
+  void *waterfall_colormap;
   gint64 waterfall_frequency;
   gint waterfall_sample_rate;
   
@@ -97,12 +109,14 @@ typedef struct _wideband {
 
 extern WIDEBAND *create_wideband(int channel);
 extern void wideband_init_analyzer(WIDEBAND *w);
-extern void add_wideband_sample(WIDEBAND *w,double sample);
+extern void add_wideband_samples(WIDEBAND *w,const unsigned char *buffer,int n,gboolean big_endian);
 extern gboolean wideband_button_press_event_cb(GtkWidget *widget, GdkEventButton *event, gpointer data);
 extern gboolean wideband_button_release_event_cb(GtkWidget *widget, GdkEventButton *event, gpointer data);
 extern gboolean wideband_motion_notify_event_cb(GtkWidget *widget, GdkEventMotion *event, gpointer data);
 extern gboolean wideband_scroll_event_cb(GtkWidget *widget, GdkEventScroll *event, gpointer data);
 extern void wideband_save_state(WIDEBAND *w);
 extern void reset_wideband_buffer_index(WIDEBAND *w);
+extern void wideband_display_request(WIDEBAND *w,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
+extern void wideband_display_update(WIDEBAND *w,DISPLAY_PIXELS *p,DISPLAY_REQUEST *req);
 
 #endif
@@ -40,6 +40,7 @@
 #include "vfo.h"
 #include "audio.h"
 #include "main.h"
+#include "colormap.h"
 /*
 static gboolean close_cb (GtkWidget *widget, GdkEventButton *event, gpointer data) {
   WIDEBAND *w=(WIDEBAND *)data;
@@ -80,6 +81,11 @@ static void waterfall_automatic_cb(GtkWidget *widget, gpointer data) {
   w->waterfall_automatic=w->waterfall_automatic==1?0:1;
 }
 
+static void waterfall_palette_cb(GtkWidget *widget, gpointer data) {
+  WIDEBAND *w=(WIDEBAND *)data;
+  w->waterfall_palette=gtk_combo_box_get_active(GTK_COMBO_BOX(widget));
+}
+
 GtkWidget *create_wideband_dialog(WIDEBAND *w) {
   int col=0;
   int row=0;
@@ -151,5 +157,16 @@ GtkWidget *create_wideband_dialog(WIDEBAND *w) {
   gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_automatic,0,2,2,1);
   g_signal_connect(waterfall_automatic,"toggled",G_CALLBACK(waterfall_automatic_cb),w);
 
+  GtkWidget *waterfall_palette_label=gtk_label_new("Palette:");
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_palette_label,0,3,1,1);
+
+  GtkWidget *waterfall_palette=gtk_combo_box_text_new();
+  for(int i=0;i<PALETTE_LAST;i++) {
+    gtk_combo_box_text_append(GTK_COMBO_BOX_TEXT(waterfall_palette),NULL,palette_name[i]);
+  }
+  gtk_combo_box_set_active(GTK_COMBO_BOX(waterfall_palette),w->waterfall_palette);
+  gtk_grid_attach(GTK_GRID(waterfall_grid),waterfall_palette,1,3,1,1);
+  g_signal_connect(waterfall_palette,"changed",G_CALLBACK(waterfall_palette_cb),w);
+
   return grid;
 }
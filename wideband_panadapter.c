@@ -126,6 +126,10 @@ GtkWidget *create_wideband_panadapter(WIDEBAND *w) {
   w->panadapter_height = 0;
   w->panadapter_surface = NULL;
   w->wpanadapter_cache.static_surface = NULL;
+  w->wpanadapter_cache.plot_surface = NULL;
+  w->wpanadapter_cache.fill_column = NULL;
+  w->wpanadapter_cache.fill_top = NULL;
+  w->wpanadapter_cache.y_values = NULL;
   w->wpanadapter_cache.width = 0;
   w->wpanadapter_cache.height = 0;
   w->wpanadapter_cache.pixels = 0;
@@ -239,6 +243,29 @@ void update_wideband_panadapter(WIDEBAND *w) {
     cairo_t *cr_static = cairo_create(px->static_surface);
     draw_static_elements(w, cr_static);
     cairo_destroy(cr_static);
+
+    // the plot surface and the per row fill colours have the same key
+    if (px->plot_surface) {
+      cairo_surface_destroy(px->plot_surface);
+    }
+    px->plot_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, display_width, display_height);
+    g_free(px->fill_column);
+    px->fill_column = g_new(guint32, display_height);
+    for (int y = 0; y < display_height; y++) {
+#ifdef GRADIANT
+      double t = (double)y / (double)display_height;
+      guint32 r = (guint32)(255 * (1.0 - t));
+      guint32 g = (guint32)(255 * (1.0 - t));
+      guint32 b = (guint32)(255 * t);
+      px->fill_column[y] = (128u << 24) | (r << 16) | (g << 8) | b;
+#else
+      px->fill_column[y] = (128u << 24) | (255u << 16) | (255u << 8) | 255u;
+#endif
+    }
+    g_free(px->fill_top);
+    px->fill_top = g_new(gint, display_width);
+    g_free(px->y_values);
+    px->y_values = g_new(gdouble, w->pixels);
   }
 
   // Initialize main surface
@@ -260,49 +287,36 @@ void update_wideband_panadapter(WIDEBAND *w) {
 
   // Signal plot using bulk operation
   double dbm_per_line = (double)display_height / ((double)w->panadapter_high - (double)w->panadapter_low);
-  cairo_surface_t *plot_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, display_width, display_height);
-  unsigned char *plot_data = cairo_image_surface_get_data(plot_surface);
-  int plot_stride = cairo_image_surface_get_stride(plot_surface);
 
   // Optimization: Precompute y-coordinates to reduce Cairo calls
-  double *y_values = g_new(double, w->pixels);
-  samples[w->pixels] = -200.0;
-  samples[(w->pixels * 2) - 1] = -200.0;
-
+  double *y_values = px->y_values;
   for (int i = 0; i < w->pixels; i++) {
-    double s = (double)samples[i + w->pixels];
+    double s = (double)samples[i];
     s = floor((w->panadapter_high - s) * dbm_per_line);
     if (s < 0) s = 0;
     if (s >= display_height) s = display_height - 1;
     y_values[i] = s;
   }
 
-  // Fill signal area
-  for (int x = 0; x < display_width; x++) {
-    int idx = x * w->pixels / display_width; // Linear mapping
-    int y_top = (int)y_values[idx];
-    for (int y = y_top; y < display_height; y++) {
-      unsigned char *pixel = plot_data + y * plot_stride + x * 4;
-#ifdef GRADIANT
-      double t = (double)y / (double)display_height;
-      pixel[2] = (unsigned char)(255 * (1.0 - t)); // R
-      pixel[1] = (unsigned char)(255 * (1.0 - t)); // G
-      pixel[0] = (unsigned char)(255 * t);         // B
-      pixel[3] = (unsigned char)(128);            // A (0.5)
-#else
-      pixel[2] = 255; // R
-      pixel[1] = 255; // G
-      pixel[0] = 255; // B
-      pixel[3] = 128; // A
-#endif
+  // Fill signal area, row by row into the reused surface
+  if (radio->display_filled) {
+    unsigned char *plot_data = cairo_image_surface_get_data(px->plot_surface);
+    int plot_stride = cairo_image_surface_get_stride(px->plot_surface);
+    cairo_surface_flush(px->plot_surface);
+    for (int x = 0; x < display_width; x++) {
+      px->fill_top[x] = (int)y_values[x * w->pixels / display_width]; // Linear mapping
     }
-  }
-
-  cairo_surface_mark_dirty(plot_surface);
+    for (int y = 0; y < display_height; y++) {
+      guint32 *row = (guint32 *)(plot_data + y * plot_stride);
+      guint32 fill = px->fill_column[y];
+      for (int x = 0; x < display_width; x++) {
+        row[x] = y >= px->fill_top[x] ? fill : 0;
+      }
+    }
+    cairo_surface_mark_dirty(px->plot_surface);
 
-  // Composite signal plot
-  if (radio->display_filled) {
-    cairo_set_source_surface(cr, plot_surface, 0, 0);
+    // Composite signal plot
+    cairo_set_source_surface(cr, px->plot_surface, 0, 0);
     cairo_paint(cr);
   }
 
@@ -314,8 +328,6 @@ void update_wideband_panadapter(WIDEBAND *w) {
   }
   cairo_stroke(cr);
 
-  g_free(y_values);
-  cairo_surface_destroy(plot_surface);
   cairo_destroy(cr);
   gtk_widget_queue_draw(w->panadapter);
 }
\ No newline at end of file
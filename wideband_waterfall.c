@@ -21,64 +21,11 @@
 
 #include "wideband.h"
 #include "wideband_waterfall.h"
+#include "waterfall_ring.h"
+#include "colormap.h"
 
 #define MAX_WIDTH 2048  // Optimization: Cap width to limit memory
 #define MAX_HEIGHT 1024 // Optimization: Cap height for large displays
-#define COLOR_STEPS 256 // Optimization: Precompute color table
-
-static const int colorLowR = 0;   // Black
-static const int colorLowG = 0;
-static const int colorLowB = 0;
-
-static const int colorHighR = 255; // Yellow
-static const int colorHighG = 255;
-static const int colorHighB = 0;
-
-// Optimization: Precomputed color table
-static guchar color_table[COLOR_STEPS][3];
-
-static void init_color_table() {
-  // Initialize once at startup
-  for (int i = 0; i < COLOR_STEPS; i++) {
-    float percent = (float)i / (COLOR_STEPS - 1);
-    if (percent < (2.0f / 9.0f)) {
-      float local_percent = percent / (2.0f / 9.0f);
-      color_table[i][0] = (guchar)((1.0f - local_percent) * colorLowR);
-      color_table[i][1] = (guchar)((1.0f - local_percent) * colorLowG);
-      color_table[i][2] = (guchar)(colorLowB + local_percent * (255 - colorLowB));
-    } else if (percent < (3.0f / 9.0f)) {
-      float local_percent = (percent - 2.0f / 9.0f) / (1.0f / 9.0f);
-      color_table[i][0] = 0;
-      color_table[i][1] = (guchar)(local_percent * 255);
-      color_table[i][2] = 255;
-    } else if (percent < (4.0f / 9.0f)) {
-      float local_percent = (percent - 3.0f / 9.0f) / (1.0f / 9.0f);
-      color_table[i][0] = 0;
-      color_table[i][1] = 255;
-      color_table[i][2] = (guchar)((1.0f - local_percent) * 255);
-    } else if (percent < (5.0f / 9.0f)) {
-      float local_percent = (percent - 4.0f / 9.0f) / (1.0f / 9.0f);
-      color_table[i][0] = (guchar)(local_percent * 255);
-      color_table[i][1] = 255;
-      color_table[i][2] = 0;
-    } else if (percent < (7.0f / 9.0f)) {
-      float local_percent = (percent - 5.0f / 9.0f) / (2.0f / 9.0f);
-      color_table[i][0] = 255;
-      color_table[i][1] = (guchar)((1.0f - local_percent) * 255);
-      color_table[i][2] = 0;
-    } else if (percent < (8.0f / 9.0f)) {
-      float local_percent = (percent - 7.0f / 9.0f) / (1.0f / 9.0f);
-      color_table[i][0] = 255;
-      color_table[i][1] = 0;
-      color_table[i][2] = (guchar)(local_percent * 255);
-    } else {
-      float local_percent = (percent - 8.0f / 9.0f) / (1.0f / 9.0f);
-      color_table[i][0] = (guchar)((0.75f + 0.25f * (1.0f - local_percent)) * 255.0f);
-      color_table[i][1] = (guchar)(local_percent * 255.0f * 0.5f);
-      color_table[i][2] = 255;
-    }
-  }
-}
 
 static gboolean resize_timeout(void *data) {
   WIDEBAND *w = (WIDEBAND *)data;
@@ -95,8 +42,9 @@ static gboolean resize_timeout(void *data) {
   if (w->waterfall != NULL) {
     w->waterfall_pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, w->waterfall_width, w->waterfall_height);
     guchar *pixels = gdk_pixbuf_get_pixels(w->waterfall_pixbuf);
-    memset(pixels, 0, w->waterfall_width * w->waterfall_height * 3);
+    memset(pixels, 0, w->waterfall_height * gdk_pixbuf_get_rowstride(w->waterfall_pixbuf));
   }
+  w->waterfall_head = 0;
   w->waterfall_frequency = 0;
   w->waterfall_sample_rate = 0;
   w->waterfall_resize_timer = -1;
@@ -121,27 +69,19 @@ static gboolean waterfall_configure_event_cb(GtkWidget *widget, GdkEventConfigur
 static gboolean waterfall_draw_cb(GtkWidget *widget, cairo_t *cr, gpointer data) {
   WIDEBAND *w = (WIDEBAND *)data;
   if (w->waterfall_pixbuf) {
-    gdk_cairo_set_source_pixbuf(cr, w->waterfall_pixbuf, 0, 0);
-    cairo_paint(cr);
+    waterfall_ring_draw(cr, w->waterfall_pixbuf, w->waterfall_head);
   }
   return FALSE;
 }
 
 GtkWidget *create_wideband_waterfall(WIDEBAND *w) {
-  static gboolean color_table_initialized = FALSE;
-
-  // Optimization: Initialize color table once
-  if (!color_table_initialized) {
-    init_color_table();
-    color_table_initialized = TRUE;
-  }
-
   GtkWidget *waterfall;
 
   w->waterfall_width = 0;
   w->waterfall_height = 0;
   w->waterfall_resize_timer = -1;
   w->waterfall_pixbuf = NULL;
+  w->waterfall_head = 0;
 
   waterfall = gtk_drawing_area_new();
 
@@ -159,52 +99,37 @@ void update_wideband_waterfall(WIDEBAND *w) {
     return; // Optimization: Early exit for invalid state
   }
 
-  guchar *pixels = gdk_pixbuf_get_pixels(w->waterfall_pixbuf);
   int width = gdk_pixbuf_get_width(w->waterfall_pixbuf);
-  int height = gdk_pixbuf_get_height(w->waterfall_pixbuf);
-  int rowstride = gdk_pixbuf_get_rowstride(w->waterfall_pixbuf);
+  int n = w->pixels < width ? w->pixels : width; // Rows are no longer contiguous scratch space
 
-  // Optimization: Scroll pixbuf efficiently
-  memmove(pixels + rowstride, pixels, (height - 1) * rowstride);
+  // Optimization: Ring of rows, only the newest row is written
+  gint head;
+  guchar *row = waterfall_ring_next_row(w->waterfall_pixbuf, w->waterfall_head, &head);
 
   float *samples = w->pixel_samples;
-  guchar *p = pixels;
-  int average = 0;
+  float average = 0.0f;
   int count = 0;
 
-  // Optimization: Bulk pixel updates with color table
-  for (int i = 0; i < w->pixels; i++) {
-    float sample = samples[i + w->pixels];
-    if (i > 0 && i < w->pixels - 1) {
-      average += (int)sample;
-      count++;
-    }
+  for (int i = 1; i < n - 1; i++) {
+    average += samples[i];
+    count++;
+  }
 
-    if (sample < (float)w->waterfall_low) {
-      p[0] = colorLowR;
-      p[1] = colorLowG;
-      p[2] = colorLowB;
-    } else if (sample > (float)w->waterfall_high) {
-      p[0] = colorHighR;
-      p[1] = colorHighG;
-      p[2] = colorHighB;
-    } else {
-      float range = (float)w->waterfall_high - (float)w->waterfall_low;
-      float offset = sample - (float)w->waterfall_low;
-      int index = (int)((offset / range) * (COLOR_STEPS - 1));
-      if (index < 0) index = 0;
-      if (index >= COLOR_STEPS) index = COLOR_STEPS - 1;
-      p[0] = color_table[index][0];
-      p[1] = color_table[index][1];
-      p[2] = color_table[index][2];
-    }
-    p += 3;
+  // Optimization: Palette table is only rebuilt when the levels or palette change
+  if (w->waterfall_colormap == NULL) {
+    w->waterfall_colormap = create_colormap(w->waterfall_palette, w->waterfall_low, w->waterfall_high);
   }
+  COLORMAP *map = (COLORMAP *)w->waterfall_colormap;
+  if (map->palette != w->waterfall_palette || map->low != w->waterfall_low || map->high != w->waterfall_high) {
+    colormap_update(map, w->waterfall_palette, w->waterfall_low, w->waterfall_high);
+  }
+  colormap_row(map, samples, 0.0f, row, n);
+  waterfall_ring_publish(&w->waterfall_head, head);
 
   if (w->waterfall_automatic && count > 0) {
-    w->waterfall_low = average / count;
+    w->waterfall_low = (int)(average / count);
     w->waterfall_high = w->waterfall_low + 50;
   }
 
   gtk_widget_queue_draw(w->waterfall);
-}
\ No newline at end of file
+}